@@ -77,6 +77,17 @@ void CAmpMeter::write(float *databuf, unsigned long databufsize) {
 	return write(_getValueFromBuffer(databuf, databufsize));
 }
 
+void CAmpMeter::write(CAudioBlock &block) {
+	// the planes are contiguous, the peak of each channel is one linear scan
+	float maxVal = 0., tmpVal;
+	for (int c = 0; c < block.getNumChannels(); c++) {
+		tmpVal = _getValueFromBuffer(block.getChannel(c), block.getNumFrames());
+		if (maxVal < tmpVal)
+			maxVal = tmpVal;
+	}
+	return write(maxVal);
+}
+
 void CAmpMeter::write(float data) {
 	if (NULL == m_IoDev)
 		throw CException(this, typeid(this).name(), __FUNCTION__, AMP_E_NOVISUALIZER,
@@ -9,6 +9,8 @@
 #ifndef CAMPMETER_H_
 #define CAMPMETER_H_
 
+#include "CAudioBlock.h"
+
 class CPlayerCVDevice;
 class CAmpMeter {
 public:
@@ -116,6 +118,12 @@ public:
 	 */
 	void write(float *databuf, unsigned long databufsize);
 
+	/**
+	 * \brief Visualizes the amplitude of a planar block (all channels) on the connected IODevice as a bar pattern
+	 * \param block [in] block of samples, the valid frames are evaluated
+	 */
+	void write(CAudioBlock &block);
+
 	/**
 	 * \brief Visualizes the amplitude of one single data value on the connected IODevice as a bar pattern
 	 * \param data [in] The data value.
@@ -0,0 +1,115 @@
+/**
+ * \file CAudioBlock.cpp
+ * \brief implementation CAudioBlock
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <string.h>
+#include <SKSLib.h>
+#include "CSimd.h"
+#include "CAudioBlock.h"
+
+CAudioBlock::CAudioBlock(uint16_t channels, uint16_t maxFrames,
+		uint32_t sampleRate) {
+	if ((channels == 0) || (maxFrames == 0))
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Block channels and frames must not be zero!");
+	m_channels = channels;
+	m_maxFrames = maxFrames;
+	m_frames = maxFrames;
+	m_sampleRate = sampleRate;
+	// each plane starts at the alignment of the vector kernels
+	m_stride = CSimd::roundUp(maxFrames, CSimd::ALIGNMENT / sizeof(float));
+	m_data = CSimd::allocAligned(m_channels * m_stride);
+	m_owner = true;
+}
+
+CAudioBlock::CAudioBlock(CAudioBlock &block, uint16_t firstFrame,
+		uint16_t frames) {
+	if (firstFrame > block.m_maxFrames)
+		firstFrame = block.m_maxFrames;
+	if (frames > block.m_maxFrames - firstFrame)
+		frames = block.m_maxFrames - firstFrame;
+	m_data = block.m_data + firstFrame;
+	m_owner = false;
+	m_stride = block.m_stride;
+	m_channels = block.m_channels;
+	m_frames = m_maxFrames = frames;
+	m_sampleRate = block.m_sampleRate;
+}
+
+CAudioBlock::CAudioBlock(float *data, uint16_t channels, uint16_t frames,
+		uint32_t stride, uint32_t sampleRate) {
+	m_data = data;
+	m_owner = false;
+	m_stride = stride;
+	m_channels = channels;
+	m_frames = m_maxFrames = frames;
+	m_sampleRate = sampleRate;
+}
+
+CAudioBlock::~CAudioBlock() {
+	if (m_owner)
+		CSimd::freeAligned(m_data);
+}
+
+void CAudioBlock::setSampleRate(uint32_t sampleRate) {
+	m_sampleRate = sampleRate;
+}
+
+void CAudioBlock::setNumFrames(uint16_t frames) {
+	m_frames = (frames < m_maxFrames) ? frames : m_maxFrames;
+}
+
+void CAudioBlock::clear() {
+	for (int c = 0; c < m_channels; c++)
+		memset(getChannel(c), 0, m_maxFrames * sizeof(float));
+}
+
+bool CAudioBlock::copy(CAudioBlock &block) {
+	if ((block.m_channels != m_channels) || (block.m_frames > m_maxFrames))
+		return false;
+	m_frames = block.m_frames;
+	if (block.m_data != m_data)
+		for (int c = 0; c < m_channels; c++)
+			memmove(getChannel(c), block.getChannel(c), m_frames * sizeof(float));
+	return true;
+}
+
+void CAudioBlock::deinterleave(const float *buf, uint16_t frames) {
+	setNumFrames(frames);
+	if (m_channels == 2) {
+		// stereo: both planes in one pass over the buffer
+		float *left = getChannel(0), *right = getChannel(1);
+		for (int k = 0; k < m_frames; k++) {
+			left[k] = buf[2 * k];
+			right[k] = buf[2 * k + 1];
+		}
+		return;
+	}
+	// one plane after the other: contiguous stores, strided loads
+	for (int c = 0; c < m_channels; c++) {
+		float *plane = getChannel(c);
+		const float *x = buf + c;
+		for (int k = 0; k < m_frames; k++)
+			plane[k] = x[k * m_channels];
+	}
+}
+
+void CAudioBlock::interleave(float *buf) {
+	if (m_channels == 2) {
+		const float *left = getChannel(0), *right = getChannel(1);
+		for (int k = 0; k < m_frames; k++) {
+			buf[2 * k] = left[k];
+			buf[2 * k + 1] = right[k];
+		}
+		return;
+	}
+	for (int c = 0; c < m_channels; c++) {
+		const float *plane = getChannel(c);
+		float *y = buf + c;
+		for (int k = 0; k < m_frames; k++)
+			y[k * m_channels] = plane[k];
+	}
+}
@@ -0,0 +1,175 @@
+/**
+ * \file CAudioBlock.h
+ * \brief interface CAudioBlock
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CAUDIOBLOCK_H_
+#define CAUDIOBLOCK_H_
+
+#include <stdint.h>
+
+/**
+ * \brief block of audio samples in planar layout (structure of arrays)
+ *
+ * The samples of each channel are stored contiguously (one plane per
+ * channel), the planes are aligned to CSimd::ALIGNMENT. Inner loops over the
+ * samples of a channel are therefore contiguous and can be vectorized.
+ *
+ * Interleaved buffers are converted at the edges only: sound files
+ * (CFileSound) and audio output (CSimpleAudioOutStream).
+ *
+ * A block either owns its planes or is a view of the planes of another block
+ * (e.g. a range of frames). Views do not allocate and may be created on the
+ * audio thread.
+ */
+class CAudioBlock {
+private:
+	/**
+	 * \brief first sample of channel 0, plane c starts at m_data + c * m_stride
+	 */
+	float *m_data;
+	/**
+	 * \brief true if m_data has been allocated by the block
+	 */
+	bool m_owner;
+	/**
+	 * \brief distance of the planes (elements)
+	 */
+	uint32_t m_stride;
+	/**
+	 * \brief number of channels
+	 */
+	uint16_t m_channels;
+	/**
+	 * \brief number of valid frames
+	 */
+	uint16_t m_frames;
+	/**
+	 * \brief capacity of each plane (frames)
+	 */
+	uint16_t m_maxFrames;
+	/**
+	 * \brief sampling rate of the signal (0: unknown)
+	 */
+	uint32_t m_sampleRate;
+
+public:
+	/**
+	 * \brief Constructor, allocates zeroed planes
+	 *
+	 * throws exception if channels or maxFrames are zero
+	 *
+	 * \param channels number of channels
+	 * \param maxFrames capacity of each plane (frames)
+	 * \param sampleRate sampling rate of the signal (0: unknown)
+	 */
+	CAudioBlock(uint16_t channels, uint16_t maxFrames, uint32_t sampleRate = 0);
+	/**
+	 * \brief Constructor of a view of frames of another block
+	 *
+	 * the view has the channels, the sampling rate and the plane distance of
+	 * the block, the block must exist as long as the view is used
+	 *
+	 * \param block block providing the planes
+	 * \param firstFrame first frame of the view
+	 * \param frames number of frames (capacity and valid frames)
+	 */
+	CAudioBlock(CAudioBlock &block, uint16_t firstFrame, uint16_t frames);
+	/**
+	 * \brief Constructor of a view of external planes (no allocation)
+	 *
+	 * \param data first sample of channel 0 (the storage must exist as long as the view)
+	 * \param channels number of channels
+	 * \param frames number of frames (capacity and valid frames)
+	 * \param stride distance of the planes (elements)
+	 * \param sampleRate sampling rate of the signal (0: unknown)
+	 */
+	CAudioBlock(float *data, uint16_t channels, uint16_t frames,
+			uint32_t stride, uint32_t sampleRate = 0);
+	/**
+	 * \brief Destructor, releases owned planes
+	 */
+	~CAudioBlock();
+
+	CAudioBlock(const CAudioBlock&) = delete;
+	CAudioBlock& operator=(const CAudioBlock&) = delete;
+
+	/**
+	 * \brief gets the samples of a channel
+	 * \param channel index of the channel
+	 * \return first sample of the plane
+	 */
+	float* getChannel(uint16_t channel) {
+		return m_data + channel * m_stride;
+	}
+	/**
+	 * \brief gets the number of channels
+	 * \return number of channels
+	 */
+	uint16_t getNumChannels() {
+		return m_channels;
+	}
+	/**
+	 * \brief gets the number of valid frames
+	 * \return number of frames
+	 */
+	uint16_t getNumFrames() {
+		return m_frames;
+	}
+	/**
+	 * \brief gets the capacity of the planes
+	 * \return maximum number of frames
+	 */
+	uint16_t getMaxFrames() {
+		return m_maxFrames;
+	}
+	/**
+	 * \brief gets the distance of the planes
+	 * \return number of elements between the first samples of two channels
+	 */
+	uint32_t getStride() {
+		return m_stride;
+	}
+	/**
+	 * \brief gets the sampling rate
+	 * \return sampling rate in Hz (0: unknown)
+	 */
+	uint32_t getSampleRate() {
+		return m_sampleRate;
+	}
+	/**
+	 * \brief sets the sampling rate
+	 * \param sampleRate sampling rate in Hz
+	 */
+	void setSampleRate(uint32_t sampleRate);
+	/**
+	 * \brief sets the number of valid frames
+	 * \param frames number of frames (limited to the capacity)
+	 */
+	void setNumFrames(uint16_t frames);
+	/**
+	 * \brief sets all samples of the planes to zero (the number of frames is not changed)
+	 */
+	void clear();
+	/**
+	 * \brief copies the frames of another block with the same number of channels
+	 * \param block source block
+	 * \return false if the number of channels or the capacity does not fit
+	 */
+	bool copy(CAudioBlock &block);
+	/**
+	 * \brief splits an interleaved buffer into the planes
+	 * \param buf interleaved samples (frames * channels)
+	 * \param frames number of frames (limited to the capacity), becomes the number of valid frames
+	 */
+	void deinterleave(const float *buf, uint16_t frames);
+	/**
+	 * \brief merges the valid frames of the planes into an interleaved buffer
+	 * \param buf interleaved samples (getNumFrames() * channels)
+	 */
+	void interleave(float *buf);
+};
+
+#endif /* CAUDIOBLOCK_H_ */
@@ -12,6 +12,8 @@
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <dirent.h>			// functions to scan files in folders (used in Lab04prep_DBAdminInsert)
 using namespace std;
 
@@ -20,18 +22,38 @@ using namespace std;
 #include "CAudioPlayerController.h"
 #include "CFileFilter.h"
 #include "CFilter.h"
+#include "CFilterSOS.h"
+#include "CFilterFFT.h"
+#include "CFilterSparse.h"
 #include "CFilterDelay.h"
+#include "CFilterSlot.h"
+#include "CFilterChain.h"
+#include "CFilterPipeline.h"
+#include "CFilterFixed.h"
+#include "CFilterPrecise.h"
+#include "CDenormalGuard.h"
+#include "CFileSoundPrefetcher.h"
+#include "CWorkerPool.h"
+
+/*
+ * delay filters are created with a buffer for at least this delay, later
+ * changes of the delay parameters within this limit glide smoothly (in
+ * DELAY_GLIDE_MS) instead of creating a new filter
+ */
+#define DELAY_MAX_MS 2000
+#define DELAY_GLIDE_MS 50
+#define SKIP_SECONDS 5
 
 CAudioPlayerController::CAudioPlayerController() {
 	m_pSFile = NULL;		// association with 1 or 0 CSoundFile-objects
-	m_pFilter = NULL;		// association with 1 or 0 CFilter-objects
+	m_pipelineLatency = 0;	// filter chains are processed by the audio thread
+	m_prefetchMs = CFileSoundPrefetcher::DEFAULT_FILL_MS;
+	m_precision = CFilterPreciseFactory::PRECISION_FLOAT;	// fastest engines
 }
 
 CAudioPlayerController::~CAudioPlayerController() {
 	if (m_pSFile)
 		delete m_pSFile;
-	if (m_pFilter)
-		delete m_pFilter;
 }
 
 void CAudioPlayerController::run() {
@@ -46,7 +68,8 @@ void CAudioPlayerController::run() {
 	 *
 	 ***************************************************************/
 	string mainMenue[] = { "select sound", "select filter", "play",
-			"choose amplitude scale", "terminate player", "" };
+			"choose amplitude scale", "save filtered sound", "terminate player",
+			"" };
 	while (1) {
 		// if an exception will be thrown by one of the methods, the main menu will be shown
 		// after an error message has been displayed. The user may decide, what to do (recoverable error)
@@ -71,6 +94,9 @@ void CAudioPlayerController::run() {
 				chooseAmplitudeScale();
 				break;
 			case 4:
+				renderSound();
+				break;
+			case 5:
 				return;
 			default:
 				m_ui.printMessage("invalid selection. \n");
@@ -102,6 +128,9 @@ void CAudioPlayerController::init() {
 		m_ui.init(CUserInterface::CONSOLE);
 		break;
 	}
+	// the threads of the channel-parallel filters are started here, not by
+	// the first block of the audio thread
+	CWorkerPool::getShared();
 }
 
 void CAudioPlayerController::chooseFilter() {
@@ -115,24 +144,32 @@ void CAudioPlayerController::chooseFilter() {
 	string chosenFile;
 	int fid = CUI_UNKNOWN;
 	int delay_ms = 0;
-	float gFB = 0., gFF = 0.;
+	float gFB = 0., gFF = 0., depth_ms = 0., rate_Hz = 0.;
 
 	// show the menu and get the user's choice
-	string fltMenue[] = { "delay filter", "other filter", "remove filter", "" };
+	string fltMenue[] = { "delay filter", "other filter",
+			"add delay filter to chain", "add other filter to chain",
+			"bypass/enable chain stage", "pipeline latency (multi-core chain)",
+			"filter precision", "remove filter", "" };
 	int idChoice = m_ui.getListSelection(fltMenue, "choose a filter type");
 
-	if (idChoice == 0) // delay filter
+	if ((idChoice == 0) || (idChoice == 2)) // delay filter
 			{
 		// ask the user for the values of delay (ms), feed forward gain and feedback gain
-		if (false == _configDelayFilter(delay_ms, gFF, gFB)) {
+		if (false
+				== _configDelayFilter(delay_ms, gFF, gFB, depth_ms, rate_Hz)) {
 			m_ui.printMessage(
 					"Error from selectFilter: Wrong configuration for delay filter. Did not change filter. \n");
 			return;
+		} else if (idChoice == 2) {
+			// append a delay filter to the current filter(s)
+			_appendStage(
+					_buildDelayFilter(delay_ms, gFF, gFB, depth_ms, rate_Hz));
 		} else {
 			// create a new delay filter (delete the old filter, if there already was one)
-			_createDelayFilter(delay_ms, gFF, gFB);
+			_createDelayFilter(delay_ms, gFF, gFB, depth_ms, rate_Hz);
 		}
-	} else if (idChoice == 1)	// "normal" filter
+	} else if ((idChoice == 1) || (idChoice == 3))	// "normal" filter
 			{
 		string filePath = ".\\files\\filters\\", fileExt = ".txt";
 		// show a li st of the filters available in the path and get the users choice (fid) and
@@ -143,17 +180,25 @@ void CAudioPlayerController::chooseFilter() {
 			// wrong ID
 			m_ui.printMessage(
 					"Error from selectFilter: No filter data available! Did not change filter. \n");
+		} else if (idChoice == 3) {
+			// append the filter to the current filter(s)
+			_appendStage(_buildFilter(chosenFile));
 		} else {
 			// create the filter for the current sound file (delete the old filter, if there already was one)
 			_createFilter(chosenFile);
 		}
+	} else if (idChoice == 4)	// bypass a stage of the chain
+			{
+		_toggleBypass();
+	} else if (idChoice == 5)	// process the chain by several threads
+			{
+		_configPipeline();
+	} else if (idChoice == 6)	// precision of the direct form filters
+			{
+		_configPrecision();
 	} else // remove the current filter
 	{
-		if (m_pFilter) // if there was a filter object from a preceding choice of the user
-		{
-			delete m_pFilter;	// ... delete this
-			m_pFilter = NULL;		// currently we have no filter
-		}
+		m_filterSlot.publish(NULL);		// currently we have no filter
 		m_ui.printMessage("Message from selectFilter: Filter removed. \n");
 		return;
 	}
@@ -170,49 +215,164 @@ void CAudioPlayerController::play() {
 
 
 	int framesPerB = m_pSFile->getSampleRate() / 8;
-	int sbufSize = m_pSFile->getNumChannels() * framesPerB;
-	float *sbuf = new float[sbufSize];
-	float *sbufFilt = new float[sbufSize];
-	int readSize=0;
+	// planar block for the end of the sound in the pipeline
+	CAudioBlock block(m_pSFile->getNumChannels(), framesPerB,
+			m_pSFile->getSampleRate());
+	int readSize=framesPerB;
+	int latency = _getLatency();	// blocks still in the pipeline at the end
+	// the sound file is decoded ahead by a thread of its own, the loop below
+	// takes the decoded blocks and never waits for the disk
+	CFileSoundPrefetcher prefetcher(m_pSFile, framesPerB, m_prefetchMs);
 	m_audioStream.open(m_pSFile->getNumChannels(), m_pSFile->getSampleRate(),
 			framesPerB);
 	m_audioStream.start();
 
-	m_ui.printMessage("Press Enter to START/STOP/RESUME the Audio!!");
+	m_ui.printMessage("Press Enter to START/STOP/RESUME the Audio!!\n"
+			"f+Enter/b+Enter: skip " + to_string(SKIP_SECONDS)
+			+ " s forward/back");
 	while (1) {
 		if (m_ui.keyPressed())
 			break;
 	}
+	prefetcher.waitFilled();
+	// decaying filter states must not become subnormal while the sound fades
+	// out (restored when play() returns)
+	CDenormalGuard denormalGuard;
    bool key=true;
+	uint64_t playPos = 0;	// frame of the next block to be played
 	do{
 		if(key){
-		readSize=m_pSFile->read(sbuf, framesPerB);
-		if(m_pFilter){
-		m_pFilter->filter(sbuf, sbufFilt, framesPerB);
-		m_ui.visualizeAmplitude(sbufFilt, readSize);
-		m_audioStream.play(sbufFilt, readSize);
-
-		}
-		else{
-			m_ui.visualizeAmplitude(sbuf, readSize);
-			m_audioStream.play(sbuf, readSize);
-
+		CAudioBlock *pBlock = prefetcher.front();
+		if (pBlock) {
+			// the block is filtered in place in the ring
+			readSize = pBlock->getNumFrames();
+			playPos += readSize;
+			if (latency && (readSize < framesPerB)) {
+				// a pipeline takes and returns complete blocks only
+				CAudioBlock tail(*pBlock, readSize, framesPerB - readSize);
+				tail.clear();
+				pBlock->setNumFrames(framesPerB);
+			}
+			// filter changes are crossfaded by the slot
+			m_filterSlot.filter(*pBlock, *pBlock);
+			m_ui.visualizeAmplitude(*pBlock);
+			m_audioStream.play(*pBlock);
+			prefetcher.pop();
+		} else if (prefetcher.isFinished()) {
+			readSize = 0;
+		} else {
+			// underrun: the decoder is behind, try again
+			usleep(1000);
 		}
 		}
 		if (m_ui.keyPressed()){
-			key=!key;
+			string cmd = m_ui.getKeyText();
+			if ((cmd == "f") || (cmd == "b")) {
+				// the next block played is the one at the new position
+				int64_t skip = (int64_t) SKIP_SECONDS
+						* m_pSFile->getSampleRate();
+				int64_t target = (int64_t) playPos + ((cmd == "f") ? skip : -skip);
+				if (target < 0)
+					target = 0;
+				if (target > (int64_t) m_pSFile->getNumFrames())
+					target = m_pSFile->getNumFrames();
+				prefetcher.seek(target);
+				// no decaying states of the old position at the new one
+				m_filterSlot.reset();
+				playPos = target;
+				readSize = framesPerB;
+				prefetcher.waitFilled(1);
+			} else
+				key=!key;
 //			m_audioStream.pause();
 //			while(m_ui.keyPressed()==false);
 //			m_audioStream.resume();
 		}
 	}
     while(readSize==framesPerB);
+	// play the end of the sound from the pipeline
+	for (int i = 0; i < latency; i++) {
+		block.setNumFrames(framesPerB);
+		block.clear();
+		m_filterSlot.filter(block, block);
+		m_audioStream.play(block);
+	}
 	m_audioStream.stop();
 	m_audioStream.close();
+	m_filterSlot.collect();		// delete the filters replaced while playing
+	if (prefetcher.getUnderruns() || prefetcher.hasFailed())
+		m_ui.printMessage(
+				"prefetch: " + to_string(prefetcher.getUnderruns())
+						+ " underruns"
+						+ (prefetcher.hasFailed() ? ", read error" : "")
+						+ "\n");
+
+	// show which stage of a filter chain dominates the processing time
+	CFilterChain *pChain = _getChain(m_filterSlot.getFilter());
+	if (pChain) {
+		for (int i = 0; i < pChain->getNumStages(); i++)
+			m_ui.printMessage(
+					"stage " + to_string(i + 1) + " ("
+							+ _describeFilter(pChain->getStage(i)) + "): "
+							+ to_string(pChain->getStageTime(i))
+							+ " ns/sample\n");
+		pChain->resetTiming();
+	}
 
+	prefetcher.stop();		// the decoder thread must not read any more
 	m_pSFile->rewind();
 }
 
+void CAudioPlayerController::renderSound() {
+	if (!m_pSFile) {
+		m_ui.printMessage("No Sound File Selected yet \n");
+		return;
+	}
+	string path = m_ui.getUserInputPath("output file (.wav): ");
+	CFileSound outFile(path, "w");
+	outFile.setFormat(m_pSFile->getFormat());
+	outFile.setNumChannels(m_pSFile->getNumChannels());
+	outFile.setSampleRate(m_pSFile->getSampleRate());
+	outFile.setDither(true);	// TPDF dither when quantizing to 16/24 bit
+	outFile.open();
+
+	int framesPerB = m_pSFile->getSampleRate() / 8;
+	// planar block, filtered in place
+	CAudioBlock block(m_pSFile->getNumChannels(), framesPerB,
+			m_pSFile->getSampleRate());
+	int latency = _getLatency();		// leading blocks of the pipeline to be dropped
+	uint64_t remaining = m_pSFile->getNumFrames();
+	CDenormalGuard denormalGuard;	// flush-to-zero while filtering
+	try {
+		m_pSFile->rewind();
+		m_filterSlot.reset();
+		// without audio output the blocks are filtered as fast as the
+		// pipeline allows, the first latency blocks are silence
+		for (int blk = 0; remaining > 0; blk++) {
+			// zeros after the end of the sound flush the pipeline
+			int readSize = m_pSFile->read(block);
+			CAudioBlock tail(block, readSize, framesPerB - readSize);
+			tail.clear();
+			block.setNumFrames(framesPerB);
+			m_filterSlot.filter(block, block);
+			if (blk < latency)
+				continue;
+			uint64_t frames =
+					remaining < (uint64_t) framesPerB ? remaining : framesPerB;
+			block.setNumFrames(frames);
+			outFile.write(block);
+			remaining -= frames;
+		}
+	} catch (CException &e) {
+		m_pSFile->rewind();
+		throw;
+	}
+	outFile.close();
+	m_filterSlot.collect();
+	m_pSFile->rewind();
+	m_ui.printMessage("Message from renderSound: " + path + " written. \n");
+}
+
 void CAudioPlayerController::chooseSound() {
 	// todo delete next line and implement chooseSound() here
 //	m_ui.printMessage("chooseSound() not yet implemented!");
@@ -247,6 +407,8 @@ void CAudioPlayerController::chooseSound() {
 
 		if(sid!=CUI_UNKNOWN){
 		CFileSound* snd=new CFileSound(filePath+sndFList[sid]);
+		// decoded once, choosing the sound again takes it from memory
+		snd->setCacheEnabled(true);
 		snd->open();
 
 		if(m_pSFile)
@@ -284,72 +446,95 @@ void CAudioPlayerController::chooseAmplitudeScale() {
  * private helper methods
  */
 bool CAudioPlayerController::_configDelayFilter(int &delay_ms, float &gFF,
-		float &gFB) {
+		float &gFB, float &depth_ms, float &rate_Hz) {
 	m_ui.printMessage("Delay filter configuration\n------------\n");
 	delay_ms = abs(m_ui.getUserInputInt("delay in msec: "));
 	gFF = m_ui.getUserInputFloat("feed forward gain: ");
 	gFB = m_ui.getUserInputFloat("feed back gain  (0 <= gFB < 1): ");
+	depth_ms = fabs(m_ui.getUserInputFloat("modulation depth in msec (0: none): "));
+	rate_Hz = 0.;
+	if (depth_ms > 0.)
+		rate_Hz = fabs(m_ui.getUserInputFloat("modulation rate in Hz: "));
 	if ((gFB < 0.) || (gFB >= 1.))
 		return false;
+	// a zero delay is no delay filter, the circular buffer of the delay filter
+	// must hold the delay plus the modulation depth
+	if ((delay_ms == 0) || (delay_ms + depth_ms
+			> CFilterDelay::getDelayLimit(m_pSFile->getSampleRate())))
+		return false;
 	return true;
 }
 
-void CAudioPlayerController::_createDelayFilter(int delay_ms, float gFF,
-		float gFB) {
-	// todo: comment out, if CDelayFilter exists
-//	m_ui.printMessage(
-//			"Delay filters are not yet implemented. Filter won't be changed. \n");
-	// todo: comment in, if CDelayFilter exists
-	if (m_pFilter)
-		delete m_pFilter;
-	m_pFilter = new CFilterDelay(gFF, gFB, delay_ms, m_pSFile->getSampleRate(),
-			m_pSFile->getNumChannels());
+void CAudioPlayerController::_createDelayFilter(float delay_ms, float gFF,
+		float gFB, float depth_ms, float rate_Hz) {
+	// change the parameters of a suitable delay filter without reallocation
+	CFilterDelay *pdflt = dynamic_cast<CFilterDelay*>(m_filterSlot.getFilter());
+	if (pdflt && (pdflt->getSampleRate() == m_pSFile->getSampleRate())
+			&& (pdflt->getNumChannels() == m_pSFile->getNumChannels())
+			&& (pdflt->getMaxDelay() >= delay_ms + depth_ms)) {
+		pdflt->setParameters(delay_ms, gFF, gFB, DELAY_GLIDE_MS);
+		pdflt->setModulation(depth_ms, rate_Hz);
+		return;
+	}
+
+	_publishFilter(_buildDelayFilter(delay_ms, gFF, gFB, depth_ms, rate_Hz));
+}
+
+CFilterBase* CAudioPlayerController::_buildDelayFilter(float delay_ms,
+		float gFF, float gFB, float depth_ms, float rate_Hz) {
+	CFilterDelay *pdflt = new CFilterDelay(gFF, gFB, delay_ms,
+			m_pSFile->getSampleRate(), m_pSFile->getNumChannels(),
+			fmax(DELAY_MAX_MS, delay_ms + depth_ms));
+	pdflt->setModulation(depth_ms, rate_Hz);
+	return pdflt;
 }
 
 int CAudioPlayerController::_chooseFilterFile(string &chosenFile,
 		string filePath, string fileExt) {
-	string filterlist[25];
-
-	// get all files that are stored in filePath and that extension matches fileExt
-	uint16_t numflt = _getFiles(filePath, fileExt, filterlist, 25); // get the list of filter files
-
-	// list the files and their information
+	// bring the index of the directory up to date (new or changed files)
+	m_library.setDirectory(filePath, fileExt);
+	m_library.refresh();
+
+	// list the filters for the sampling frequency and their information,
+	// followed by the filters derived from the nearest sampling frequency
+	int fs = m_pSFile->getSampleRate();
+	int numflt = m_library.getNumFilters(fs);
+	int numall = numflt + m_library.getNumDerived(fs);
 	uint16_t fid = CUI_UNKNOWN;
-	if (numflt)									// if there are filters that fit
+	if (numall)									// if there are filters that fit
 	{
 		// prepare a string array for the user interface, that will contain  a menu with the selection of filters
 		// there is place for an additional entry for an unfiltered sound and an empty string
-		string *pFlt = new string[numflt + 2];
-
-		for (int i = 0; i < numflt; i++) {
-			// create a filter file object
-			CFileFilter fltfile(filePath + filterlist[i]);
-			try {
-				fltfile.open();
-				// check if it has a filter with an appropriate sampling frequency
-				fltfile.read(m_pSFile->getSampleRate());
-				// insert the filter data into the string array
-				pFlt[i] = fltfile.getFilterType() + ", order="
-						+ to_string(fltfile.getOrder())
-						+ fltfile.getFilterInfo();
-				fltfile.close();
-			} catch (CException &e) {
-				// file does not have the appropriate sampling frequency
-				if (e.getErrorCode() != CFileBase::E_FILENOTOPEN)
-					fltfile.close();
-				// file could not be opened (nothing to do)
-			}
+		string *pFlt = new string[numall + 2];
+
+		for (int i = 0; i < numall; i++) {
+			const CFilterLibrary::FILTER *pFilter =
+					(i < numflt) ?
+							m_library.getFilter(fs, i) :
+							m_library.getDerived(fs, i - numflt);
+			pFlt[i] = pFilter->type + ", order=" + to_string(pFilter->order)
+					+ pFilter->info;
+			if (pFilter->cutoff > 0.)
+				pFlt[i] += ", fc=" + to_string(lround(pFilter->cutoff)) + "Hz";
+			if (!pFilter->stable)
+				pFlt[i] += " [UNSTABLE]";
+			if (i >= numflt)
+				pFlt[i] += " [derived from " + to_string(pFilter->fs) + "Hz]";
 		}
 
 		// add the last menu entry for the choice of an unfiltered sound
-		pFlt[numflt] = "-1 [no filter]";
+		pFlt[numall] = "-1 [no filter]";
 
 		// pass the arrays to the user interface and wait for the user's input
 		// if the user provides a filterID which is not in pFIDs, the method returns
 		// CUI_UNKNOWN
 		fid = m_ui.getListSelection(pFlt, "choose a filter");
-		if (fid != CUI_UNKNOWN)
-			chosenFile = filePath + filterlist[fid];
+		if ((fid != CUI_UNKNOWN) && (fid < numflt))
+			chosenFile = filePath + m_library.getFilter(fs, fid)->file;
+		else if ((fid != CUI_UNKNOWN) && (fid < numall))
+			chosenFile = filePath + m_library.getDerived(fs, fid - numflt)->file;
+		else
+			fid = CUI_UNKNOWN;
 
 		// destroy the array
 		delete[] pFlt;
@@ -358,42 +543,235 @@ int CAudioPlayerController::_chooseFilterFile(string &chosenFile,
 }
 
 void CAudioPlayerController::_createFilter(string filterFile) {
-	// if there was a filter object from a preceding choice of the user that does not fit anymore, delete this
-	if (m_pFilter)
-		delete m_pFilter;
+	// the filter of a preceding choice of the user is replaced (and deleted) by the filter slot
+	_publishFilter(_buildFilter(filterFile));
+}
 
+CFilterBase* CAudioPlayerController::_buildFilter(string filterFile) {
+	CFilterBase *pFilter = NULL;
+
+	// coefficients for sampling frequencies the file does not contain are
+	// derived from the nearest section
 	CFileFilter fltfile(filterFile);
 	fltfile.open();
-	fltfile.read(m_pSFile->getSampleRate());
+	if (!fltfile.readDerived(m_pSFile->getSampleRate())) {
+		fltfile.close();
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"No filter coefficients for " + to_string(m_pSFile->getSampleRate())
+						+ "Hz in " + filterFile);
+	}
 
 	// create filter
 	// Lab05 changed: get filter data
-	uint8_t order = fltfile.getOrder();
+	int order = fltfile.getOrder();
 	string type = fltfile.getFilterType();
 	float *ac = fltfile.getACoeffs();
 	float *bc = fltfile.getBCoeffs();
-	m_pFilter = new CFilter(filterFile, ac, bc, order,
-			m_pSFile->getNumChannels());
+
+	// sparse filters (delay lines) are calculated by their non-zero taps only,
+	// recursive filters of higher order as cascade of second order sections
+	// (numerically robust), long FIR filters by fast convolution, all others
+	// by direct form (specialized for the order and channels if possible);
+	// if the user has chosen a higher precision, dense filters are calculated
+	// by the direct form with double states (and coefficients)
+	bool recursive = false;
+	for (int i = 1; i <= order; i++)
+		if (ac[i] != 0.)
+			recursive = true;
+	if (fltfile.isSparse()) {
+		pFilter = new CFilterSparse(filterFile, fltfile.getATapIndices(),
+				fltfile.getATapValues(), fltfile.getNumATaps(),
+				fltfile.getBTapIndices(), fltfile.getBTapValues(),
+				fltfile.getNumBTaps(), order, m_pSFile->getNumChannels());
+	} else if (!recursive && (order >= CFilterFFT::MIN_ORDER)) {
+		// normalize by a0 like the direct form
+		float *b = new float[order + 1];
+		for (int i = 0; i <= order; i++)
+			b[i] = bc[i] / ac[0];
+		pFilter = new CFilterFFT(filterFile, b, order,
+				m_pSFile->getNumChannels());
+		delete[] b;
+	} else if (order > UINT16_MAX) {
+		// the engines of recursive filters take a 16 bit order
+		fltfile.close();
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter order " + to_string(order)
+						+ " too high for a recursive filter in " + filterFile);
+	} else if (m_precision != CFilterPreciseFactory::PRECISION_FLOAT) {
+		pFilter = CFilterPreciseFactory::create(filterFile,
+				fltfile.getACoeffsDouble(), fltfile.getBCoeffsDouble(), order,
+				m_pSFile->getNumChannels(), m_precision);
+	} else if (recursive && (order > 2) && (order <= CFilterSOS::MAX_ORDER)) {
+		try {
+			pFilter = new CFilterSOS(filterFile, ac, bc, order,
+					m_pSFile->getNumChannels());
+		} catch (CException &e) {
+			// coefficients could not be factored, use the direct form
+		}
+	}
+	if (pFilter == NULL)
+		pFilter = CFilterFixedFactory::create(filterFile, ac, bc, order,
+				m_pSFile->getNumChannels());
+	fltfile.close();
+	// multichannel sounds: the channels are filtered by several threads if
+	// the blocks are large enough (ignored by engines without channel kernel)
+	pFilter->setChannelParallel(true);
+	return pFilter;
 }
 
 void CAudioPlayerController::_adaptFilter() {
-	if (m_pFilter) {
-		// check filter type
-		if (typeid(*m_pFilter) == typeid(CFilter))
-			_createFilter(((CFilter*) m_pFilter)->getFilePath());
-		else {
-			// todo: comment out, if CDelayFilter exists
-//			m_ui.printMessage(
-//					"Delay filters are not yet implemented. Filter will be deleted. \n");
-//			if (m_pFilter)
-//				delete m_pFilter;
-
-			// todo: comment in, if CDelayFilter exists
-			CFilterDelay *pdflt = (CFilterDelay*) m_pFilter;
-			_createDelayFilter(pdflt->getDelay(), pdflt->getGainFF(),
-					pdflt->getGainFB());
+	CFilterBase *pFilter = m_filterSlot.getFilter();
+	if (pFilter)
+		_publishFilter(_adaptStage(pFilter));
+}
+
+CFilterBase* CAudioPlayerController::_adaptStage(CFilterBase *pFilter) {
+	// check filter type (filters created from a filter file know their file)
+	CFilterChain *pChain = _getChain(pFilter);
+	if (pChain) {
+		CFilterChain *pNewChain = new CFilterChain(m_pSFile->getNumChannels());
+		try {
+			for (int i = 0; i < pChain->getNumStages(); i++) {
+				int idx = pNewChain->addStage(_adaptStage(pChain->getStage(i)));
+				pNewChain->setBypass(idx, pChain->getBypass(i));
+			}
+		} catch (CException &e) {
+			delete pNewChain;
+			throw;
 		}
+		return pNewChain;
+	}
+	if (!pFilter->getFilePath().empty())
+		return _buildFilter(pFilter->getFilePath());
+	CFilterDelay *pdflt = (CFilterDelay*) pFilter;
+	return _buildDelayFilter(pdflt->getDelay(), pdflt->getGainFF(),
+			pdflt->getGainFB(), pdflt->getModulationDepth(),
+			pdflt->getModulationRate());
+}
+
+void CAudioPlayerController::_appendStage(CFilterBase *pStage) {
+	// the running filter(s) must not be changed: the chain is built from new
+	// filters of the same configuration and replaces the current filter
+	CFilterChain *pChain = new CFilterChain(m_pSFile->getNumChannels());
+	try {
+		CFilterBase *pCurrent = m_filterSlot.getFilter();
+		CFilterChain *pCurChain = _getChain(pCurrent);
+		if (pCurChain) {
+			for (int i = 0; i < pCurChain->getNumStages(); i++) {
+				int idx = pChain->addStage(
+						_adaptStage(pCurChain->getStage(i)));
+				pChain->setBypass(idx, pCurChain->getBypass(i));
+			}
+		} else if (pCurrent)
+			pChain->addStage(_adaptStage(pCurrent));
+		pChain->addStage(pStage);
+	} catch (CException &e) {
+		// the new filter has not become part of the chain
+		if (pChain->getStage(pChain->getNumStages() - 1) != pStage)
+			delete pStage;
+		delete pChain;
+		throw;
 	}
+	_publishFilter(pChain);
+}
+
+void CAudioPlayerController::_toggleBypass() {
+	CFilterChain *pChain = _getChain(m_filterSlot.getFilter());
+	if (pChain == NULL) {
+		m_ui.printMessage("Error from selectFilter: There is no filter chain. \n");
+		return;
+	}
+	int num = pChain->getNumStages();
+	string *pStages = new string[num + 1];
+	for (int i = 0; i < num; i++)
+		pStages[i] = _describeFilter(pChain->getStage(i))
+				+ (pChain->getBypass(i) ? " [bypassed]" : "");
+	pStages[num] = "";
+	int idx = m_ui.getListSelection(pStages, "choose a stage");
+	delete[] pStages;
+	// play() is not running, the stage may be changed directly
+	if ((idx >= 0) && (idx < num))
+		pChain->setBypass(idx, !pChain->getBypass(idx));
+}
+
+void CAudioPlayerController::_configPipeline() {
+	int latency = m_ui.getUserInputInt(
+			"pipeline latency in blocks (0: no pipeline, max. "
+					+ to_string(CFilterPipeline::MAX_GROUPS - 1) + "): ");
+	if ((latency < 0) || (latency >= CFilterPipeline::MAX_GROUPS)) {
+		m_ui.printMessage("Error from selectFilter: Invalid latency. \n");
+		return;
+	}
+	m_pipelineLatency = latency;
+	// rebuild the current chain with the new latency
+	_adaptFilter();
+}
+
+void CAudioPlayerController::_configPrecision() {
+	string precMenu[] = { CFilterPreciseFactory::getPrecisionName(
+			CFilterPreciseFactory::PRECISION_FLOAT) + " (fastest)",
+			CFilterPreciseFactory::getPrecisionName(
+					CFilterPreciseFactory::PRECISION_MIXED),
+			CFilterPreciseFactory::getPrecisionName(
+					CFilterPreciseFactory::PRECISION_DOUBLE), "" };
+	int usel = m_ui.getListSelection(precMenu, "choose the filter precision");
+	switch (usel) {
+	case 0:
+		m_precision = CFilterPreciseFactory::PRECISION_FLOAT;
+		break;
+	case 1:
+		m_precision = CFilterPreciseFactory::PRECISION_MIXED;
+		break;
+	case 2:
+		m_precision = CFilterPreciseFactory::PRECISION_DOUBLE;
+		break;
+	default:
+		m_ui.printMessage("Error from selectFilter: Invalid precision. \n");
+		return;
+	}
+	// rebuild the current filter(s) with the new precision
+	_adaptFilter();
+}
+
+void CAudioPlayerController::_publishFilter(CFilterBase *pFilter) {
+	CFilterChain *pChain = dynamic_cast<CFilterChain*>(pFilter);
+	if (pChain && (m_pipelineLatency > 0) && (pChain->getNumStages() > 1)) {
+		try {
+			pFilter = new CFilterPipeline(pChain,
+					m_pSFile->getSampleRate() / 8, m_pipelineLatency);
+		} catch (CException &e) {
+			delete pChain;
+			throw;
+		}
+	}
+	// the audio thread must not allocate the buffers of the new filter (nor
+	// the crossfade buffer of the slot)
+	if (pFilter)
+		pFilter->prepare(m_pSFile->getSampleRate() / 8);
+	m_filterSlot.publish(pFilter, m_pSFile->getSampleRate() / 8);
+}
+
+CFilterChain* CAudioPlayerController::_getChain(CFilterBase *pFilter) {
+	CFilterPipeline *pPipeline = dynamic_cast<CFilterPipeline*>(pFilter);
+	if (pPipeline)
+		return pPipeline->getChain();
+	return dynamic_cast<CFilterChain*>(pFilter);
+}
+
+int CAudioPlayerController::_getLatency() {
+	CFilterBase *pFilter = m_filterSlot.getFilter();
+	return pFilter ? pFilter->getLatency() : 0;
+}
+
+string CAudioPlayerController::_describeFilter(CFilterBase *pFilter) {
+	if (pFilter == NULL)
+		return "no filter";
+	if (!pFilter->getFilePath().empty())
+		return pFilter->getFilePath();
+	CFilterDelay *pdflt = dynamic_cast<CFilterDelay*>(pFilter);
+	if (pdflt)
+		return "delay " + to_string((int) (pdflt->getDelay() + 0.5)) + "ms";
+	return "filter chain";
 }
 
 uint16_t CAudioPlayerController::_getFiles(string path, string ext,
@@ -10,7 +10,12 @@
 #define SRC_CAUDIOPLAYERCONTROLLER_H_
 
 #include "CFileSound.h"
+#include "CFileSoundPrefetcher.h"
 #include "CFilterBase.h"
+#include "CFilterSlot.h"
+#include "CFilterChain.h"
+#include "CFilterPrecise.h"
+#include "CFilterLibrary.h"
 #include "CUserInterface.h"
 #include "CSimpleAudioOutStream.h"
 
@@ -18,8 +23,12 @@ class CAudioPlayerController {
 private:
 
 	CUserInterface m_ui;
-	CFilterBase *m_pFilter;
+	CFilterSlot m_filterSlot;	// filter used by play(), replaced without interrupting the audio
+	int m_pipelineLatency;		// blocks of latency for pipelined filter chains (0: no pipeline)
+	CFilterPreciseFactory::PRECISION m_precision;	// precision of the direct form filters
+	CFilterLibrary m_library;	// filters of the filter files by sampling frequency (indexed)
 	CFileSound *m_pSFile;
+	int m_prefetchMs;			// fill level of the read-ahead of play() in milliseconds
 	CSimpleAudioOutStream m_audioStream;
 
 public:
@@ -33,6 +42,15 @@ private:
 	void play();
 	void chooseSound();
 
+	/**
+	 * \brief filters the current sound file with the current filter and
+	 * \brief writes the result into a new sound file (no audio output)
+	 *
+	 * the latency of a pipelined filter chain is compensated, the result is
+	 * aligned with the original sound
+	 */
+	void renderSound();
+
 	/**
 	 * \brief Displays a menu with the options "linear scale" and "logarithmic scale" and
 	 * \brief lets the user choose an option and calls m_ui.setAmplitudeScaling() according to
@@ -48,7 +66,9 @@ private:
 	 * \brief user choice of filter from filter files stored in filePath
 	 *
 	 * only filter files that are containing the sampling frequency of the
-	 * currently selected audio file
+	 * currently selected audio file, the list shows the cutoff frequency and
+	 * flags unstable coefficients; the list is taken from the index of the
+	 * directory (see CFilterLibrary), only new or changed files are read
 	 *
 	 * \param fs[in] - appropriate sampling frequency
 	 * \param chosenFile[out] - filter file chosen by the user
@@ -66,24 +86,120 @@ private:
 	 */
 	void _createFilter(string filterFile);
 
+	/**
+	 * \brief creates a filter object for the filter file and the current sound file
+	 *
+	 * chooses the engine that fits the coefficients (sparse, FFT, SOS or direct form)
+	 *
+	 * \param filterFile[in] - filter file
+	 * \return new filter (owned by the caller)
+	 */
+	CFilterBase* _buildFilter(string filterFile);
+
 	/**
 	 * \brief lets the user enter the parameters of a delay filter
 	 * \param delay_ms[out] - delay in milliseconds
 	 * \param gFF[out] - feed forward gain (linear)
 	 * \param gFB[out] - feed back gain (linear)
+	 * \param depth_ms[out] - modulation depth in milliseconds (0: no modulation)
+	 * \param rate_Hz[out] - modulation rate in Hz
 	 * \returns
 	 * - true: entered parameters are valid
 	 * - false: otherwise
 	 */
-	bool _configDelayFilter(int &delay_ms, float &gFF, float &gFB);
+	bool _configDelayFilter(int &delay_ms, float &gFF, float &gFB,
+			float &depth_ms, float &rate_Hz);
 
 	/**
 	 * \brief creates a delay filter for the given parameters
+	 *
+	 * if the current filter is a delay filter for the same sampling frequency
+	 * and number of channels with sufficient maximum delay, its parameters
+	 * glide to the new values instead (no reallocation, no click)
+	 *
+	 * \param delay_ms[in] - delay in milliseconds
+	 * \param gFF[in] - feed forward gain (linear)
+	 * \param gFB[in] - feed back gain (linear)
+	 * \param depth_ms[in] - modulation depth in milliseconds (0: no modulation)
+	 * \param rate_Hz[in] - modulation rate in Hz
+	 */
+	void _createDelayFilter(float delay_ms, float gFF, float gFB,
+			float depth_ms = 0., float rate_Hz = 0.);
+
+	/**
+	 * \brief creates a delay filter object for the current sound file
 	 * \param delay_ms[in] - delay in milliseconds
 	 * \param gFF[in] - feed forward gain (linear)
 	 * \param gFB[in] - feed back gain (linear)
+	 * \param depth_ms[in] - modulation depth in milliseconds (0: no modulation)
+	 * \param rate_Hz[in] - modulation rate in Hz
+	 * \return new filter (owned by the caller)
+	 */
+	CFilterBase* _buildDelayFilter(float delay_ms, float gFF, float gFB,
+			float depth_ms, float rate_Hz);
+
+	/**
+	 * \brief appends a filter to the current filter(s)
+	 *
+	 * builds a filter chain of the current filter (or the stages of the
+	 * current chain) and the new filter and replaces the current filter
+	 *
+	 * \param pStage[in] - new filter (ownership is passed)
+	 */
+	void _appendStage(CFilterBase *pStage);
+
+	/**
+	 * \brief lets the user bypass or enable a stage of the current filter chain
+	 */
+	void _toggleBypass();
+
+	/**
+	 * \brief lets the user choose the latency of pipelined filter chains
+	 *
+	 * filter chains with more than one stage are processed by up to
+	 * latency+1 threads, the sound is delayed by latency blocks
+	 */
+	void _configPipeline();
+
+	/**
+	 * \brief lets the user choose the precision of filters from filter files
+	 *
+	 * float: fastest engine for the filter (SOS, specialized or vectorized
+	 * direct form), mixed/double: direct form with double states (for
+	 * filters with poles close to the unit circle), the current filter(s)
+	 * are rebuilt
+	 */
+	void _configPrecision();
+
+	/**
+	 * \brief replaces the current filter
+	 *
+	 * filter chains are pipelined if a pipeline latency has been chosen, the
+	 * buffers of the filter are allocated here (not by the audio thread)
+	 *
+	 * \param pFilter[in] - new filter or NULL (ownership is passed)
+	 */
+	void _publishFilter(CFilterBase *pFilter);
+
+	/**
+	 * \brief retrieves the filter chain of a filter
+	 * \param pFilter[in] - filter chain, pipelined filter chain or other filter
+	 * \return filter chain or NULL if the filter is no chain
 	 */
-	void _createDelayFilter(int delay_ms, float gFF, float gFB);
+	CFilterChain* _getChain(CFilterBase *pFilter);
+
+	/**
+	 * \brief retrieves the latency of the current filter
+	 * \return latency in blocks (0 if the filter is not pipelined)
+	 */
+	int _getLatency();
+
+	/**
+	 * \brief short description of a filter for menus and messages
+	 * \param pFilter[in] - filter
+	 * \return file path, delay or "filter chain"
+	 */
+	string _describeFilter(CFilterBase *pFilter);
 
 	/*
 	 * \brief adapt the current filter to a new sound file
@@ -94,6 +210,16 @@ private:
 	 */
 	void _adaptFilter();
 
+	/**
+	 * \brief creates a new filter of the same configuration for the current sound file
+	 *
+	 * filter chains are adapted stage by stage (including the bypass state)
+	 *
+	 * \param pFilter[in] - filter to adapt
+	 * \return new filter (owned by the caller)
+	 */
+	CFilterBase* _adaptStage(CFilterBase *pFilter);
+
 	/**
 	 * \brief reads all filenames with the given extension from the given directory and writes them
 	 * into a string array
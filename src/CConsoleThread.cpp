@@ -136,6 +136,13 @@ bool CConsoleThread::enterPressed() {
 	}
 }
 
+string CConsoleThread::getEnteredText() {
+	pthread_mutex_lock(&m_inMut);
+	string text = m_inText;
+	pthread_mutex_unlock(&m_inMut);
+	return text;
+}
+
 void CConsoleThread::writeConsole(const string text) {
 	// check the state
 	if (m_state != S_READY) {
@@ -195,6 +195,13 @@ public:
 	 */
 	bool enterPressed();
 
+	/**
+	 * text of the line of the last ENTER (detected by enterPressed())
+	 *
+	 * \return entered text (without line feed)
+	 */
+	string getEnteredText();
+
 	/**
 	 * \brief Prints the current state of the player IO control.
 	 */
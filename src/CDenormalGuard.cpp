@@ -0,0 +1,78 @@
+/**
+ * \file CDenormalGuard.cpp
+ * \brief implementation CDenormalGuard
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include "CSimd.h"
+#include "CDenormalGuard.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CDENORMALGUARD_X86
+#define CDENORMALGUARD_FLUSH 0x8040		// MXCSR: FTZ (bit 15) and DAZ (bit 6)
+#elif defined(__aarch64__) || defined(__arm__)
+#define CDENORMALGUARD_ARM
+#define CDENORMALGUARD_FLUSH 0x1000000	// FPCR/FPSCR: FZ (bit 24)
+#else
+#define CDENORMALGUARD_FLUSH 0
+#endif
+
+CDenormalGuard::CDenormalGuard() {
+	m_savedMode = getMode();
+	if (isSupported())
+		setMode(m_savedMode | CDENORMALGUARD_FLUSH);
+}
+
+CDenormalGuard::~CDenormalGuard() {
+	setMode(m_savedMode);
+}
+
+uint32_t CDenormalGuard::getMode() {
+#if defined(CDENORMALGUARD_X86)
+	if (CSimd::hasSSE2())
+		return _mm_getcsr();
+	return 0;
+#elif defined(__aarch64__)
+	uint64_t fpcr;
+	__asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+	return (uint32_t) fpcr;
+#elif defined(CDENORMALGUARD_ARM)
+	uint32_t fpscr;
+	__asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+	return fpscr;
+#else
+	return 0;
+#endif
+}
+
+void CDenormalGuard::setMode(uint32_t mode) {
+#if defined(CDENORMALGUARD_X86)
+	if (CSimd::hasSSE2())
+		_mm_setcsr(mode);
+#elif defined(__aarch64__)
+	uint64_t fpcr = mode;
+	__asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#elif defined(CDENORMALGUARD_ARM)
+	__asm__ __volatile__("vmsr fpscr, %0" : : "r"(mode));
+#else
+	(void) mode;
+#endif
+}
+
+bool CDenormalGuard::isFlushing() {
+	return isSupported()
+			&& ((getMode() & CDENORMALGUARD_FLUSH) == CDENORMALGUARD_FLUSH);
+}
+
+bool CDenormalGuard::isSupported() {
+#if defined(CDENORMALGUARD_X86)
+	// DAZ is available on all CPUs with SSE2
+	return CSimd::hasSSE2();
+#elif defined(CDENORMALGUARD_ARM)
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,74 @@
+/**
+ * \file CDenormalGuard.h
+ * \brief interface CDenormalGuard
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CDENORMALGUARD_H_
+#define CDENORMALGUARD_H_
+
+#include <stdint.h>
+
+/**
+ * \brief flush-to-zero mode of the floating point unit for a scope
+ *
+ * When a signal fades out, the states of recursive filters and the feedback
+ * of delay lines decay into subnormal numbers. Many CPUs process subnormal
+ * operands by microcode, each sample becomes 10 to 100 times slower. The
+ * constructor switches the floating point unit of the calling thread to
+ * flush subnormal results (FTZ) and operands (DAZ) to zero, the destructor
+ * restores the previous mode.
+ *
+ * - x86: MXCSR bits FTZ and DAZ (SSE/AVX arithmetic)
+ * - ARM: FPCR/FPSCR bit FZ
+ * - other: no effect
+ *
+ * The mode is a property of the thread, threads processing audio on behalf
+ * of another thread take over its mode (see getMode(), setMode()).
+ */
+class CDenormalGuard {
+private:
+	/**
+	 * \brief mode of the thread before the guard was created
+	 */
+	uint32_t m_savedMode;
+
+public:
+	/**
+	 * \brief Constructor, saves the mode of the calling thread and enables
+	 * flush-to-zero
+	 */
+	CDenormalGuard();
+	/**
+	 * \brief Destructor, restores the saved mode
+	 *
+	 * must be destroyed by the thread that created it
+	 */
+	~CDenormalGuard();
+	CDenormalGuard(const CDenormalGuard&) = delete;
+	CDenormalGuard& operator=(const CDenormalGuard&) = delete;
+
+	/**
+	 * \brief gets the floating point mode of the calling thread
+	 * \return mode (control register contents, 0 if not supported)
+	 */
+	static uint32_t getMode();
+	/**
+	 * \brief sets the floating point mode of the calling thread
+	 * \param mode mode returned by getMode()
+	 */
+	static void setMode(uint32_t mode);
+	/**
+	 * \brief checks if subnormal numbers are flushed to zero
+	 * \return true if flush-to-zero is enabled for the calling thread
+	 */
+	static bool isFlushing();
+	/**
+	 * \brief checks if the CPU supports flush-to-zero
+	 * \return true if supported, false otherwise
+	 */
+	static bool isSupported();
+};
+
+#endif /* CDENORMALGUARD_H_ */
@@ -0,0 +1,117 @@
+/**
+ * \file CFFT.cpp
+ * \brief implementation CFFT
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <SKSLib.h>
+#include "CFFT.h"
+
+CFFT::CFFT(uint32_t size) {
+	if ((size < 4) || ((size & (size - 1)) != 0))
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"FFT size must be a power of 2 (at least 4)!");
+	m_size = size;
+	uint32_t M = size / 2;
+
+	m_tw = new complex<float>[M / 2];
+	for (uint32_t k = 0; k < M / 2; k++)
+		m_tw[k] = polar(1., -2. * M_PI * k / M);
+	m_twReal = new complex<float>[M];
+	for (uint32_t k = 0; k < M; k++)
+		m_twReal[k] = polar(1., -2. * M_PI * k / size);
+
+	m_bitrev = new uint32_t[M];
+	uint32_t bits = 0;
+	while ((1u << bits) < M)
+		bits++;
+	for (uint32_t i = 0; i < M; i++) {
+		uint32_t r = 0;
+		for (uint32_t b = 0; b < bits; b++)
+			if (i & (1u << b))
+				r |= 1u << (bits - 1 - b);
+		m_bitrev[i] = r;
+	}
+	m_work = new complex<float>[M];
+}
+
+CFFT::~CFFT() {
+	delete[] m_tw;
+	delete[] m_twReal;
+	delete[] m_bitrev;
+	delete[] m_work;
+}
+
+uint32_t CFFT::getSize() {
+	return m_size;
+}
+
+void CFFT::_transform(complex<float> *a, bool inv) {
+	uint32_t M = m_size / 2;
+	for (uint32_t i = 0; i < M; i++) {
+		uint32_t r = m_bitrev[i];
+		if (r > i) {
+			complex<float> t = a[i];
+			a[i] = a[r];
+			a[r] = t;
+		}
+	}
+	// iterative decimation in time, complex products written out to avoid
+	// the NaN handling of the complex operator*
+	for (uint32_t len = 2; len <= M; len <<= 1) {
+		uint32_t half = len / 2, step = M / len;
+		for (uint32_t i = 0; i < M; i += len)
+			for (uint32_t j = 0; j < half; j++) {
+				float wr = m_tw[j * step].real();
+				float wi = inv ? -m_tw[j * step].imag() : m_tw[j * step].imag();
+				complex<float> u = a[i + j], v = a[i + j + half];
+				float tr = v.real() * wr - v.imag() * wi;
+				float ti = v.real() * wi + v.imag() * wr;
+				a[i + j] = complex<float>(u.real() + tr, u.imag() + ti);
+				a[i + j + half] = complex<float>(u.real() - tr, u.imag() - ti);
+			}
+	}
+}
+
+void CFFT::forward(const float *x, complex<float> *X) {
+	uint32_t M = m_size / 2;
+	// even samples as real part, odd samples as imaginary part
+	for (uint32_t n = 0; n < M; n++)
+		m_work[n] = complex<float>(x[2 * n], x[2 * n + 1]);
+	_transform(m_work, false);
+
+	// split into the spectra of the even and odd samples and combine them
+	for (uint32_t k = 0; k <= M; k++) {
+		complex<float> zk = m_work[k % M], zc = conj(m_work[(M - k) % M]);
+		complex<float> e = 0.5f * (zk + zc);
+		complex<float> o = complex<float>(0.f, -0.5f) * (zk - zc);
+		complex<float> w = (k < M) ? m_twReal[k] : complex<float>(-1.f, 0.f);
+		X[k] = complex<float>(
+				e.real() + w.real() * o.real() - w.imag() * o.imag(),
+				e.imag() + w.real() * o.imag() + w.imag() * o.real());
+	}
+}
+
+void CFFT::inverse(const complex<float> *X, float *x) {
+	uint32_t M = m_size / 2;
+	for (uint32_t k = 0; k < M; k++) {
+		complex<float> xk = X[k], xc = conj(X[M - k]);
+		complex<float> e = 0.5f * (xk + xc);
+		complex<float> d = 0.5f * (xk - xc);
+		// o = d / w = d * conj(w)
+		complex<float> w = m_twReal[k];
+		complex<float> o(d.real() * w.real() + d.imag() * w.imag(),
+				d.imag() * w.real() - d.real() * w.imag());
+		// z = e + i*o
+		m_work[k] = complex<float>(e.real() - o.imag(), e.imag() + o.real());
+	}
+	_transform(m_work, true);
+	float scale = 1.f / M;
+	for (uint32_t n = 0; n < M; n++) {
+		x[2 * n] = m_work[n].real() * scale;
+		x[2 * n + 1] = m_work[n].imag() * scale;
+	}
+}
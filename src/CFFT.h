@@ -0,0 +1,91 @@
+/**
+ * \file CFFT.h
+ * \brief interface CFFT
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFFT_H_
+#define CFFT_H_
+
+#include <stdint.h>
+#include <complex>
+using namespace std;
+
+/**
+ * \brief fast fourier transform of real signals
+ *
+ * radix 2 transform, the size must be a power of 2. A real signal of N samples
+ * is transformed by a complex transform of N/2 points. Twiddle factors and the
+ * bit reversal permutation are calculated once by the constructor, so the
+ * transforms don't allocate memory.
+ */
+class CFFT {
+private:
+	/**
+	 * \brief size of the real transform (N)
+	 */
+	uint32_t m_size;
+	/**
+	 * \brief twiddle factors of the complex transform (N/4 elements)
+	 */
+	complex<float> *m_tw;
+	/**
+	 * \brief twiddle factors for splitting the real transform (N/2 elements)
+	 */
+	complex<float> *m_twReal;
+	/**
+	 * \brief bit reversal permutation of the complex transform (N/2 elements)
+	 */
+	uint32_t *m_bitrev;
+	/**
+	 * \brief work buffer (N/2 elements)
+	 */
+	complex<float> *m_work;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * - prepares twiddle factors and bit reversal table
+	 * - throws exception if size is not a power of 2 or smaller than 4
+	 *
+	 * \param size number of real samples N
+	 */
+	CFFT(uint32_t size);
+	/**
+	 * \brief deletes tables and work buffer
+	 */
+	~CFFT();
+	/**
+	 * \brief transforms N real samples into N/2+1 spectral values
+	 *
+	 * \param x [in] N samples
+	 * \param X [out] N/2+1 spectral values (bin 0 ... N/2)
+	 */
+	void forward(const float *x, complex<float> *X);
+	/**
+	 * \brief transforms N/2+1 spectral values of a real signal into N samples
+	 *
+	 * forward() followed by inverse() restores the original signal (scaling by 1/N)
+	 *
+	 * \param X [in] N/2+1 spectral values (bin 0 ... N/2)
+	 * \param x [out] N samples
+	 */
+	void inverse(const complex<float> *X, float *x);
+	/**
+	 * \brief gets the size of the transform
+	 * \return number of real samples N
+	 */
+	uint32_t getSize();
+
+private:
+	/**
+	 * \brief complex in place transform of N/2 points
+	 * \param a data
+	 * \param inv true: inverse transform (without scaling)
+	 */
+	void _transform(complex<float> *a, bool inv);
+};
+
+#endif /* CFFT_H_ */
@@ -9,28 +9,93 @@
 #include "CFileBase.h"
 #include "SKSLib.h"
 #include <iomanip>
+#include <stdio.h>
+#include <charconv>
+#include <math.h>
+#include "CFilterAnalyzer.h"
+#include "CFilterDerivation.h"
+
+/*
+ * layout of the binary coefficient cache (native byte order, all offsets
+ * from the start of the file, arrays 8 byte aligned):
+ * header | type string | info string | data of the sections | section table
+ * data of a section: double b, double a, float b, float a (order+1 each)
+ * sections derived for other sampling frequencies (readDerived()) are
+ * appended to the stored sections
+ */
+#define CFILEFILTER_CACHE_MAGIC 0x43544c46		// "FLTC"
+#define CFILEFILTER_CACHE_ALIGN(x) (((x) + 7) & ~(uint64_t)7)
+
+struct CFILEFILTER_CACHEHEADER {
+	uint32_t magic;
+	uint32_t version;
+	int64_t srcMTime;		// modification time of the text file
+	uint64_t srcSize;		// size of the text file
+	uint64_t srcHash;		// FNV-1a hash of the text file
+	int32_t order;
+	int32_t numSections;
+	uint32_t typeLen;
+	uint32_t infoLen;
+	uint64_t tableOffset;
+};
+
+struct CFILEFILTER_CACHESECTION {
+	int32_t fs;
+	int32_t blen;
+	int32_t alen;
+	int32_t order;
+	int32_t sourceFs;		// derived section: fs of the source section (else 0)
+	int32_t reserved;
+	uint64_t dataOffset;
+	int64_t textEnd;		// position after the (source) section in the text file
+};
+
+/*
+ * section of the text file: lines of the coefficients
+ */
+struct CFILEFILTER_TEXTSECTION {
+	int32_t fs;
+	const char *pStart;		// fs line
+	const char *pB, *pBEnd;	// b line (without line feed)
+	const char *pA, *pAEnd;	// a line
+	const char *pEnd;		// first character after the section
+};
+
+const char* CFileFilter::CACHE_EXTENSION = ".fltc";
 
 CFileFilter::CFileFilter(const string path, const string mode) :
                            CFileBase(path,mode){
 	// TODO Auto-generated constructor stub
-	m_pFile=NULL;
     m_order=0;
     m_fs=0;
     m_a=NULL;
     m_b=NULL;
+    m_aDbl=NULL;
+    m_bDbl=NULL;
     blen=0;
     alen=0;
-
+    m_bTapIdx=NULL;
+    m_bTapVal=NULL;
+    m_bNumTaps=0;
+    m_aTapIdx=NULL;
+    m_aTapVal=NULL;
+    m_aNumTaps=0;
+    m_useCache=true;
+    m_fromCache=false;
+    m_sourceFs=0;
 }
 
 CFileFilter::~CFileFilter() {
-	// TODO Auto-generated destructor stub
+	_deleteCoeffs();
 }
 
 void CFileFilter::open(){
-	m_pFile= fopen(m_path.c_str(),"r");
-	if(m_pFile==NULL)
+	// the sections are read by mapping the file (or its cache), no handle
+	// is kept open
+	FILE* pFile= fopen(m_path.c_str(),"r");
+	if(pFile==NULL)
 		throw CException(CException::SRC_File,-1,"Unable to open file");
+	fclose(pFile);
 }
 void CFileFilter::print() {
 
@@ -56,13 +121,40 @@ void CFileFilter::print() {
 }
 
 void CFileFilter::close(){
-    if(m_a!=NULL&&m_b!=NULL){
-    	delete m_a;   // this NULL hepls in overcoming crashes
-    	m_a=NULL;
-    	delete m_b;
-    	m_a=NULL;
-    }
-	fclose(m_pFile);
+	_deleteCoeffs();
+}
+
+void CFileFilter::_deleteCoeffs(){
+	if (m_a != NULL) {
+		delete[] m_a;   // this NULL hepls in overcoming crashes
+		m_a = NULL;
+	}
+	if (m_b != NULL) {
+		delete[] m_b;
+		m_b = NULL;
+	}
+	if (m_aDbl != NULL) {
+		delete[] m_aDbl;
+		m_aDbl = NULL;
+	}
+	if (m_bDbl != NULL) {
+		delete[] m_bDbl;
+		m_bDbl = NULL;
+	}
+	if (m_bTapIdx != NULL) {
+		delete[] m_bTapIdx;
+		delete[] m_bTapVal;
+		m_bTapIdx = NULL;
+		m_bTapVal = NULL;
+	}
+	if (m_aTapIdx != NULL) {
+		delete[] m_aTapIdx;
+		delete[] m_aTapVal;
+		m_aTapIdx = NULL;
+		m_aTapVal = NULL;
+	}
+	m_bNumTaps = 0;
+	m_aNumTaps = 0;
 }
 long CFileFilter::read(int fs){
     if(!fs)
@@ -70,66 +162,554 @@ long CFileFilter::read(int fs){
 //    	throw CException(CException::SRC_File,-1,"No sampling frequency available");
 
     m_fs=fs;
-    fseek(m_pFile,0,SEEK_SET);
-
-    int sbufSize=360;
-    char sbuf[sbufSize];
-    int end=0,pos=0;
-    fgets(sbuf,sbufSize,m_pFile);
-    string s=sbuf;
-    end=s.find(";",pos);
-    m_type=s.substr(pos,end-pos);
-    pos=end+1;
-    end=s.find(";",pos);
-    string order=s.substr(pos,end-pos);
-    m_order=stoi(order);
-    pos=end+1;
-    m_info=s.substr(pos);
-
-    int fsr=0,i=0;
-    while(NULL!=fgets(sbuf,sbufSize,m_pFile)){
-    	fsr=stoi(sbuf);
-		if (fsr != m_fs) {
-			char *pgot;
-			while (pgot) {                          //skip b coeffecients
-				pgot = fgets(sbuf, sbufSize, m_pFile);
-				if (NULL != strrchr(sbuf, '\n'))
-					break;
-			}
-			while (pgot) {                          //skip a coeffecients
-				pgot = fgets(sbuf, sbufSize, m_pFile);
-				if (NULL != strrchr(sbuf, '\n'))
-					break;
-			}
+    m_sourceFs=0;
+    // the text is only parsed if there is no valid cache (it is rebuilt
+    // then), or if the cache can't be written
+    long pos;
+    m_fromCache=m_useCache;
+    if (m_useCache
+    		&& (_readCache(fs, pos) || (_writeCache() && _readCache(fs, pos))))
+    	return pos;
+    m_fromCache=false;
+
+    CMappedFile text;
+    if(!text.map(m_path))
+    	throw CException(CException::SRC_File,CFileBase::E_CANTREAD,"Unable to map file");
+    const char* pText=(const char*)text.getData();
+    CFILEFILTER_TEXTSECTION* pTable=NULL;
+    pos=0;
+    try{
+    	int numSections=_parseText(pText,text.getSize(),pTable);
+    	for(int i=0;i<numSections;i++){
+    		if(pTable[i].fs!=m_fs)
+    			continue;
+    		_deleteCoeffs();
+    		m_b=new float[m_order+1];
+    		m_a=new float[m_order+1];
+    		m_bDbl=new double[m_order+1];
+    		m_aDbl=new double[m_order+1];
+    		_parseSection(pTable[i],m_bDbl,m_aDbl,blen,alen);
+    		// the coefficients are read with full precision, the float
+    		// coefficients are rounded from them
+    		for(int k=0;k<m_order+1;k++){
+    			m_b[k]=m_bDbl[k];
+    			m_a[k]=m_aDbl[k];
+    		}
+    		_buildTaps();
+    		pos=pTable[i].pEnd-pText;
+    		break;
     	}
-		else{
-			m_b=new float[m_order+1];
-			m_a=new float[m_order+1];
-			char sep;
-			for (i = 0; i < m_order + 1; i++) {
-				if (EOF == fscanf(m_pFile, "%f%c", &m_b[i], &sep))
-					break;
-				if (sep == '\n')
-					break;
-			}
-			blen=i;
-			if(sep!='\n')
-				fscanf(m_pFile,"%c",&sep);
-			for (i = 0; i < m_order + 1; i++) {
-				if (EOF == fscanf(m_pFile, "%f%c", &m_a[i], &sep))
-					break;
-				if (sep == '\n')
-					break;
-			}
-			alen=i;
-			if(sep!='\n')
-				fscanf(m_pFile,"%c",&sep);
-
-		return ftell(m_pFile);
+    }
+    catch(CException& e){
+    	delete[] pTable;
+    	throw;
+    }
+    delete[] pTable;
+    return pos;
+}
+
+/*
+ * end of the line starting at p (line feed or end of the text)
+ */
+static const char* lineEnd(const char* p, const char* pEnd){
+	const char* pLf=(const char*)memchr(p,'\n',pEnd-p);
+	return (pLf!=NULL) ? pLf : pEnd;
+}
+
+int CFileFilter::_parseText(const char* pText, size_t size,
+		CFILEFILTER_TEXTSECTION*& pTable){
+	const char *p=pText, *pEnd=pText+size;
+
+	// header: type;order;info (the info keeps its line feed)
+	const char *pLine=lineEnd(p,pEnd);
+	const char *pSep1=(const char*)memchr(p,';',pLine-p);
+	const char *pSep2=(pSep1!=NULL) ? (const char*)memchr(pSep1+1,';',pLine-pSep1-1) : NULL;
+	int order=0;
+	from_chars_result r;
+	if((pSep2==NULL)
+			|| ((r=from_chars(pSep1+1,pSep2,order)).ec!=errc())
+			|| (r.ptr!=pSep2) || (order<=0))
+		throw CException(CException::SRC_File,-1,"Invalid filter file header");
+	m_type.assign(p,pSep1-p);
+	m_order=order;
+	p=(pLine<pEnd) ? pLine+1 : pEnd;
+	m_info.assign(pSep2+1,p-pSep2-1);
+
+	// section index: fs line, b line, a line (empty lines are skipped)
+	int numSections=0, maxSections=8;
+	pTable=new CFILEFILTER_TEXTSECTION[maxSections];
+	while(p<pEnd){
+		pLine=lineEnd(p,pEnd);
+		const char *q=p;
+		while((q<pLine) && isspace((unsigned char)*q))
+			q++;
+		if(q==pLine){
+			p=(pLine<pEnd) ? pLine+1 : pEnd;
+			continue;
 		}
+		int fs=0;
+		from_chars_result r=from_chars(q,pLine,fs);
+		while((r.ptr<pLine) && isspace((unsigned char)*r.ptr))
+			r.ptr++;
+		if((r.ec!=errc()) || (r.ptr!=pLine) || (fs<=0))
+			throw CException(CException::SRC_File,-1,"Invalid sampling frequency in filter file");
+		if(numSections==maxSections){
+			CFILEFILTER_TEXTSECTION* pOld=pTable;
+			pTable=new CFILEFILTER_TEXTSECTION[2*maxSections];
+			memcpy(pTable,pOld,maxSections*sizeof(*pTable));
+			maxSections*=2;
+			delete[] pOld;
+		}
+		CFILEFILTER_TEXTSECTION& sec=pTable[numSections++];
+		sec.fs=fs;
+		sec.pStart=q;
+		sec.pB=(pLine<pEnd) ? pLine+1 : pEnd;
+		sec.pBEnd=lineEnd(sec.pB,pEnd);
+		sec.pA=(sec.pBEnd<pEnd) ? sec.pBEnd+1 : pEnd;
+		sec.pAEnd=lineEnd(sec.pA,pEnd);
+		sec.pEnd=(sec.pAEnd<pEnd) ? sec.pAEnd+1 : pEnd;
+		p=sec.pEnd;
 	}
-  return 0;
+	return numSections;
+}
 
+void CFileFilter::_parseSection(const CFILEFILTER_TEXTSECTION& section,
+		double* b, double* a, int& bl, int& al){
+	bl=_parseCoeffs(section.pB,section.pBEnd,b);
+	al=_parseCoeffs(section.pA,section.pAEnd,a);
+	if((bl!=m_order+1) || (al!=m_order+1))
+		throw CException(CException::SRC_File,-1,
+				"Number of coefficients does not match the filter order (fs="
+				+to_string(section.fs)+")");
+}
+
+int CFileFilter::_parseCoeffs(const char* p, const char* pEnd, double* c){
+	int n=0;
+	while(p<pEnd){
+		while((p<pEnd) && (isspace((unsigned char)*p) || (*p=='+')))
+			p++;
+		if(p==pEnd)
+			break;		// trailing separator or carriage return
+		if(n>m_order)
+			return n+1;	// too many coefficients
+		from_chars_result r=from_chars(p,pEnd,c[n]);
+		if(r.ec!=errc())
+			throw CException(CException::SRC_File,-1,"Invalid filter coefficient");
+		n++;
+		p=r.ptr;
+		while((p<pEnd) && isspace((unsigned char)*p))
+			p++;
+		if(p==pEnd)
+			break;
+		if(*p!=';')
+			throw CException(CException::SRC_File,-1,"Invalid filter coefficient");
+		p++;
+	}
+	return n;
+}
+
+int CFileFilter::getSections(int* pFs, long* pOffsets, int maxSections) {
+	CMappedFile text;
+	if (!text.map(m_path))
+		throw CException(CException::SRC_File, CFileBase::E_CANTREAD,
+				"Unable to map file");
+	const char *pText = (const char*) text.getData();
+	CFILEFILTER_TEXTSECTION *pTable = NULL;
+	int numSections;
+	try {
+		numSections = _parseText(pText, text.getSize(), pTable);
+	} catch (CException &e) {
+		delete[] pTable;
+		throw;
+	}
+	for (int i = 0; (i < numSections) && (i < maxSections); i++) {
+		pFs[i] = pTable[i].fs;
+		pOffsets[i] = pTable[i].pStart - pText;
+	}
+	delete[] pTable;
+	return numSections;
+}
+
+string CFileFilter::getCachePath() {
+	string path = m_path;
+	size_t dot = path.rfind('.');
+	size_t sep = path.find_last_of("/\\");
+	if ((dot != string::npos) && ((sep == string::npos) || (dot > sep)))
+		path.erase(dot);
+	return path + CACHE_EXTENSION;
+}
+
+bool CFileFilter::isFromCache() {
+	return m_fromCache;
+}
+
+void CFileFilter::setCacheEnabled(bool enable) {
+	m_useCache = enable;
+}
+
+uint64_t CFileFilter::_hash(const uint8_t* data, size_t size) {
+	uint64_t h = 14695981039346656037ULL;		// FNV-1a, 64 bit
+	for (size_t i = 0; i < size; i++) {
+		h ^= data[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+bool CFileFilter::_readCache(int fs, long& pos, bool derived) {
+	int64_t mtime;
+	uint64_t size;
+	if (!CMappedFile::getFileInfo(m_path, mtime, size))
+		return false;
+	CMappedFile cache;
+	if (!cache.map(getCachePath()))
+		return false;
+	const uint8_t *p = cache.getData();
+	size_t n = cache.getSize();
+
+	CFILEFILTER_CACHEHEADER hdr;
+	if (n < sizeof(hdr))
+		return false;
+	memcpy(&hdr, p, sizeof(hdr));
+	if ((hdr.magic != CFILEFILTER_CACHE_MAGIC) || (hdr.version != CACHE_VERSION)
+			|| (hdr.srcSize != size) || (hdr.order <= 0)
+			|| (hdr.numSections < 0))
+		return false;
+	if (hdr.srcMTime != mtime) {
+		// touched or copied: the cache is still valid if the contents are
+		// (the mapped cache is not patched, the hash is checked on every read)
+		CMappedFile text;
+		if (!text.map(m_path) || (text.getSize() != size)
+				|| (_hash(text.getData(), text.getSize()) != hdr.srcHash))
+			return false;
+	}
+
+	// bounds of the table and of the data (corrupt or truncated cache)
+	if ((sizeof(hdr) + (uint64_t) hdr.typeLen + hdr.infoLen > n)
+			|| (hdr.tableOffset > n)
+			|| ((uint64_t) hdr.numSections
+					* sizeof(CFILEFILTER_CACHESECTION) > n - hdr.tableOffset))
+		return false;
+	const CFILEFILTER_CACHESECTION *pTable =
+			(const CFILEFILTER_CACHESECTION*) (p + hdr.tableOffset);
+	for (int i = 0; i < hdr.numSections; i++) {
+		if ((pTable[i].order <= 0) || (pTable[i].dataOffset > n))
+			return false;
+		uint64_t sectionSize = ((uint64_t) pTable[i].order + 1) * 2
+				* (sizeof(double) + sizeof(float));
+		if (sectionSize > n - pTable[i].dataOffset)
+			return false;
+	}
+
+	const char *pStr = (const char*) (p + sizeof(hdr));
+	m_type.assign(pStr, hdr.typeLen);
+	m_info.assign(pStr + hdr.typeLen, hdr.infoLen);
+	m_order = hdr.order;
+
+	pos = 0;
+	for (int i = 0; i < hdr.numSections; i++) {
+		if ((pTable[i].fs != fs) || ((pTable[i].sourceFs != 0) && !derived))
+			continue;
+		_deleteCoeffs();
+		m_order = pTable[i].order;
+		m_sourceFs = pTable[i].sourceFs;
+		int len = m_order + 1;
+		m_bDbl = new double[len];
+		m_aDbl = new double[len];
+		m_b = new float[len];
+		m_a = new float[len];
+		const uint8_t *pData = p + pTable[i].dataOffset;
+		memcpy(m_bDbl, pData, len * sizeof(double));
+		memcpy(m_aDbl, pData + len * sizeof(double), len * sizeof(double));
+		pData += 2 * len * sizeof(double);
+		memcpy(m_b, pData, len * sizeof(float));
+		memcpy(m_a, pData + len * sizeof(float), len * sizeof(float));
+		blen = pTable[i].blen;
+		alen = pTable[i].alen;
+		_buildTaps();
+		pos = (long) pTable[i].textEnd;
+		break;
+	}
+	return true;
+}
+
+bool CFileFilter::_writeCache() {
+	int64_t mtime;
+	uint64_t size;
+	CMappedFile text;
+	if (!CMappedFile::getFileInfo(m_path, mtime, size) || !text.map(m_path))
+		return false;
+	const char *pText = (const char*) text.getData();
+	CFILEFILTER_TEXTSECTION *pSections = NULL;
+	int numSections;
+	try {
+		numSections = _parseText(pText, text.getSize(), pSections);
+	} catch (CException &e) {
+		delete[] pSections;
+		return false;
+	}
+
+	// written to a temporary file and renamed, readers never see a partial cache
+	string path = getCachePath(), tmpPath = path + ".tmp";
+	FILE *pf = fopen(tmpPath.c_str(), "wb");
+	if (pf == NULL) {
+		delete[] pSections;
+		return false;
+	}
+
+	CFILEFILTER_CACHEHEADER hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = CFILEFILTER_CACHE_MAGIC;
+	hdr.version = CACHE_VERSION;
+	hdr.srcMTime = mtime;
+	hdr.srcSize = size;
+	hdr.srcHash = _hash(text.getData(), text.getSize());
+	hdr.order = m_order;
+	hdr.numSections = numSections;
+	hdr.typeLen = m_type.size();
+	hdr.infoLen = m_info.size();
+	static const uint8_t zeros[8] = { 0 };
+	fwrite(&hdr, sizeof(hdr), 1, pf);
+	fwrite(m_type.data(), 1, hdr.typeLen, pf);
+	fwrite(m_info.data(), 1, hdr.infoLen, pf);
+	uint64_t offset = sizeof(hdr) + hdr.typeLen + hdr.infoLen;
+	fwrite(zeros, 1, CFILEFILTER_CACHE_ALIGN(offset) - offset, pf);
+	offset = CFILEFILTER_CACHE_ALIGN(offset);
+
+	// data of the sections in the order of the text, the table follows; a
+	// malformed section discards the cache (read() reports it if requested)
+	int len = m_order + 1;
+	CFILEFILTER_CACHESECTION *pTable = new CFILEFILTER_CACHESECTION[numSections];
+	double *bDbl = new double[len], *aDbl = new double[len];
+	float *bFlt = new float[len], *aFlt = new float[len];
+	bool ok = true;
+	for (int k = 0; ok && (k < numSections); k++) {
+		CFILEFILTER_CACHESECTION &sec = pTable[k];
+		memset(&sec, 0, sizeof(sec));
+		sec.fs = pSections[k].fs;
+		int bl, al;
+		try {
+			_parseSection(pSections[k], bDbl, aDbl, bl, al);
+		} catch (CException &e) {
+			ok = false;
+			break;
+		}
+		sec.blen = bl;
+		sec.alen = al;
+		sec.order = m_order;
+		sec.dataOffset = offset;
+		sec.textEnd = pSections[k].pEnd - pText;
+		for (int i = 0; i < len; i++) {
+			bFlt[i] = bDbl[i];
+			aFlt[i] = aDbl[i];
+		}
+		ok = (fwrite(bDbl, sizeof(double), len, pf) == (size_t) len)
+				&& (fwrite(aDbl, sizeof(double), len, pf) == (size_t) len)
+				&& (fwrite(bFlt, sizeof(float), len, pf) == (size_t) len)
+				&& (fwrite(aFlt, sizeof(float), len, pf) == (size_t) len);
+		offset += 2 * len * (sizeof(double) + sizeof(float));	// multiple of 8
+	}
+	hdr.tableOffset = offset;
+	ok = ok
+			&& (fwrite(pTable, sizeof(*pTable), numSections, pf)
+					== (size_t) numSections);
+	ok = ok && (fseek(pf, 0, SEEK_SET) == 0)
+			&& (fwrite(&hdr, sizeof(hdr), 1, pf) == 1);
+	ok = (fclose(pf) == 0) && ok;
+	delete[] pSections;
+	delete[] pTable;
+	delete[] bDbl;
+	delete[] aDbl;
+	delete[] bFlt;
+	delete[] aFlt;
+
+	if (ok) {
+		::remove(path.c_str());		// rename() does not replace files on Windows
+		ok = (::rename(tmpPath.c_str(), path.c_str()) == 0);
+	}
+	if (!ok)
+		::remove(tmpPath.c_str());
+	return ok;
+}
+
+long CFileFilter::readDerived(int fs){
+	long pos=read(fs);
+	if(pos || !fs)
+		return pos;
+
+	// derived before (cache)
+	if(m_useCache && _readCache(fs,pos,true) && pos){
+		m_fromCache=true;
+		return pos;
+	}
+
+	// nearest stored sampling frequency (ratio closest to 1)
+	int sfs[MAX_DERIVATION_SECTIONS];
+	long offsets[MAX_DERIVATION_SECTIONS];
+	int num=getSections(sfs,offsets,MAX_DERIVATION_SECTIONS);
+	if(num>MAX_DERIVATION_SECTIONS)
+		num=MAX_DERIVATION_SECTIONS;
+	int fsFrom=0;
+	for(int i=0;i<num;i++)
+		if(!fsFrom || (fabs(log((double)sfs[i]/fs))<fabs(log((double)fsFrom/fs))))
+			fsFrom=sfs[i];
+	if(!fsFrom)
+		return 0;
+	if(!isDerivationSource(fsFrom)){
+		_deleteCoeffs();
+		m_fs=fs;
+		return 0;
+	}
+	if(!(pos=read(fsFrom)))
+		return 0;
+	bool fromCache=m_fromCache;
+
+	double *b=NULL, *a=NULL;
+	int order=m_order;
+	if(isSparse()){
+		// delay lines: the delay times are kept
+		order=CFilterDerivation::scaleTaps(m_bDbl,m_aDbl,m_order,fsFrom,fs,b,a);
+	}
+	else if(m_order<=CFilterDerivation::MAX_REWARP_ORDER){
+		// the response at the cutoff frequency is kept
+		CFilterAnalyzer analyzer(64);
+		double fc=analyzer.analyze(m_path,fsFrom,m_aDbl,m_bDbl,m_order)->cutoff;
+		b=new double[m_order+1];
+		a=new double[m_order+1];
+		if(!CFilterDerivation::rewarp(m_bDbl,m_aDbl,m_order,fsFrom,fs,fc,b,a)){
+			delete[] b;
+			delete[] a;
+			b=a=NULL;
+		}
+	}
+	if(b==NULL){
+		_deleteCoeffs();
+		m_fs=fs;
+		return 0;
+	}
+
+	_deleteCoeffs();
+	m_fs=fs;
+	m_sourceFs=fsFrom;
+	m_order=order;
+	m_bDbl=b;
+	m_aDbl=a;
+	m_b=new float[m_order+1];
+	m_a=new float[m_order+1];
+	for(int k=0;k<m_order+1;k++){
+		m_b[k]=m_bDbl[k];
+		m_a[k]=m_aDbl[k];
+	}
+	blen=alen=m_order+1;
+	_buildTaps();
+	// the cache of the file (if valid) keeps the derived coefficients
+	m_fromCache=false;
+	if(m_useCache && fromCache)
+		_appendCache(pos);
+	return pos;
+}
+
+bool CFileFilter::isDerivationSource(int fs){
+	if(!read(fs))
+		return false;
+	if(isSparse())
+		return true;
+	int sfs[MAX_DERIVATION_SECTIONS];
+	long offsets[MAX_DERIVATION_SECTIONS];
+	int num=getSections(sfs,offsets,MAX_DERIVATION_SECTIONS);
+	if(num>MAX_DERIVATION_SECTIONS)
+		num=MAX_DERIVATION_SECTIONS;
+	return _isRewarpable(fs,sfs,num);
+}
+
+bool CFileFilter::_isRewarpable(int fsFrom, const int *sfs, int num){
+	if(m_order>CFilterDerivation::MAX_REWARP_ORDER)
+		return false;
+	// the stored section next to the source is the reference
+	int fsRef=0;
+	for(int i=0;i<num;i++)
+		if((sfs[i]!=fsFrom) && (!fsRef
+				|| (fabs(log((double)sfs[i]/fsFrom))<fabs(log((double)fsRef/fsFrom)))))
+			fsRef=sfs[i];
+	if(!fsRef)
+		return true;	// a single section: nothing to compare with
+
+	int order=m_order;
+	double *b=new double[2*(order+1)], *a=b+order+1;
+	memcpy(b,m_bDbl,(order+1)*sizeof(double));
+	memcpy(a,m_aDbl,(order+1)*sizeof(double));
+	CFilterAnalyzer analyzer(64);
+	double fc=analyzer.analyze(m_path,fsFrom,a,b,order)->cutoff;
+	bool ok=read(fsRef) && !isSparse() && (m_order==order)
+			&& (CFilterDerivation::rewarpDeviation(b,a,order,fsFrom,m_bDbl,
+					m_aDbl,fsRef,fc)<=CFilterDerivation::MAX_REWARP_DEVIATION_DB);
+	delete[] b;
+	return ok;
+}
+
+bool CFileFilter::isDerived() {
+	return (m_sourceFs != 0);
+}
+
+int CFileFilter::getSourceFs() {
+	return m_sourceFs;
+}
+
+bool CFileFilter::_appendCache(long textEnd) {
+	CMappedFile cache;
+	if (!cache.map(getCachePath()))
+		return false;
+	const uint8_t *p = cache.getData();
+	size_t n = cache.getSize();
+	CFILEFILTER_CACHEHEADER hdr;
+	if (n < sizeof(hdr))
+		return false;
+	memcpy(&hdr, p, sizeof(hdr));
+	if ((hdr.magic != CFILEFILTER_CACHE_MAGIC) || (hdr.version != CACHE_VERSION)
+			|| (hdr.tableOffset > n)
+			|| ((uint64_t) hdr.numSections * sizeof(CFILEFILTER_CACHESECTION)
+					!= n - hdr.tableOffset))
+		return false;
+
+	// the data of the stored sections keep their offsets, the new data and
+	// the extended table follow
+	CFILEFILTER_CACHESECTION sec;
+	memset(&sec, 0, sizeof(sec));
+	sec.fs = m_fs;
+	sec.blen = blen;
+	sec.alen = alen;
+	sec.order = m_order;
+	sec.sourceFs = m_sourceFs;
+	sec.dataOffset = hdr.tableOffset;
+	sec.textEnd = textEnd;
+	int len = m_order + 1;
+	uint64_t tableOffset = hdr.tableOffset;
+	hdr.tableOffset += 2 * len * (sizeof(double) + sizeof(float));
+	hdr.numSections++;
+
+	string path = getCachePath(), tmpPath = path + ".tmp";
+	FILE *pf = fopen(tmpPath.c_str(), "wb");
+	if (pf == NULL)
+		return false;
+	bool ok = (fwrite(&hdr, sizeof(hdr), 1, pf) == 1)
+			&& (fwrite(p + sizeof(hdr), 1, tableOffset - sizeof(hdr), pf)
+					== tableOffset - sizeof(hdr))
+			&& (fwrite(m_bDbl, sizeof(double), len, pf) == (size_t) len)
+			&& (fwrite(m_aDbl, sizeof(double), len, pf) == (size_t) len)
+			&& (fwrite(m_b, sizeof(float), len, pf) == (size_t) len)
+			&& (fwrite(m_a, sizeof(float), len, pf) == (size_t) len)
+			&& (fwrite(p + tableOffset, 1, n - tableOffset, pf)
+					== n - tableOffset)
+			&& (fwrite(&sec, sizeof(sec), 1, pf) == 1);
+	ok = (fclose(pf) == 0) && ok;
+	cache.unmap();
+	if (ok) {
+		::remove(path.c_str());		// rename() does not replace files on Windows
+		ok = (::rename(tmpPath.c_str(), path.c_str()) == 0);
+	}
+	if (!ok)
+		::remove(tmpPath.c_str());
+	return ok;
 }
 
 float* CFileFilter::getACoeffs(){
@@ -145,6 +725,19 @@ float* CFileFilter::getBCoeffs(){
 	return m_b;
 }
 
+double* CFileFilter::getACoeffsDouble(){
+	if(m_aDbl==NULL)
+		throw CException(CException::SRC_File,-1,"NO a filter coeffectients avilable ");
+
+	return m_aDbl;
+}
+double* CFileFilter::getBCoeffsDouble(){
+	if(m_bDbl==NULL)
+		throw CException(CException::SRC_File,-1,"NO b filter coeffectients avilable ");
+
+	return m_bDbl;
+}
+
 string CFileFilter::getFilterInfo(){
 	if(m_info=="")
 			throw CException(CException::SRC_File,-1,"Filter info not avilable, please open file ");
@@ -187,3 +780,61 @@ int CFileFilter::getSamplingFreq(){
 string CFileFilter::getFilepath() {
 	return m_path;
 }
+
+void CFileFilter::_buildTaps() {
+	if (m_order < SPARSE_MIN_ORDER)
+		return;
+
+	int nb = 0, na = 0;
+	for (int i = 0; i <= m_order; i++) {
+		if (m_b[i] != 0.)
+			nb++;
+		if (m_a[i] != 0.)
+			na++;
+	}
+	if ((na + nb) * SPARSE_MIN_RATIO > 2 * (m_order + 1))
+		return;		// dense filter
+
+	m_bTapIdx = new uint32_t[nb];
+	m_bTapVal = new float[nb];
+	m_aTapIdx = new uint32_t[na];
+	m_aTapVal = new float[na];
+	for (int i = 0; i <= m_order; i++) {
+		if (m_b[i] != 0.) {
+			m_bTapIdx[m_bNumTaps] = i;
+			m_bTapVal[m_bNumTaps++] = m_b[i];
+		}
+		if (m_a[i] != 0.) {
+			m_aTapIdx[m_aNumTaps] = i;
+			m_aTapVal[m_aNumTaps++] = m_a[i];
+		}
+	}
+}
+
+bool CFileFilter::isSparse() {
+	return (m_bTapIdx != NULL);
+}
+
+int CFileFilter::getNumBTaps() {
+	return m_bNumTaps;
+}
+
+uint32_t* CFileFilter::getBTapIndices() {
+	return m_bTapIdx;
+}
+
+float* CFileFilter::getBTapValues() {
+	return m_bTapVal;
+}
+
+int CFileFilter::getNumATaps() {
+	return m_aNumTaps;
+}
+
+uint32_t* CFileFilter::getATapIndices() {
+	return m_aTapIdx;
+}
+
+float* CFileFilter::getATapValues() {
+	return m_aTapVal;
+}
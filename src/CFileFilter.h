@@ -8,29 +8,90 @@
 #ifndef CFILEFILTER_H_
 #define CFILEFILTER_H_
 #include "CFileBase.h"
+#include "CMappedFile.h"
+
+struct CFILEFILTER_TEXTSECTION;
 /*
  *
  */
 class CFileFilter: public CFileBase {
 private:
-	 FILE* m_pFile;
-
 	 string m_type;
 	 int m_order;
 	 string m_info;
      int m_fs;
      float* m_a;
      float* m_b;
+     /*
+      * coefficients as read from the file (m_a and m_b are rounded from them)
+      */
+     double* m_aDbl;
+     double* m_bDbl;
      int blen;
      int alen;
+     /*
+      * compact tap lists (index, value) of the non-zero coefficients, only
+      * built for sparse filters (see isSparse())
+      */
+     uint32_t* m_bTapIdx;
+     float* m_bTapVal;
+     int m_bNumTaps;
+     uint32_t* m_aTapIdx;
+     float* m_aTapVal;
+     int m_aNumTaps;
 
 public:
+	/*
+	 * a filter is sparse if its order is at least SPARSE_MIN_ORDER and at most
+	 * every SPARSE_MIN_RATIO-th coefficient (a and b) is non-zero
+	 */
+	static const int SPARSE_MIN_ORDER = 16;
+	static const int SPARSE_MIN_RATIO = 8;
+	/*
+	 * binary coefficient cache: all sections of the text file are stored in
+	 * <name>.fltc next to the text file (header, section table per sampling
+	 * frequency, raw double and float arrays), the cache is memory mapped by
+	 * read() and rebuilt if the text file changed (size and modification
+	 * time, or contents hash if only the time changed)
+	 */
+	static const char* CACHE_EXTENSION;
+	static const uint32_t CACHE_VERSION = 4;
+	/*
+	 * maximum number of sections considered by readDerived()
+	 */
+	static const int MAX_DERIVATION_SECTIONS = 32;
+
 	CFileFilter(const string path, const string mode="r");
 	virtual ~CFileFilter();
 
 	void open();
 	void close();
 	long read(int fs);
+	/*
+	 * like read(), but coefficients for a sampling frequency the file does
+	 * not contain are derived from the section with the nearest sampling
+	 * frequency (see CFilterDerivation: re-warping of recursive and short
+	 * filters, scaled delay lines for sparse filters) and kept in the cache;
+	 * recursive filters are re-warped only if re-warping the source section
+	 * reproduces the stored section next to it (bilinear designs, see
+	 * CFilterDerivation::rewarpDeviation()); returns the position after the
+	 * source section or 0 if the file has no sections or the coefficients
+	 * can't be derived (long dense filters, other designs)
+	 */
+	long readDerived(int fs);
+	/*
+	 * true if readDerived() derives coefficients for other sampling
+	 * frequencies from the section for fs (sparse filters, recursive and
+	 * short filters whose re-warping reproduces the stored section next to
+	 * it); the coefficients are to be read again afterwards
+	 */
+	bool isDerivationSource(int fs);
+	/*
+	 * true if the coefficients have been derived, getSourceFs() gets the
+	 * sampling frequency of the section they have been derived from
+	 */
+	bool isDerived();
+	int getSourceFs();
 	void print(); //filter file contents printed together with file base print
 	string getFilterType();
 	int getOrder();
@@ -38,10 +99,84 @@ public:
 	int getSamplingFreq();
 	float* getACoeffs();
 	float* getBCoeffs();
+	/*
+	 * coefficients with full precision (for filters with double precision)
+	 */
+	double* getACoeffsDouble();
+	double* getBCoeffsDouble();
 	int getAlen();
 	int getBlen();
 	string getFilepath();
+	/*
+	 * path of the binary coefficient cache of the filter file
+	 */
+	string getCachePath();
+	/*
+	 * sections of the text file without reading coefficients: sampling
+	 * frequencies and positions of the sections (fs line), also sets type,
+	 * order and info, returns the number of sections (at most maxSections
+	 * are stored)
+	 */
+	int getSections(int* pFs, long* pOffsets, int maxSections);
+	/*
+	 * true if the last read() took the coefficients from the cache
+	 */
+	bool isFromCache();
+	/*
+	 * enables/disables the cache (enabled by default), read() parses the
+	 * text file if disabled
+	 */
+	void setCacheEnabled(bool enable);
+
+	/*
+	 * sparse filters (e.g. delay lines): after read() the non-zero
+	 * coefficients are available as tap lists (index, value), the tap
+	 * lists are empty for dense filters
+	 */
+	bool isSparse();
+	int getNumBTaps();
+	uint32_t* getBTapIndices();
+	float* getBTapValues();
+	int getNumATaps();
+	uint32_t* getATapIndices();
+	float* getATapValues();
+
+private:
+	void _buildTaps();
+	void _deleteCoeffs();
+	/*
+	 * text format: header line (type;order;info), then a section per
+	 * sampling frequency (fs line, b line, a line, coefficients separated by
+	 * ';'), parsed in one pass over the mapped file, _parseText() returns the
+	 * number of sections and the section index (to be deleted by the caller)
+	 */
+	int _parseText(const char* pText, size_t size,
+			CFILEFILTER_TEXTSECTION*& pTable);
+	void _parseSection(const CFILEFILTER_TEXTSECTION& section, double* b,
+			double* a, int& bl, int& al);
+	int _parseCoeffs(const char* p, const char* pEnd, double* c);
+	/*
+	 * checks if the current (source) section and the stored section with the
+	 * nearest other sampling frequency are bilinear images of each other
+	 * (loads the coefficients of that section)
+	 */
+	bool _isRewarpable(int fsFrom, const int *sfs, int num);
+	/*
+	 * cache: _readCache() returns false if the cache is missing or outdated,
+	 * otherwise pos is the position after the section in the text file (0 if
+	 * fs is not available), _writeCache() parses all sections of the text
+	 */
+	bool _readCache(int fs, long& pos, bool derived = false);
+	bool _writeCache();
+	/*
+	 * appends the current (derived) coefficients to the cache
+	 */
+	bool _appendCache(long textEnd);
+	static uint64_t _hash(const uint8_t* data, size_t size);
 
+	bool m_useCache;
+	bool m_fromCache;
+	int m_sourceFs;
 
 
 };
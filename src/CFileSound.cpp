@@ -20,11 +20,26 @@ CFileSound::CFileSound(string path, const string mode) :
 		CFileBase(path, mode) {
 	memset(&m_sfinfo, 0, sizeof(m_sfinfo));
 	m_pSFile = NULL;
+	m_ioBuf = NULL;
+	m_ioBufSize = 0;
+	m_pMapped = NULL;
+	m_useMapping = true;
+	m_pCached = NULL;
+	m_useCache = false;
+	m_pcmBuf = NULL;
+	m_pcmBufSize = 0;
+	m_useDither = false;
+	CPcmConvert::initDither(m_dither);
+	m_pos = 0;
 //	cout << "CFileSound@" << hex << this << dec << " created" << endl;
 }
 
 CFileSound::~CFileSound() {
 	close();
+	if (m_ioBuf)
+		delete[] m_ioBuf;
+	if (m_pcmBuf)
+		delete[] m_pcmBuf;
 //	cout << "CFileSound@" << hex << this << dec << " destroyed" << endl;
 }
 
@@ -32,7 +47,7 @@ CFileSound::~CFileSound() {
  * overloaded method from CFileBase
  */
 void CFileSound::print(void) {
-	if (m_pSFile != 0) {
+	if ((m_pSFile != 0) || m_pMapped || m_pCached) {
 		CFileBase::print();
 		cout << "CFileSound@" << hex << this << dec << endl;
 		cout << " Soundfile: channels(" << m_sfinfo.channels << ") frames("
@@ -57,6 +72,36 @@ void CFileSound::open() {
 		throw CException(this, typeid(this).name(), __FUNCTION__,
 				E_UNKNOWNOPENMODE, getErrorTxt(E_UNKNOWNOPENMODE));
 
+	if ((sf_mode == SFM_READ) && m_useCache) {
+		// decoded once, read from memory
+		m_pCached = CSoundCache::getShared()->acquire(m_path);
+		if (m_pCached) {
+			m_sfinfo.frames = m_pCached->numFrames;
+			m_sfinfo.samplerate = m_pCached->sampleRate;
+			m_sfinfo.channels = m_pCached->channels;
+			m_sfinfo.format = m_pCached->format;
+			m_sfinfo.sections = 1;
+			m_sfinfo.seekable = 1;
+			m_pos = 0;
+			return;
+		}
+	}
+	if ((sf_mode == SFM_READ) && m_useMapping) {
+		// uncompressed WAV: the samples are taken from the mapping
+		m_pMapped = new CFileSoundMapped;
+		if (m_pMapped->open(m_path)) {
+			m_sfinfo.frames = m_pMapped->getNumFrames();
+			m_sfinfo.samplerate = m_pMapped->getSampleRate();
+			m_sfinfo.channels = m_pMapped->getNumChannels();
+			m_sfinfo.format = m_pMapped->getSfFormat();
+			m_sfinfo.sections = 1;
+			m_sfinfo.seekable = 1;
+			return;
+		}
+		delete m_pMapped;
+		m_pMapped = NULL;
+	}
+	m_pos = 0;
 	m_pSFile = sf_open(m_path.c_str(), sf_mode, &m_sfinfo);
 	if (!m_pSFile)
 		throw CException(this, typeid(this).name(), __FUNCTION__,
@@ -67,6 +112,14 @@ void CFileSound::open() {
 }
 
 void CFileSound::close() {
+	if (m_pCached != NULL) {
+		CSoundCache::getShared()->release(m_pCached);
+		m_pCached = NULL;
+	}
+	if (m_pMapped != NULL) {
+		delete m_pMapped;
+		m_pMapped = NULL;
+	}
 	if (m_pSFile != NULL) {
 		sf_close(m_pSFile);
 		m_pSFile = NULL;
@@ -76,18 +129,59 @@ void CFileSound::close() {
 }
 
 uint64_t CFileSound::read(float *buf, uint64_t frameNum) {
-	if (m_pSFile == NULL)
+	if ((m_pSFile == NULL) && (m_pMapped == NULL) && (m_pCached == NULL))
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_FILENOTOPEN,
 				getErrorTxt(E_FILENOTOPEN));
 	if (buf == NULL)
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_NOBUFFER,
 				getErrorTxt(E_NOBUFFER));
+	if (m_pCached) {
+		if (frameNum > m_pCached->numFrames - m_pos)
+			frameNum = m_pCached->numFrames - m_pos;
+		memcpy(buf, m_pCached->samples + m_pos * m_pCached->channels,
+				frameNum * m_pCached->channels * sizeof(float));
+		m_pos += frameNum;
+		return frameNum;
+	}
 	if (isFileW() || isFileWA())
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_CANTREAD,
 				getErrorTxt(E_CANTREAD));
 
-	uint64_t szread = sf_readf_float(m_pSFile, buf, frameNum);
-	// returns 0 if no data left to read
+	if (m_pMapped)
+		return m_pMapped->read(buf, frameNum);
+	int subtype = m_sfinfo.format & SF_FORMAT_SUBMASK;
+	if ((subtype != SF_FORMAT_PCM_S8) && (subtype != SF_FORMAT_PCM_U8)
+			&& (subtype != SF_FORMAT_PCM_16) && (subtype != SF_FORMAT_PCM_24)
+			&& (subtype != SF_FORMAT_PCM_32)) {
+		uint64_t szread = sf_readf_float(m_pSFile, buf, frameNum);
+		m_pos += szread;
+		// returns 0 if no data left to read
+		return szread;
+	}
+
+	// PCM: integers from libsndfile, converted by our kernels
+	int32_t *pcm = _getPcmBuffer();
+	uint64_t szread = 0;
+	while (szread < frameNum) {
+		uint64_t frames = frameNum - szread;
+		if (frames > PCM_CHUNK_FRAMES)
+			frames = PCM_CHUNK_FRAMES;
+		float *out = buf + szread * m_sfinfo.channels;
+		uint64_t n;
+		if (subtype == SF_FORMAT_PCM_16) {
+			n = sf_readf_short(m_pSFile, (short*) pcm, frames);
+			CPcmConvert::int16ToFloat((int16_t*) pcm, out,
+					n * m_sfinfo.channels);
+		} else {
+			// the samples are in the upper bits
+			n = sf_readf_int(m_pSFile, pcm, frames);
+			CPcmConvert::int32ToFloat(pcm, out, n * m_sfinfo.channels);
+		}
+		szread += n;
+		if (n < frames)
+			break;
+	}
+	m_pos += szread;
 	return szread;
 }
 
@@ -102,7 +196,35 @@ uint64_t CFileSound::write(float *buf, uint64_t frameNum) {
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_CANTWRITE,
 				getErrorTxt(E_CANTWRITE));
 
-	uint64_t szwrite = sf_writef_float(m_pSFile, buf, frameNum);
+	int subtype = m_sfinfo.format & SF_FORMAT_SUBMASK;
+	uint64_t szwrite = 0;
+	if ((subtype == SF_FORMAT_PCM_16) || (subtype == SF_FORMAT_PCM_24)
+			|| (subtype == SF_FORMAT_PCM_32)) {
+		// PCM: quantized (and dithered) by our kernels, integers to libsndfile
+		int32_t *pcm = _getPcmBuffer();
+		CPcmConvert::DITHER *pDither = m_useDither ? &m_dither : NULL;
+		while (szwrite < frameNum) {
+			uint64_t frames = frameNum - szwrite;
+			if (frames > PCM_CHUNK_FRAMES)
+				frames = PCM_CHUNK_FRAMES;
+			const float *in = buf + szwrite * m_sfinfo.channels;
+			uint64_t n;
+			if (subtype == SF_FORMAT_PCM_16) {
+				CPcmConvert::floatToInt16(in, (int16_t*) pcm,
+						frames * m_sfinfo.channels, pDither);
+				n = sf_writef_short(m_pSFile, (short*) pcm, frames);
+			} else {
+				CPcmConvert::floatToInt32(in, pcm, frames * m_sfinfo.channels,
+						(subtype == SF_FORMAT_PCM_24) ? 24 : 32, pDither);
+				n = sf_writef_int(m_pSFile, pcm, frames);
+			}
+			szwrite += n;
+			if (n < frames)
+				break;
+		}
+	} else
+		szwrite = sf_writef_float(m_pSFile, buf, frameNum);
+	m_pos += szwrite;
 	if (szwrite != frameNum) {
 		close();
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_WRITE,
@@ -111,12 +233,204 @@ uint64_t CFileSound::write(float *buf, uint64_t frameNum) {
 	return szwrite;
 }
 
+float* CFileSound::_getIOBuffer(CAudioBlock &block) {
+	if (block.getNumChannels() != m_sfinfo.channels)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Block and sound file have different numbers of channels!");
+	// libsndfile works on interleaved frames only
+	uint32_t size = block.getMaxFrames() * block.getNumChannels();
+	if (size > m_ioBufSize) {
+		if (m_ioBuf)
+			delete[] m_ioBuf;
+		m_ioBuf = new float[size];
+		m_ioBufSize = size;
+	}
+	return m_ioBuf;
+}
+
+int32_t* CFileSound::_getPcmBuffer() {
+	uint32_t size = PCM_CHUNK_FRAMES * m_sfinfo.channels;
+	if (size > m_pcmBufSize) {
+		if (m_pcmBuf)
+			delete[] m_pcmBuf;
+		m_pcmBuf = new int32_t[size];
+		m_pcmBufSize = size;
+	}
+	return m_pcmBuf;
+}
+
+uint64_t CFileSound::read(CAudioBlock &block) {
+	if (m_pCached) {
+		// split directly from the cached sound (no copy into m_ioBuf)
+		if (block.getNumChannels() != m_sfinfo.channels)
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Block and sound file have different numbers of channels!");
+		uint64_t frames = m_pCached->numFrames - m_pos;
+		if (frames > block.getMaxFrames())
+			frames = block.getMaxFrames();
+		block.deinterleave(m_pCached->samples + m_pos * m_pCached->channels,
+				(uint16_t) frames);
+		block.setSampleRate(m_sfinfo.samplerate);
+		m_pos += frames;
+		return frames;
+	}
+	if (m_pMapped) {
+		// converted directly into the planes (no libsndfile buffer)
+		if (block.getNumChannels() != m_sfinfo.channels)
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Block and sound file have different numbers of channels!");
+		return m_pMapped->read(block);
+	}
+	float *buf = _getIOBuffer(block);
+	uint64_t szread = read(buf, block.getMaxFrames());
+	block.deinterleave(buf, (uint16_t) szread);
+	block.setSampleRate(m_sfinfo.samplerate);
+	return szread;
+}
+
+uint64_t CFileSound::write(CAudioBlock &block) {
+	float *buf = _getIOBuffer(block);
+	block.interleave(buf);
+	return write(buf, block.getNumFrames());
+}
+
 void CFileSound::rewind() {
+	if (m_pCached) {
+		m_pos = 0;
+		return;
+	}
+	if (m_pMapped) {
+		m_pMapped->rewind();
+		return;
+	}
 	if (m_pSFile == NULL)
 		throw CException(this, typeid(this).name(), __FUNCTION__, E_FILENOTOPEN,
 				getErrorTxt(E_FILENOTOPEN));
 
 	sf_seek(m_pSFile, 0, SEEK_SET);
+	m_pos = 0;
+}
+
+void CFileSound::seek(uint64_t frame) {
+	if (m_pCached) {
+		m_pos = frame < m_pCached->numFrames ? frame : m_pCached->numFrames;
+		return;
+	}
+	if (m_pMapped) {
+		m_pMapped->seek(frame);
+		return;
+	}
+	if (m_pSFile == NULL)
+		throw CException(this, typeid(this).name(), __FUNCTION__, E_FILENOTOPEN,
+				getErrorTxt(E_FILENOTOPEN));
+
+	if (frame > (uint64_t) m_sfinfo.frames)
+		frame = m_sfinfo.frames;
+	if (frame == m_pos)
+		return;
+	// a compressed format restarts the decoder at a sync point before the
+	// frame, a short distance ahead is decoded faster from here
+	if (!_isSeekFast() && (frame > m_pos)
+			&& (frame - m_pos <= SEEK_DECODE_FRAMES) && isFileR()
+			&& !isFileW() && !isFileWA()) {
+		_skip(frame - m_pos);
+		return;
+	}
+	if (m_sfinfo.seekable
+			&& (sf_seek(m_pSFile, frame, SEEK_SET) == (sf_count_t) frame)) {
+		m_pos = frame;
+		return;
+	}
+
+	// not seekable by libsndfile: decoded from here or from the start
+	if (!isFileR() || isFileW() || isFileWA())
+		throw CException(this, typeid(this).name(), __FUNCTION__, E_READ,
+				m_path + ": " + sf_strerror(m_pSFile));
+	if (frame < m_pos) {
+		sf_close(m_pSFile);
+		m_sfinfo.format = 0;
+		m_pos = 0;
+		m_pSFile = sf_open(m_path.c_str(), SFM_READ, &m_sfinfo);
+		if (!m_pSFile)
+			throw CException(this, typeid(this).name(), __FUNCTION__,
+					sf_error(m_pSFile), m_path + ": " + sf_strerror(m_pSFile));
+	}
+	_skip(frame - m_pos);
+}
+
+uint64_t CFileSound::tell() {
+	if (m_pMapped)
+		return m_pMapped->tell();
+	return m_pos;
+}
+
+uint64_t CFileSound::readAt(uint64_t frame, float *buf, uint64_t frameNum) {
+	seek(frame);
+	return read(buf, frameNum);
+}
+
+bool CFileSound::_isSeekFast() {
+	switch (m_sfinfo.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+	case SF_FORMAT_PCM_16:
+	case SF_FORMAT_PCM_24:
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
+	case SF_FORMAT_DOUBLE:
+	case SF_FORMAT_ULAW:
+	case SF_FORMAT_ALAW:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void CFileSound::_skip(uint64_t frames) {
+	float *buf = new float[PCM_CHUNK_FRAMES * m_sfinfo.channels];
+	while (frames > 0) {
+		uint64_t n = read(buf,
+				frames < PCM_CHUNK_FRAMES ? frames : PCM_CHUNK_FRAMES);
+		if (n == 0)
+			break;
+		frames -= n;
+	}
+	delete[] buf;
+}
+
+const float* CFileSound::getView(uint64_t frameNum, uint64_t &frames) {
+	frames = 0;
+	if (m_pCached) {
+		frames = m_pCached->numFrames - m_pos;
+		if (frames > frameNum)
+			frames = frameNum;
+		const float *pView = m_pCached->samples + m_pos * m_pCached->channels;
+		m_pos += frames;
+		return pView;
+	}
+	if (m_pMapped == NULL)
+		return NULL;
+	return m_pMapped->getView(frameNum, frames);
+}
+
+bool CFileSound::isMapped() {
+	return m_pMapped != NULL;
+}
+
+void CFileSound::setMappingEnabled(bool enable) {
+	m_useMapping = enable;
+}
+
+bool CFileSound::isCached() {
+	return m_pCached != NULL;
+}
+
+void CFileSound::setCacheEnabled(bool enable) {
+	m_useCache = enable;
+}
+
+void CFileSound::setDither(bool enable) {
+	m_useDither = enable;
 }
 
 uint64_t CFileSound::getNumFrames() {
@@ -13,6 +13,10 @@
 
 #include "sndfile.h"
 #include "CFileBase.h"
+#include "CAudioBlock.h"
+#include "CFileSoundMapped.h"
+#include "CPcmConvert.h"
+#include "CSoundCache.h"
 #include <string>
 using namespace std;
 
@@ -23,12 +27,31 @@ using namespace std;
  *
  * collects metadata from soundfile into SF_INFO structure
  *
- * uses libsndfile library
+ * uses libsndfile library, uncompressed WAV files opened for reading are
+ * read from a memory mapping instead (CFileSoundMapped); with the cache
+ * enabled, files opened for reading are decoded once and read from the
+ * memory of the shared CSoundCache
+ *
+ * PCM samples are exchanged with libsndfile as integers, the conversion
+ * to/from float is done by the vectorized kernels of CPcmConvert (16/24/32
+ * bit files are written with optional TPDF dither, float -> PCM -> float is
+ * exact)
  *
  * \see
  * http://mega-nerd.com/libsndfile/api.html
  */
 class CFileSound: public CFileBase {
+public:
+	/**
+	 * \brief frames exchanged with libsndfile as integers per call
+	 */
+	static const uint32_t PCM_CHUNK_FRAMES = 4096;
+	/**
+	 * \brief compressed formats: forward seeks up to this distance decode
+	 * and drop the frames (the decoder continues, no restart at a sync point)
+	 */
+	static const uint32_t SEEK_DECODE_FRAMES = 48000;
+
 private:
 	/**
 	 * \brief pointer on soundfile handler
@@ -46,6 +69,48 @@ private:
 	 * - seekable
 	 */
 	SF_INFO m_sfinfo;
+	/**
+	 * \brief interleaved buffer for reading/writing planar blocks
+	 */
+	float *m_ioBuf;
+	/**
+	 * \brief size of m_ioBuf (samples)
+	 */
+	uint32_t m_ioBufSize;
+	/**
+	 * \brief mapped WAV file (NULL if the file is read by libsndfile)
+	 */
+	CFileSoundMapped *m_pMapped;
+	/**
+	 * \brief open() tries to map the file
+	 */
+	bool m_useMapping;
+	/**
+	 * \brief decoded sound of the shared cache (NULL if the file is read)
+	 */
+	const CSoundCache::SOUND *m_pCached;
+	/**
+	 * \brief open() takes the sound from the shared cache
+	 */
+	bool m_useCache;
+	/**
+	 * \brief integer samples exchanged with libsndfile (PCM_CHUNK_FRAMES frames)
+	 */
+	int32_t *m_pcmBuf;
+	/**
+	 * \brief size of m_pcmBuf (samples)
+	 */
+	uint32_t m_pcmBufSize;
+	/**
+	 * \brief write() dithers PCM samples, state of the dither
+	 */
+	bool m_useDither;
+	CPcmConvert::DITHER m_dither;
+	/**
+	 * \brief next frame to be read/written by libsndfile or read from the
+	 * cached sound
+	 */
+	uint64_t m_pos;
 
 public:
 	/**
@@ -88,12 +153,91 @@ public:
 	 * \return total number of frames written
 	 */
 	uint64_t write(float *buf, uint64_t frameNum);
+	/**
+	 * \brief reads a planar block from the sound file
+	 *
+	 * reads up to block.getMaxFrames() frames and splits them into the planes
+	 * of the block, the block gets the number of frames read and the sampling
+	 * rate of the file
+	 *
+	 * \param block - block with the number of channels of the sound file
+	 * \return total number of frames read
+	 */
+	uint64_t read(CAudioBlock &block);
+	/**
+	 * \brief writes a planar block to the sound file
+	 *
+	 * \param block - block with the number of channels of the sound file
+	 * \return total number of frames written
+	 */
+	uint64_t write(CAudioBlock &block);
 	/**
 	 * \brief rewind sound file
 	 *
 	 * sets the file pointer of an open sound file back to the start
 	 */
 	void rewind();
+	/**
+	 * \brief sets the next frame to be read (sample accurate)
+	 *
+	 * - uncompressed and mapped files are positioned directly
+	 * - compressed files decode short forward distances, libsndfile seeks
+	 *   otherwise; files libsndfile can't seek are reopened and decoded up to
+	 *   the frame
+	 * - throws exception if the file is not open or the seek fails
+	 *
+	 * \param frame - frame index (limited to the number of frames)
+	 */
+	void seek(uint64_t frame);
+	/**
+	 * \brief delivers the next frame to be read/written
+	 * \return frame index
+	 */
+	uint64_t tell();
+	/**
+	 * \brief reads frames at a position (seek() and read())
+	 *
+	 * \param frame - index of the first frame
+	 * \param buf - address of buffer to store floating point audio data
+	 * \param frameNum - number of frames in buffer
+	 * \return total number of frames read, the next frame to be read follows them
+	 */
+	uint64_t readAt(uint64_t frame, float *buf, uint64_t frameNum);
+	/**
+	 * \brief gets interleaved frames of a cached sound or a float32 WAV file
+	 * without copying
+	 *
+	 * the frames count as read, the view is valid until the file is closed
+	 *
+	 * \param frameNum - number of frames requested
+	 * \param frames - [out] number of frames available (0 at the end of the file)
+	 * \return first frame or NULL if the file is neither cached nor mapped
+	 * float32 (read() has to be used)
+	 */
+	const float* getView(uint64_t frameNum, uint64_t &frames);
+	/**
+	 * \brief checks if the opened file is read from a memory mapping
+	 */
+	bool isMapped();
+	/**
+	 * \brief enables/disables the memory mapping of WAV files (enabled by
+	 * default), takes effect with the next open()
+	 */
+	void setMappingEnabled(bool enable);
+	/**
+	 * \brief checks if the opened file is read from the shared cache
+	 */
+	bool isCached();
+	/**
+	 * \brief enables/disables the shared cache of decoded sounds (disabled
+	 * by default), takes effect with the next open() for reading
+	 */
+	void setCacheEnabled(bool enable);
+	/**
+	 * \brief enables/disables the TPDF dither of write() for 16/24 bit PCM
+	 * files (disabled by default)
+	 */
+	void setDither(bool enable);
 	/**
 	 * \brief prints info of the sound file on the console
 	 *
@@ -140,5 +284,27 @@ public:
 	 * \see
 	 */
 	void setFormat(uint32_t format);
+
+private:
+	/**
+	 * \brief provides the interleaved buffer for a planar block
+	 *
+	 * throws exception if the number of channels does not fit
+	 */
+	float* _getIOBuffer(CAudioBlock &block);
+	/**
+	 * \brief provides the integer buffer for the exchange with libsndfile
+	 */
+	int32_t* _getPcmBuffer();
+	/**
+	 * \brief checks if libsndfile positions the file without decoding
+	 * (uncompressed formats)
+	 */
+	bool _isSeekFast();
+	/**
+	 * \brief reads and drops frames
+	 * \param frames - number of frames
+	 */
+	void _skip(uint64_t frames);
 };
 #endif /* FILESOUND_H_ */
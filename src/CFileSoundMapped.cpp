@@ -0,0 +1,277 @@
+/**
+ * \file CFileSoundMapped.cpp
+ * \brief implementation CFileSoundMapped
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <string.h>
+#include "sndfile.h"
+#include "CPcmConvert.h"
+#include "CFileSoundMapped.h"
+
+/*
+ * WAVE format tags
+ */
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+/*
+ * little endian fields of the header (no alignment)
+ */
+static uint16_t _le16(const uint8_t *p) {
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t _le32(const uint8_t *p) {
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16)
+			| ((uint32_t) p[3] << 24);
+}
+
+CFileSoundMapped::CFileSoundMapped() {
+	m_pFrames = NULL;
+	m_format = FORMAT_NONE;
+	m_channels = 0;
+	m_sampleRate = 0;
+	m_frameSize = 0;
+	m_numFrames = 0;
+	m_pos = 0;
+	m_convBuf = NULL;
+	m_convBufSize = 0;
+}
+
+CFileSoundMapped::~CFileSoundMapped() {
+	close();
+	if (m_convBuf)
+		delete[] m_convBuf;
+}
+
+bool CFileSoundMapped::open(const string &path) {
+	close();
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	// the samples are taken from the mapping as they are
+	return false;
+#endif
+	if (!m_file.map(path))
+		return false;
+	if (!_parse()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool CFileSoundMapped::_parse() {
+	const uint8_t *p = m_file.getData();
+	uint64_t size = m_file.getSize();
+	if ((size < 12) || memcmp(p, "RIFF", 4) || memcmp(p + 8, "WAVE", 4))
+		return false;
+
+	uint16_t tag = 0, channels = 0, blockAlign = 0, bits = 0;
+	uint32_t sampleRate = 0;
+	bool hasFmt = false;
+	uint64_t pos = 12;
+	while (pos + 8 <= size) {
+		const uint8_t *chunk = p + pos;
+		uint64_t len = _le32(chunk + 4);
+		uint64_t body = pos + 8;
+		if (!memcmp(chunk, "fmt ", 4)) {
+			if ((len < 16) || (body + len > size))
+				return false;
+			tag = _le16(p + body);
+			channels = _le16(p + body + 2);
+			sampleRate = _le32(p + body + 4);
+			blockAlign = _le16(p + body + 12);
+			bits = _le16(p + body + 14);
+			// the sub format GUID starts with the format tag
+			if ((tag == WAVE_FORMAT_EXTENSIBLE) && (len >= 40))
+				tag = _le16(p + body + 24);
+			hasFmt = true;
+		} else if (!memcmp(chunk, "data", 4)) {
+			if (!hasFmt)
+				return false;
+			// unfinished files may have a wrong length
+			if (len > size - body)
+				len = size - body;
+			switch (tag == WAVE_FORMAT_IEEE_FLOAT ? -bits : bits) {
+			case 8:
+				m_format = FORMAT_PCM8;
+				break;
+			case 16:
+				m_format = FORMAT_PCM16;
+				break;
+			case 24:
+				m_format = FORMAT_PCM24;
+				break;
+			case 32:
+				m_format = FORMAT_PCM32;
+				break;
+			case -32:
+				m_format = FORMAT_FLOAT;
+				break;
+			default:
+				return false;
+			}
+			if (((tag != WAVE_FORMAT_PCM) && (tag != WAVE_FORMAT_IEEE_FLOAT))
+					|| (channels == 0) || (sampleRate == 0)
+					|| (blockAlign != channels * (bits / 8))) {
+				m_format = FORMAT_NONE;
+				return false;
+			}
+			m_pFrames = p + body;
+			// 16 and 32 bit samples are accessed directly
+			if ((bits == 16 || bits == 32)
+					&& ((uintptr_t) m_pFrames % (bits / 8))) {
+				m_format = FORMAT_NONE;
+				m_pFrames = NULL;
+				return false;
+			}
+			m_channels = channels;
+			m_sampleRate = sampleRate;
+			m_frameSize = blockAlign;
+			m_numFrames = len / blockAlign;
+			m_pos = 0;
+			return true;
+		}
+		// chunks are padded to an even size
+		pos = body + len + (len & 1);
+	}
+	return false;
+}
+
+void CFileSoundMapped::close() {
+	m_file.unmap();
+	m_pFrames = NULL;
+	m_format = FORMAT_NONE;
+	m_channels = 0;
+	m_sampleRate = 0;
+	m_frameSize = 0;
+	m_numFrames = 0;
+	m_pos = 0;
+}
+
+bool CFileSoundMapped::isOpen() {
+	return m_format != FORMAT_NONE;
+}
+
+void CFileSoundMapped::_convert(uint64_t first, uint64_t frames, float *out) {
+	const uint8_t *in = m_pFrames + first * m_frameSize;
+	size_t num = frames * m_channels;
+	switch (m_format) {
+	case FORMAT_PCM8:
+		CPcmConvert::uint8ToFloat(in, out, num);
+		break;
+	case FORMAT_PCM16:
+		CPcmConvert::int16ToFloat((const int16_t*) in, out, num);
+		break;
+	case FORMAT_PCM24:
+		CPcmConvert::int24ToFloat(in, out, num);
+		break;
+	case FORMAT_PCM32:
+		CPcmConvert::int32ToFloat((const int32_t*) in, out, num);
+		break;
+	case FORMAT_FLOAT:
+		memcpy(out, in, num * sizeof(float));
+		break;
+	default:
+		break;
+	}
+}
+
+uint64_t CFileSoundMapped::read(float *buf, uint64_t frameNum) {
+	if (!isOpen() || (buf == NULL))
+		return 0;
+	uint64_t frames = m_numFrames - m_pos;
+	if (frames > frameNum)
+		frames = frameNum;
+	_convert(m_pos, frames, buf);
+	m_pos += frames;
+	return frames;
+}
+
+uint64_t CFileSoundMapped::read(CAudioBlock &block) {
+	if (!isOpen() || (block.getNumChannels() != m_channels))
+		return 0;
+	uint64_t frames = m_numFrames - m_pos;
+	if (frames > block.getMaxFrames())
+		frames = block.getMaxFrames();
+	if (m_channels == 1) {
+		// mono: the plane is the interleaved buffer
+		_convert(m_pos, frames, block.getChannel(0));
+		block.setNumFrames((uint16_t) frames);
+	} else if (m_format == FORMAT_FLOAT) {
+		block.deinterleave((const float*) (m_pFrames + m_pos * m_frameSize),
+				(uint16_t) frames);
+	} else {
+		uint32_t size = block.getMaxFrames() * m_channels;
+		if (size > m_convBufSize) {
+			if (m_convBuf)
+				delete[] m_convBuf;
+			m_convBuf = new float[size];
+			m_convBufSize = size;
+		}
+		_convert(m_pos, frames, m_convBuf);
+		block.deinterleave(m_convBuf, (uint16_t) frames);
+	}
+	block.setSampleRate(m_sampleRate);
+	m_pos += frames;
+	return frames;
+}
+
+const float* CFileSoundMapped::getView(uint64_t frameNum, uint64_t &frames) {
+	frames = 0;
+	if (m_format != FORMAT_FLOAT)
+		return NULL;
+	frames = m_numFrames - m_pos;
+	if (frames > frameNum)
+		frames = frameNum;
+	const float *pView = (const float*) (m_pFrames + m_pos * m_frameSize);
+	m_pos += frames;
+	return pView;
+}
+
+void CFileSoundMapped::rewind() {
+	m_pos = 0;
+}
+
+void CFileSoundMapped::seek(uint64_t frame) {
+	m_pos = (frame < m_numFrames) ? frame : m_numFrames;
+}
+
+uint64_t CFileSoundMapped::tell() {
+	return m_pos;
+}
+
+uint64_t CFileSoundMapped::getNumFrames() {
+	return m_numFrames;
+}
+
+uint32_t CFileSoundMapped::getSampleRate() {
+	return m_sampleRate;
+}
+
+uint16_t CFileSoundMapped::getNumChannels() {
+	return m_channels;
+}
+
+CFileSoundMapped::SAMPLEFORMAT CFileSoundMapped::getSampleFormat() {
+	return m_format;
+}
+
+int CFileSoundMapped::getSfFormat() {
+	switch (m_format) {
+	case FORMAT_PCM8:
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_U8;
+	case FORMAT_PCM16:
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+	case FORMAT_PCM24:
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+	case FORMAT_PCM32:
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_32;
+	case FORMAT_FLOAT:
+		return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	default:
+		return 0;
+	}
+}
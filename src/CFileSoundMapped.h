@@ -0,0 +1,162 @@
+/**
+ * \file CFileSoundMapped.h
+ * \brief interface CFileSoundMapped
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILESOUNDMAPPED_H_
+#define CFILESOUNDMAPPED_H_
+
+#include <stdint.h>
+#include <string>
+#include "CMappedFile.h"
+#include "CAudioBlock.h"
+using namespace std;
+
+/**
+ * \brief reads uncompressed WAV files from a memory mapping
+ *
+ * The RIFF header is parsed once when the file is opened, the samples are
+ * taken directly from the mapped data chunk:
+ * - float32: the frames are available as const view into the mapping
+ *   (getView()), read() copies them
+ * - PCM 8/16/24/32 bit: read() converts the samples (CPcmConvert, vectorized
+ *   for 16 and 24 bit)
+ *
+ * open() rejects everything else (compressed or double formats, RF64,
+ * big endian RIFX, misaligned samples), such files have to be read by
+ * libsndfile (CFileSound falls back automatically).
+ *
+ * The samples are normalized like libsndfile normalizes them.
+ */
+class CFileSoundMapped {
+public:
+	/**
+	 * \brief sample formats of the data chunk
+	 */
+	enum SAMPLEFORMAT {
+		FORMAT_NONE,	///< no file opened
+		FORMAT_PCM8,	///< unsigned 8 bit
+		FORMAT_PCM16,	///< signed 16 bit
+		FORMAT_PCM24,	///< signed 24 bit, packed
+		FORMAT_PCM32,	///< signed 32 bit
+		FORMAT_FLOAT	///< IEEE float 32 bit
+	};
+
+private:
+	CMappedFile m_file;
+	/**
+	 * \brief first byte of the first frame in the mapping
+	 */
+	const uint8_t *m_pFrames;
+	SAMPLEFORMAT m_format;
+	uint16_t m_channels;
+	uint32_t m_sampleRate;
+	/**
+	 * \brief bytes per frame
+	 */
+	uint32_t m_frameSize;
+	uint64_t m_numFrames;
+	/**
+	 * \brief next frame to be read
+	 */
+	uint64_t m_pos;
+	/**
+	 * \brief interleaved float buffer for read(CAudioBlock&) with more than
+	 * one channel
+	 */
+	float *m_convBuf;
+	uint32_t m_convBufSize;
+
+public:
+	/**
+	 * \brief Constructor (no file opened)
+	 */
+	CFileSoundMapped();
+	/**
+	 * \brief Destructor, unmaps the file
+	 */
+	~CFileSoundMapped();
+	CFileSoundMapped(const CFileSoundMapped&) = delete;
+	CFileSoundMapped& operator=(const CFileSoundMapped&) = delete;
+
+	/**
+	 * \brief maps a WAV file and parses its header
+	 * \param path path of the file
+	 * \return false if the file can't be mapped or has a format not read by
+	 * this class (nothing opened)
+	 */
+	bool open(const string &path);
+	/**
+	 * \brief unmaps the file
+	 */
+	void close();
+	/**
+	 * \brief checks if a file is opened
+	 */
+	bool isOpen();
+
+	/**
+	 * \brief reads interleaved frames and converts them to float
+	 * \param buf buffer for frameNum frames
+	 * \param frameNum number of frames
+	 * \return number of frames read (0 at the end of the file)
+	 */
+	uint64_t read(float *buf, uint64_t frameNum);
+	/**
+	 * \brief reads a planar block, the samples are converted directly into
+	 * the planes of a mono block
+	 * \param block block with the number of channels of the file, gets the
+	 * number of frames read
+	 * \return number of frames read (0 at the end of the file)
+	 */
+	uint64_t read(CAudioBlock &block);
+	/**
+	 * \brief gets interleaved float frames without copying (float32 files
+	 * only), the frames count as read
+	 * \param frameNum number of frames requested
+	 * \param frames [out] number of frames available (at most frameNum)
+	 * \return first frame in the mapping (valid until close()), NULL if the
+	 * file is not float32
+	 */
+	const float* getView(uint64_t frameNum, uint64_t &frames);
+	/**
+	 * \brief sets the next frame to be read back to the start
+	 */
+	void rewind();
+	/**
+	 * \brief sets the next frame to be read (no data is touched)
+	 * \param frame frame index (limited to the number of frames)
+	 */
+	void seek(uint64_t frame);
+	/**
+	 * \brief gets the next frame to be read
+	 */
+	uint64_t tell();
+
+	uint64_t getNumFrames();
+	uint32_t getSampleRate();
+	uint16_t getNumChannels();
+	SAMPLEFORMAT getSampleFormat();
+	/**
+	 * \brief gets the libsndfile format (SF_FORMAT_WAV | subtype)
+	 */
+	int getSfFormat();
+
+private:
+	/**
+	 * \brief parses the RIFF chunks of the mapping
+	 * \return true if the format is supported
+	 */
+	bool _parse();
+	/**
+	 * \brief converts interleaved samples of the data chunk to float
+	 * \param first first frame
+	 * \param frames number of frames
+	 * \param out float samples
+	 */
+	void _convert(uint64_t first, uint64_t frames, float *out);
+};
+
+#endif /* CFILESOUNDMAPPED_H_ */
@@ -0,0 +1,165 @@
+/**
+ * \file CFileSoundPrefetcher.cpp
+ * \brief implementation CFileSoundPrefetcher
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <sched.h>
+#include <unistd.h>
+#include <SKSLib.h>
+#include "CFileSoundPrefetcher.h"
+
+CFileSoundPrefetcher::CFileSoundPrefetcher(CFileSound *pFile,
+		uint16_t framesPerBlock, int fillMs) :
+		m_decoded(0), m_popped(0), m_eof(false), m_failed(false), m_stop(
+				false) {
+	if ((pFile == NULL) || (framesPerBlock == 0))
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"No sound file or block size!");
+	m_pFile = pFile;
+	m_framesPerBlock = framesPerBlock;
+	m_underruns = 0;
+
+	// blocks for the fill level, one more is held by the consumer
+	uint32_t fs = m_pFile->getSampleRate();
+	uint64_t frames = (uint64_t) fillMs * fs / 1000;
+	m_numBlocks = (int) ((frames + framesPerBlock - 1) / framesPerBlock);
+	if (m_numBlocks < 2)
+		m_numBlocks = 2;
+	m_ppBlocks = new CAudioBlock*[m_numBlocks];
+	for (int i = 0; i < m_numBlocks; i++)
+		m_ppBlocks[i] = new CAudioBlock(m_pFile->getNumChannels(),
+				framesPerBlock, fs);
+
+	m_running = false;
+	if (!_start()) {
+		for (int i = 0; i < m_numBlocks; i++)
+			delete m_ppBlocks[i];
+		delete[] m_ppBlocks;
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Could not start decoder thread!");
+	}
+	cout << "CFileSoundPrefetcher@" << hex << this << dec << " created ("
+			<< m_numBlocks << " blocks)" << endl;
+}
+
+CFileSoundPrefetcher::~CFileSoundPrefetcher() {
+	stop();
+	for (int i = 0; i < m_numBlocks; i++)
+		delete m_ppBlocks[i];
+	delete[] m_ppBlocks;
+	cout << "CFileSoundPrefetcher@" << hex << this << dec << " destroyed"
+			<< endl;
+}
+
+bool CFileSoundPrefetcher::_start() {
+	m_decoded = 0;
+	m_popped = 0;
+	m_eof = false;
+	m_failed = false;
+	m_stop = false;
+	m_running = (pthread_create(&m_thread, NULL, _decoderThread, this) == 0);
+	return m_running;
+}
+
+void* CFileSoundPrefetcher::_decoderThread(void *pArg) {
+	((CFileSoundPrefetcher*) pArg)->_decode();
+	return NULL;
+}
+
+void CFileSoundPrefetcher::_decode() {
+	uint64_t k = 0;
+	int spin = 0;
+	while (!m_stop.load(std::memory_order_relaxed)) {
+		// wait for a free slot: the consumer pops a block per block period,
+		// give up the CPU after a few tries
+		if (k - m_popped.load(std::memory_order_acquire)
+				>= (uint64_t) m_numBlocks) {
+			if (spin++ < 256)
+				sched_yield();
+			else
+				usleep(500);
+			continue;
+		}
+		spin = 0;
+		CAudioBlock *pBlock = m_ppBlocks[k % m_numBlocks];
+		uint64_t frames;
+		try {
+			frames = m_pFile->read(*pBlock);
+		} catch (CException &e) {
+			m_failed = true;
+			frames = 0;
+		}
+		if (frames > 0)
+			m_decoded.store(++k, std::memory_order_release);
+		if (frames < m_framesPerBlock)
+			break;
+	}
+	m_eof.store(true, std::memory_order_release);
+}
+
+CAudioBlock* CFileSoundPrefetcher::front() {
+	uint64_t k = m_popped.load(std::memory_order_relaxed);
+	if (k < m_decoded.load(std::memory_order_acquire))
+		return m_ppBlocks[k % m_numBlocks];
+	if (!m_eof.load(std::memory_order_acquire)
+			|| (k < m_decoded.load(std::memory_order_acquire)))
+		m_underruns++;
+	return NULL;
+}
+
+void CFileSoundPrefetcher::pop() {
+	uint64_t k = m_popped.load(std::memory_order_relaxed);
+	if (k < m_decoded.load(std::memory_order_acquire))
+		m_popped.store(k + 1, std::memory_order_release);
+}
+
+void CFileSoundPrefetcher::waitFilled(int numBlocks) {
+	if ((numBlocks <= 0) || (numBlocks > m_numBlocks))
+		numBlocks = m_numBlocks;
+	for (int spin = 0;
+			!m_eof.load(std::memory_order_acquire)
+					&& (m_decoded.load(std::memory_order_acquire)
+							- m_popped.load(std::memory_order_relaxed)
+							< (uint64_t) numBlocks); spin++) {
+		if (spin < 256)
+			sched_yield();
+		else
+			usleep(100);
+	}
+}
+
+bool CFileSoundPrefetcher::isFinished() {
+	return m_eof.load(std::memory_order_acquire)
+			&& (m_popped.load(std::memory_order_relaxed)
+					== m_decoded.load(std::memory_order_acquire));
+}
+
+bool CFileSoundPrefetcher::hasFailed() {
+	return m_failed;
+}
+
+void CFileSoundPrefetcher::stop() {
+	if (!m_running)
+		return;
+	m_stop = true;
+	pthread_join(m_thread, NULL);
+	m_running = false;
+}
+
+void CFileSoundPrefetcher::seek(uint64_t frame) {
+	stop();
+	m_pFile->seek(frame);
+	if (!_start())
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Could not start decoder thread!");
+}
+
+int CFileSoundPrefetcher::getNumBlocks() {
+	return m_numBlocks;
+}
+
+uint64_t CFileSoundPrefetcher::getUnderruns() {
+	return m_underruns;
+}
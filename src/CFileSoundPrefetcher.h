@@ -0,0 +1,158 @@
+/**
+ * \file CFileSoundPrefetcher.h
+ * \brief interface CFileSoundPrefetcher
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILESOUNDPREFETCHER_H_
+#define CFILESOUNDPREFETCHER_H_
+
+#include <atomic>
+#include <pthread.h>
+#include "CFileSound.h"
+#include "CAudioBlock.h"
+
+/**
+ * \brief reads a sound file ahead on a thread of its own
+ *
+ * The decoder thread reads the blocks of the sound file into a ring of
+ * planar blocks, at most the fill level (milliseconds) ahead of the
+ * consumer. The ring is a single producer/single consumer queue: both sides
+ * publish the number of blocks they have finished by an atomic counter,
+ * there are no locks. The consumer (playback loop) takes the decoded blocks
+ * by front() and pop() and never waits for the disk: front() returns NULL if
+ * the next block is not ready yet (underrun).
+ *
+ * The consumer may process a block in place (filter, visualize, play)
+ * before it is popped. The sound file must not be used by others while the
+ * prefetcher runs.
+ */
+class CFileSoundPrefetcher {
+public:
+	/**
+	 * \brief default fill level of the ring in milliseconds
+	 */
+	static const int DEFAULT_FILL_MS = 500;
+
+private:
+	/**
+	 * \brief sound file (not owned)
+	 */
+	CFileSound *m_pFile;
+	/**
+	 * \brief frames per block
+	 */
+	uint16_t m_framesPerBlock;
+	/**
+	 * \brief ring of blocks, block k is stored in slot k % m_numBlocks
+	 */
+	CAudioBlock **m_ppBlocks;
+	int m_numBlocks;
+	/**
+	 * \brief number of blocks decoded (producer) resp. popped (consumer)
+	 */
+	std::atomic<uint64_t> m_decoded;
+	std::atomic<uint64_t> m_popped;
+	/**
+	 * \brief the decoder has reached the end of the file (or failed)
+	 */
+	std::atomic<bool> m_eof;
+	/**
+	 * \brief reading the file failed
+	 */
+	std::atomic<bool> m_failed;
+	/**
+	 * \brief terminates the decoder thread
+	 */
+	std::atomic<bool> m_stop;
+	/**
+	 * \brief number of calls of front() without a ready block
+	 */
+	uint64_t m_underruns;
+	pthread_t m_thread;
+	bool m_running;
+
+public:
+	/**
+	 * \brief Constructor, starts the decoder thread
+	 *
+	 * - the file is read from its current position
+	 * - throws exception if the thread can not be started
+	 *
+	 * \param pFile opened sound file
+	 * \param framesPerBlock frames per block
+	 * \param fillMs fill level of the ring in milliseconds (at least 2 blocks)
+	 */
+	CFileSoundPrefetcher(CFileSound *pFile, uint16_t framesPerBlock,
+			int fillMs = DEFAULT_FILL_MS);
+	/**
+	 * \brief Destructor, stops the decoder thread
+	 */
+	~CFileSoundPrefetcher();
+
+	/**
+	 * \brief gets the next decoded block (consumer)
+	 * \return block (valid until pop()) or NULL if no block is ready
+	 */
+	CAudioBlock* front();
+	/**
+	 * \brief releases the block got by front() (consumer)
+	 */
+	void pop();
+	/**
+	 * \brief waits until the ring is filled or the file has been read
+	 * (before the playback starts)
+	 * \param numBlocks number of decoded blocks to wait for (0: whole ring)
+	 */
+	void waitFilled(int numBlocks = 0);
+	/**
+	 * \brief checks if all blocks of the file have been popped
+	 */
+	bool isFinished();
+	/**
+	 * \brief checks if reading the file failed (the blocks read before are
+	 * delivered)
+	 */
+	bool hasFailed();
+	/**
+	 * \brief stops the decoder thread (the file may be used again, blocks
+	 * not popped are discarded)
+	 */
+	void stop();
+	/**
+	 * \brief continues the decoding at a frame of the file (the blocks not
+	 * popped are discarded, front() delivers the block at the frame as soon
+	 * as it is decoded)
+	 *
+	 * throws exception if the file can't be positioned
+	 *
+	 * \param frame frame index
+	 */
+	void seek(uint64_t frame);
+	/**
+	 * \brief gets the number of blocks of the ring
+	 */
+	int getNumBlocks();
+	/**
+	 * \brief gets the number of calls of front() without a ready block
+	 */
+	uint64_t getUnderruns();
+
+private:
+	/**
+	 * \brief starts the decoder thread with an empty ring
+	 * \return false if the thread can't be started
+	 */
+	bool _start();
+	/**
+	 * \brief decoding loop of the thread
+	 */
+	void _decode();
+	/**
+	 * \brief thread function
+	 */
+	static void* _decoderThread(void *pArg);
+};
+
+#endif /* CFILESOUNDPREFETCHER_H_ */
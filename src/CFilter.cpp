@@ -7,15 +7,32 @@
  */
 #include <math.h>
 #include <SKSLib.h>
+#include "CSimd.h"
 #include "CFilter.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CFILTER_X86
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CFILTER_NEON
+#endif
+
+/*
+ * lanes of the widest vector kernel (floats in an AVX register): the states
+ * of all channels are stored in rows of a multiple of this number of floats,
+ * the coefficients are repeated this number of times
+ */
+#define CFILTER_LANES 8
+
 CFilter::CFilter(const string& filePath, float *ca, float *cb, uint16_t order, uint16_t channels) :
 		CFilterBase(order, channels) {
 	m_filePath=filePath;
 	if ((ca != NULL) && (cb != NULL)) {
 		m_a = new float[m_order + 1];
 		m_b = new float[m_order + 1];
-		for (int i = 0; i <= m_order; i++) {
+		for (uint32_t i = 0; i <= m_order; i++) {
 			m_a[i] = ca[i] / ca[0];
 			m_b[i] = cb[i] / ca[0];
 		}
@@ -23,6 +40,26 @@ CFilter::CFilter(const string& filePath, float *ca, float *cb, uint16_t order, u
 		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
 				"Filter coefficients not available!");
 
+	// coefficients and states for the vector kernels
+	// bv[n*LANES+l]=bn, av[n*LANES+l]=an for n=0..order (all lanes)
+	// zv[n*zStride+c]=zn of channel c, row n=order stays zero
+	m_zStride = CSimd::roundUp(m_channels, CFILTER_LANES);
+	m_bv = CSimd::allocAligned((m_order + 1) * CFILTER_LANES);
+	m_av = CSimd::allocAligned((m_order + 1) * CFILTER_LANES);
+	m_zv = CSimd::allocAligned((m_order + 1) * m_zStride);
+	for (uint32_t n = 0; n <= m_order; n++)
+		for (int l = 0; l < CFILTER_LANES; l++) {
+			m_bv[n * CFILTER_LANES + l] = m_b[n];
+			m_av[n * CFILTER_LANES + l] = m_a[n];
+		}
+
+	// fastest kernel available
+	m_kernel = KERNEL_SCALAR;
+	m_hasChannelFilter = true;
+	if (!setKernel(KERNEL_AVX))
+		if (!setKernel(KERNEL_SSE))
+			setKernel(KERNEL_NEON);
+
 	cout << "CFilter@" << hex << this << dec << " created" << endl;
 }
 
@@ -31,6 +68,9 @@ CFilter::~CFilter() {
 		delete[] m_a;
 	if (m_b != NULL)
 		delete[] m_b;
+	CSimd::freeAligned(m_bv);
+	CSimd::freeAligned(m_av);
+	CSimd::freeAligned(m_zv);
 	cout << "CFilter@" << hex << this << dec << " destroyed" << endl;
 }
 
@@ -40,33 +80,331 @@ bool CFilter::filter(float *x, float *y, uint16_t framesPerBuffer) {
 	if ((framesPerBuffer < m_order) || (x == NULL) || (y == NULL))
 		return false;
 
+	x = _addDenormalOffset(x, y, framesPerBuffer);
+	bool ok;
+	if (_filterParallel(x, y, framesPerBuffer, ok))
+		return ok;
+	_filterKernel(x, y, framesPerBuffer, m_channels, 0, m_channels);
+	return true;
+}
+
+bool CFilter::_filterChannel(uint16_t channel, float *x, float *y,
+		uint16_t framesPerBuffer) {
+	// a plane is a signal with one channel (frame stride 1)
+	_filterKernel(x, y, framesPerBuffer, 1, channel, 1);
+	return true;
+}
+
+void CFilter::_filterKernel(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
+	switch (m_kernel) {
+	case KERNEL_AVX:
+		_filterAVX(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		break;
+	case KERNEL_SSE:
+		_filterSSE(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		break;
+	case KERNEL_NEON:
+		_filterNEON(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		break;
+	default:
+		_filterScalar(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		break;
+	}
+}
+
+void CFilter::_filterScalar(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
 	// total buffer size with respect to interleaved channels
-	int bufsize = framesPerBuffer * m_channels;
+	int bufsize = framesPerBuffer * stride;
 	// for all samples x of one block
-	for (int k = 0; k < bufsize; k += m_channels) {
-		// calculate the output y for all samples of one frame
-		// y(k)=b0*x(k)+z0(k-1) - m_z contains all samples from the previous time step (k-1)
-		for (int c = 0; c < m_channels; c++) {
-			y[k + c] = m_b[0] * x[k + c] + m_z[0 + c];
-		}
-		// calculate the new state values z0(k) ..... zn-1(k) from the
-		//          previous state values z1(k-1) ... zn(k-1)
-		for (int n = 1; n <= m_order; n++) {
-			for (int c = 0; c < m_channels; c++)
-			{
-				int cur_zpos= m_channels * (n - 1); // new state value position
-				int next_zpos= m_channels * n;		// previous state value position
-				m_z[cur_zpos + c] = 					/*   zn-1(k) = */
-						            m_b[n] * x[k + c]   /*   bn*x(k) */
-								  - m_a[n] * y[k + c]   /* - an*y(k) */
-								  + m_z[next_zpos + c]; /* + zn(k-1) */			   ;
+	for (int k = 0; k < bufsize; k += stride) {
+		// the channels are independent, x(k) and y(k) are kept in locals so
+		// that the filter may work in place (x == y)
+		for (int i = 0; i < numChannels; i++) {
+			int c = firstChannel + i;	// channel of the intermediate states
+			float xk = x[k + i];
+			// y(k)=b0*x(k)+z0(k-1) - m_z contains all samples from the previous time step (k-1)
+			float yk = m_b[0] * xk + m_z[0 + c];
+			y[k + i] = yk;
+			// calculate the new state values z0(k) ..... zn-1(k) from the
+			//          previous state values z1(k-1) ... zn(k-1)
+			for (uint32_t n = 1; n <= m_order; n++) {
+				int cur_zpos = m_channels * (n - 1); // new state value position
+				int next_zpos = m_channels * n;		// previous state value position
+				m_z[cur_zpos + c] = 				/*   zn-1(k) = */
+						m_b[n] * xk					/*   bn*x(k) */
+						- m_a[n] * yk				/* - an*y(k) */
+						+ m_z[next_zpos + c];		/* + zn(k-1) */
 			}
 		}
 	}
-	return true;
+}
+
+/*
+ * The vector kernels evaluate the same expression in the same order as the
+ * scalar reference (no fused multiply add), therefore the results are bit exact.
+ *
+ * The channels are independent of each other and processed in the lanes of
+ * the registers: for each frame the samples of a group of channels are loaded
+ * from the interleaved block (adjacent samples) and the states are updated row
+ * by row
+ *   z[n-1][c..c+W-1] = bv[n]*x[c..c+W-1] - av[n]*y[c..c+W-1] + z[n][c..c+W-1]
+ * in ascending order of n (row n is read before it is written by the next
+ * step, row order is zero). All channels of a frame share one dependency
+ * chain from y(k) to z0(k), instead of one chain per channel.
+ *
+ * The samples of a group with less than W channels (the last one) are loaded
+ * and stored by loads and stores of 1, 2 or 3 floats, the unused lanes compute
+ * zeroes in the padding of the state rows.
+ */
+#ifdef CFILTER_X86
+__attribute__((target("sse2")))
+static inline __m128 _loadSSE(const float *p, int lanes) {
+	switch (lanes) {
+	case 1:
+		return _mm_load_ss(p);
+	case 2:
+		return _mm_castpd_ps(_mm_load_sd((const double*) p));
+	case 3:
+		return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*) p)),
+				_mm_load_ss(p + 2));
+	default:
+		return _mm_loadu_ps(p);
+	}
+}
+
+__attribute__((target("sse2")))
+static inline void _storeSSE(float *p, __m128 v, int lanes) {
+	switch (lanes) {
+	case 1:
+		_mm_store_ss(p, v);
+		break;
+	case 2:
+		_mm_store_sd((double*) p, _mm_castps_pd(v));
+		break;
+	case 3:
+		_mm_store_sd((double*) p, _mm_castps_pd(v));
+		_mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+		break;
+	default:
+		_mm_storeu_ps(p, v);
+		break;
+	}
+}
+
+__attribute__((target("sse2")))
+static void _dfiitSSE(const float *x, float *y, int frames, int stride,
+		int lanes, int order, const float *bv, const float *av, float *z,
+		int zStride) {
+	for (int k = 0; k < frames * stride; k += stride) {
+		__m128 vx = _loadSSE(x + k, lanes);
+		__m128 vy = _mm_add_ps(_mm_mul_ps(_mm_load_ps(bv), vx),
+				_mm_loadu_ps(z));
+		_storeSSE(y + k, vy, lanes);
+		for (int n = 1; n <= order; n++) {
+			__m128 v = _mm_sub_ps(
+					_mm_mul_ps(_mm_load_ps(bv + n * CFILTER_LANES), vx),
+					_mm_mul_ps(_mm_load_ps(av + n * CFILTER_LANES), vy));
+			_mm_storeu_ps(z + (n - 1) * zStride,
+					_mm_add_ps(v, _mm_loadu_ps(z + n * zStride)));
+		}
+	}
+}
+
+__attribute__((target("avx")))
+static void _dfiitAVX(const float *x, float *y, int frames, int stride,
+		int order, const float *bv, const float *av, float *z, int zStride) {
+	for (int k = 0; k < frames * stride; k += stride) {
+		__m256 vx = _mm256_loadu_ps(x + k);
+		__m256 vy = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(bv), vx),
+				_mm256_loadu_ps(z));
+		_mm256_storeu_ps(y + k, vy);
+		for (int n = 1; n <= order; n++) {
+			__m256 v = _mm256_sub_ps(
+					_mm256_mul_ps(_mm256_load_ps(bv + n * CFILTER_LANES), vx),
+					_mm256_mul_ps(_mm256_load_ps(av + n * CFILTER_LANES), vy));
+			_mm256_storeu_ps(z + (n - 1) * zStride,
+					_mm256_add_ps(v, _mm256_loadu_ps(z + n * zStride)));
+		}
+	}
+}
+#endif
+
+#ifdef CFILTER_NEON
+static inline float32x4_t _loadNEON(const float *p, int lanes) {
+	switch (lanes) {
+	case 1:
+		return vsetq_lane_f32(p[0], vdupq_n_f32(0.f), 0);
+	case 2:
+		return vcombine_f32(vld1_f32(p), vdup_n_f32(0.f));
+	case 3:
+		return vcombine_f32(vld1_f32(p),
+				vset_lane_f32(p[2], vdup_n_f32(0.f), 0));
+	default:
+		return vld1q_f32(p);
+	}
+}
+
+static inline void _storeNEON(float *p, float32x4_t v, int lanes) {
+	switch (lanes) {
+	case 1:
+		vst1q_lane_f32(p, v, 0);
+		break;
+	case 2:
+		vst1_f32(p, vget_low_f32(v));
+		break;
+	case 3:
+		vst1_f32(p, vget_low_f32(v));
+		vst1q_lane_f32(p + 2, v, 2);
+		break;
+	default:
+		vst1q_f32(p, v);
+		break;
+	}
+}
+
+static void _dfiitNEON(const float *x, float *y, int frames, int stride,
+		int lanes, int order, const float *bv, const float *av, float *z,
+		int zStride) {
+	for (int k = 0; k < frames * stride; k += stride) {
+		float32x4_t vx = _loadNEON(x + k, lanes);
+		float32x4_t vy = vaddq_f32(vmulq_f32(vld1q_f32(bv), vx),
+				vld1q_f32(z));
+		_storeNEON(y + k, vy, lanes);
+		for (int n = 1; n <= order; n++) {
+			float32x4_t v = vsubq_f32(
+					vmulq_f32(vld1q_f32(bv + n * CFILTER_LANES), vx),
+					vmulq_f32(vld1q_f32(av + n * CFILTER_LANES), vy));
+			vst1q_f32(z + (n - 1) * zStride,
+					vaddq_f32(v, vld1q_f32(z + n * zStride)));
+		}
+	}
+}
+#endif
+
+/*
+ * one channel on the states of the vector kernels (the lanes of the other
+ * channels may be in use by other threads)
+ */
+static void _dfiitLane(const float *x, float *y, int frames, int stride,
+		int order, const float *bv, const float *av, float *z, int zStride) {
+	for (int k = 0; k < frames * stride; k += stride) {
+		float xk = x[k];
+		float yk = bv[0] * xk + z[0];
+		y[k] = yk;
+		for (int n = 1; n <= order; n++)
+			z[(n - 1) * zStride] = bv[n * CFILTER_LANES] * xk
+					- av[n * CFILTER_LANES] * yk + z[n * zStride];
+	}
+}
+
+void CFilter::_filterLanes(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
+	for (int i = 0; i < numChannels; i++)
+		_dfiitLane(x + i, y + i, framesPerBuffer, stride, m_order, m_bv, m_av,
+				m_zv + firstChannel + i, m_zStride);
+}
+
+void CFilter::_filterSSE(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
+#ifdef CFILTER_X86
+	if (numChannels < m_channels) {
+		_filterLanes(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		return;
+	}
+	for (int i = 0; i < numChannels; i += 4)
+		_dfiitSSE(x + i, y + i, framesPerBuffer, stride,
+				(numChannels - i < 4) ? numChannels - i : 4, m_order, m_bv,
+				m_av, m_zv + i, m_zStride);
+#else
+	_filterScalar(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+#endif
+}
+
+void CFilter::_filterAVX(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
+#ifdef CFILTER_X86
+	if (numChannels < m_channels) {
+		_filterLanes(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		return;
+	}
+	// groups of 8 channels, the remaining ones by SSE (less unused lanes)
+	int i = 0;
+	for (; i + 8 <= numChannels; i += 8)
+		_dfiitAVX(x + i, y + i, framesPerBuffer, stride, m_order, m_bv, m_av,
+				m_zv + i, m_zStride);
+	for (; i < numChannels; i += 4)
+		_dfiitSSE(x + i, y + i, framesPerBuffer, stride,
+				(numChannels - i < 4) ? numChannels - i : 4, m_order, m_bv,
+				m_av, m_zv + i, m_zStride);
+#else
+	_filterScalar(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+#endif
+}
+
+void CFilter::_filterNEON(float *x, float *y, uint16_t framesPerBuffer,
+		int stride, uint16_t firstChannel, uint16_t numChannels) {
+#ifdef CFILTER_NEON
+	if (numChannels < m_channels) {
+		_filterLanes(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+		return;
+	}
+	for (int i = 0; i < numChannels; i += 4)
+		_dfiitNEON(x + i, y + i, framesPerBuffer, stride,
+				(numChannels - i < 4) ? numChannels - i : 4, m_order, m_bv,
+				m_av, m_zv + i, m_zStride);
+#else
+	_filterScalar(x, y, framesPerBuffer, stride, firstChannel, numChannels);
+#endif
+}
+
+void CFilter::reset() {
+	CFilterBase::reset();
+	for (uint32_t i = 0; i < (m_order + 1) * m_zStride; i++)
+		m_zv[i] = 0.;
+}
+
+bool CFilter::setKernel(KERNEL kernel) {
+	bool supported;
+	switch (kernel) {
+	case KERNEL_SSE:
+		supported = CSimd::hasSSE2();
+		break;
+	case KERNEL_AVX:
+		supported = CSimd::hasAVX();
+		break;
+	case KERNEL_NEON:
+		supported = CSimd::hasNEON();
+		break;
+	default:
+		supported = true;
+		break;
+	}
+	if (supported) {
+		m_kernel = kernel;
+		reset();
+	}
+	return supported;
+}
+
+CFilter::KERNEL CFilter::getKernel() {
+	return m_kernel;
+}
+
+string CFilter::getKernelName(KERNEL kernel) {
+	switch (kernel) {
+	case KERNEL_SSE:
+		return string("SSE");
+	case KERNEL_AVX:
+		return string("AVX");
+	case KERNEL_NEON:
+		return string("NEON");
+	default:
+		return string("scalar");
+	}
 }
 
 string CFilter::getFilePath() {
 	return m_filePath;
 }
-
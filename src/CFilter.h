@@ -13,8 +13,27 @@
  * \brief General filter class to calculate digital filter output by direct form II transposed
  *
  * implements filter method, handles errors by exception
+ *
+ * Besides the scalar reference implementation there are vectorized kernels
+ * (SSE, AVX, NEON). They process the channels of a frame in the lanes of
+ * vector registers (AVX: groups of 8 channels, SSE and NEON: groups of 4),
+ * the states are stored row by row (zn of all channels) for aligned loads.
+ * A single channel of a multichannel filter (channel-parallel mode) has no
+ * lanes to fill, it is processed lane by lane on the same states. The best
+ * kernel supported by the CPU is selected at runtime by the constructor.
  */
 class CFilter: public CFilterBase {
+public:
+	/**
+	 * \brief available implementations of the filter method
+	 */
+	enum KERNEL {
+		KERNEL_SCALAR,	///< scalar reference implementation
+		KERNEL_SSE,		///< 4 lanes, x86 SSE
+		KERNEL_AVX,		///< 8 lanes, x86 AVX
+		KERNEL_NEON		///< 4 lanes, ARM NEON
+	};
+
 private:
 	/**
 	 * \brief filter coefficients of numerator
@@ -29,12 +48,41 @@ private:
 	 */
 	string m_filePath;
 
+	/**
+	 * \brief kernel used by filter()
+	 */
+	KERNEL m_kernel;
+	/**
+	 * \brief numerator coefficients b0 ... bn for the vector kernels
+	 *
+	 * aligned, each coefficient repeated for the 8 lanes of a register
+	 */
+	float *m_bv;
+	/**
+	 * \brief denominator coefficients a0 ... an for the vector kernels
+	 *
+	 * aligned, each coefficient repeated for the 8 lanes of a register
+	 */
+	float *m_av;
+	/**
+	 * \brief intermediate states for the vector kernels
+	 *
+	 * aligned rows of m_zStride elements, row n holds zn of all channels
+	 * (rows z0 ... zn-1 followed by a row of zeroes)
+	 */
+	float *m_zv;
+	/**
+	 * \brief number of channels rounded up to a multiple of 8 (row of m_zv)
+	 */
+	uint32_t m_zStride;
+
 public:
 	/**
 	 * \brief Constructor
 	 *
 	 * - dynamic creation of arrays for filter coefficients
 	 * - initialization of arrays
+	 * - selection of the fastest kernel supported by the CPU
 	 * - throws exception if order or channels are zero
 	 *
 	 * \param filePath path of the associated filter file
@@ -52,7 +100,7 @@ public:
 	 * \brief Filters a signal.
 	 *
 	 * \param inBuf pointer on block buffer of original signal
-	 * \param outBuf pointer on block buffer of filtered signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
 	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
 	 * \return flag for successful execution (true) or error condition (false)
 	 *
@@ -62,12 +110,87 @@ public:
 	 * framesPerBuffer*channels
 	 */
 	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer); // straight forward difference equation
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+
+	/**
+	 * \brief clears the intermediate states of all kernels
+	 */
+	void reset();
+
+	/**
+	 * \brief selects the implementation of filter()
+	 *
+	 * The intermediate states are not transferred between the kernels,
+	 * therefore the filter is reset.
+	 *
+	 * \param kernel kernel to be used
+	 * \return true if the kernel is supported by the CPU, false otherwise (kernel not changed)
+	 */
+	bool setKernel(KERNEL kernel);
+	/**
+	 * \brief gets the implementation currently used by filter()
+	 * \return kernel
+	 */
+	KERNEL getKernel();
+	/**
+	 * \brief gets the kernel name as printable text
+	 * \param kernel kernel
+	 * \return name of the kernel
+	 */
+	static string getKernelName(KERNEL kernel);
 
 	/**
 	 * \brief gets full qualified pathname of the filter file
 	 * \return path of filter file
 	 */
 	string getFilePath();
+
+protected:
+	/**
+	 * \brief filters one channel of a block (channel-parallel mode)
+	 */
+	bool _filterChannel(uint16_t channel, float *x, float *y,
+			uint16_t framesPerBuffer);
+
+private:
+	/**
+	 * \brief filters the channels firstChannel ... firstChannel+numChannels-1
+	 * with the selected kernel
+	 *
+	 * x and y point to the first sample of firstChannel, the samples of the
+	 * following channels are stored behind it, the frames are stride samples apart
+	 * (interleaved block: stride = m_channels, plane of one channel: stride = 1)
+	 */
+	void _filterKernel(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
+	/**
+	 * \brief scalar reference implementation of the difference equation
+	 */
+	void _filterScalar(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
+	/**
+	 * \brief filters some channels of a multichannel filter lane by lane on
+	 * the states of the vector kernels (bit exact to _filterScalar())
+	 */
+	void _filterLanes(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
+	/**
+	 * \brief SSE kernel (bit exact to _filterScalar())
+	 */
+	void _filterSSE(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
+	/**
+	 * \brief AVX kernel (bit exact to _filterScalar())
+	 */
+	void _filterAVX(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
+	/**
+	 * \brief NEON kernel (bit exact to _filterScalar())
+	 */
+	void _filterNEON(float *x, float *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels);
 };
 #endif /* CFILTER_H_ */
-
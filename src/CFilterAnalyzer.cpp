@@ -0,0 +1,351 @@
+/**
+ * \file CFilterAnalyzer.cpp
+ * \brief implementation CFilterAnalyzer
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <sys/stat.h>
+#include <SKSLib.h>
+#include "CSimd.h"
+#include "CPolynomial.h"
+#include "CFilterAnalyzer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CFILTERANALYZER_X86
+#endif
+
+/*
+ * P(w) = c0 + c1*w + ... + cn*w^n and its derivative P'(w) for the bins
+ * first ... numBins-1 (Horner scheme, derivative in the same pass:
+ * D = D*w + P before P = P*w + ci)
+ */
+static void _hornerScalar(const double *c, int n, int first, int numBins,
+		const double *wr, const double *wi, double *pr, double *pi, double *dr,
+		double *di) {
+	for (int k = first; k < numBins; k++) {
+		double Pr = c[n], Pi = 0., Dr = 0., Di = 0.;
+		for (int i = n - 1; i >= 0; i--) {
+			double t = Dr * wr[k] - Di * wi[k] + Pr;
+			Di = Dr * wi[k] + Di * wr[k] + Pi;
+			Dr = t;
+			t = Pr * wr[k] - Pi * wi[k] + c[i];
+			Pi = Pr * wi[k] + Pi * wr[k];
+			Pr = t;
+		}
+		pr[k] = Pr;
+		pi[k] = Pi;
+		dr[k] = Dr;
+		di[k] = Di;
+	}
+}
+
+#ifdef CFILTERANALYZER_X86
+/*
+ * same as _hornerScalar() for 4 bins per register, returns the number of
+ * bins processed (multiple of 4)
+ */
+__attribute__((target("avx")))
+static int _hornerAVX(const double *c, int n, int numBins, const double *wr,
+		const double *wi, double *pr, double *pi, double *dr, double *di) {
+	int k;
+	for (k = 0; k + 4 <= numBins; k += 4) {
+		__m256d Wr = _mm256_loadu_pd(wr + k), Wi = _mm256_loadu_pd(wi + k);
+		__m256d Pr = _mm256_set1_pd(c[n]), Pi = _mm256_setzero_pd();
+		__m256d Dr = _mm256_setzero_pd(), Di = _mm256_setzero_pd();
+		for (int i = n - 1; i >= 0; i--) {
+			__m256d t = _mm256_add_pd(
+					_mm256_sub_pd(_mm256_mul_pd(Dr, Wr), _mm256_mul_pd(Di, Wi)),
+					Pr);
+			Di = _mm256_add_pd(
+					_mm256_add_pd(_mm256_mul_pd(Dr, Wi), _mm256_mul_pd(Di, Wr)),
+					Pi);
+			Dr = t;
+			t = _mm256_add_pd(
+					_mm256_sub_pd(_mm256_mul_pd(Pr, Wr), _mm256_mul_pd(Pi, Wi)),
+					_mm256_set1_pd(c[i]));
+			Pi = _mm256_add_pd(_mm256_mul_pd(Pr, Wi), _mm256_mul_pd(Pi, Wr));
+			Pr = t;
+		}
+		_mm256_storeu_pd(pr + k, Pr);
+		_mm256_storeu_pd(pi + k, Pi);
+		_mm256_storeu_pd(dr + k, Dr);
+		_mm256_storeu_pd(di + k, Di);
+	}
+	return k;
+}
+#endif
+
+/*
+ * all bins, fastest kernel
+ */
+static void _horner(const double *c, int n, int numBins, const double *wr,
+		const double *wi, double *pr, double *pi, double *dr, double *di,
+		bool vectorized) {
+	int first = 0;
+#ifdef CFILTERANALYZER_X86
+	if (vectorized && CSimd::hasAVX())
+		first = _hornerAVX(c, n, numBins, wr, wi, pr, pi, dr, di);
+#endif
+	_hornerScalar(c, n, first, numBins, wr, wi, pr, pi, dr, di);
+}
+
+/*
+ * degree without trailing zero coefficients
+ */
+static int _degree(const double *c, int order) {
+	while ((order > 0) && (c[order] == 0.))
+		order--;
+	return order;
+}
+
+CFilterAnalyzer::CFilterAnalyzer(int numBins) {
+	if (numBins < 2)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"At least 2 frequency bins required!");
+	m_numBins = numBins;
+	m_numEntries = 0;
+	m_next = 0;
+	m_hits = m_misses = 0;
+	cout << "CFilterAnalyzer@" << hex << this << dec << " created" << endl;
+}
+
+CFilterAnalyzer::~CFilterAnalyzer() {
+	clear();
+	cout << "CFilterAnalyzer@" << hex << this << dec << " destroyed" << endl;
+}
+
+const CFilterAnalyzer::RESPONSE* CFilterAnalyzer::analyze(
+		CFileFilter &filterFile) {
+	return analyze(filterFile.getFilepath(), filterFile.getSamplingFreq(),
+			filterFile.getACoeffsDouble(), filterFile.getBCoeffsDouble(),
+			filterFile.getOrder());
+}
+
+const CFilterAnalyzer::RESPONSE* CFilterAnalyzer::analyze(const string &path,
+		int fs, const double *a, const double *b, int order) {
+	if ((a == NULL) || (b == NULL) || (a[0] == 0.) || (order < 0) || (fs <= 0))
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter coefficients not available!");
+
+	time_t mtime = _getModificationTime(path);
+	RESPONSE *pResp = _find(path, fs, mtime);
+	if (pResp) {
+		m_hits++;
+		return pResp;
+	}
+	m_misses++;
+
+	pResp = new RESPONSE;
+	pResp->path = path;
+	pResp->fs = fs;
+	pResp->mtime = mtime;
+	pResp->order = order;
+	pResp->numBins = m_numBins;
+	pResp->freq = new double[4 * m_numBins];
+	pResp->magnitude = pResp->freq + m_numBins;
+	pResp->phase = pResp->freq + 2 * m_numBins;
+	pResp->groupDelay = pResp->freq + 3 * m_numBins;
+	for (int k = 0; k < m_numBins; k++)
+		pResp->freq[k] = 0.5 * fs * k / (m_numBins - 1);
+	evaluate(pResp, a, b, order);
+	_analyzePoles(pResp, a, order);
+	pResp->cutoff = _findCutoff(pResp);
+	_insert(pResp);
+	return pResp;
+}
+
+void CFilterAnalyzer::evaluate(RESPONSE *pResp, const double *a,
+		const double *b, int order, bool vectorized) {
+	int nb = pResp->numBins;
+	double *buf = new double[10 * nb];
+	double *wr = buf, *wi = buf + nb;
+	double *Br = buf + 2 * nb, *Bi = buf + 3 * nb, *dBr = buf + 4 * nb,
+			*dBi = buf + 5 * nb;
+	double *Ar = buf + 6 * nb, *Ai = buf + 7 * nb, *dAr = buf + 8 * nb,
+			*dAi = buf + 9 * nb;
+
+	// w = e^-jwT for the frequencies of the bins
+	for (int k = 0; k < nb; k++) {
+		double omega = 2. * M_PI * pResp->freq[k] / pResp->fs;
+		wr[k] = cos(omega);
+		wi[k] = -sin(omega);
+	}
+	_horner(b, _degree(b, order), nb, wr, wi, Br, Bi, dBr, dBi, vectorized);
+	_horner(a, _degree(a, order), nb, wr, wi, Ar, Ai, dAr, dAi, vectorized);
+
+	for (int k = 0; k < nb; k++) {
+		double absB2 = Br[k] * Br[k] + Bi[k] * Bi[k];
+		double absA2 = Ar[k] * Ar[k] + Ai[k] * Ai[k];
+		// H = B/A, |H|^2 = |B|^2/|A|^2, arg H = arg(B*conj(A))
+		pResp->magnitude[k] = 10. * log10(fmax(absB2, 1e-40) / fmax(absA2, 1e-300));
+		pResp->phase[k] = atan2(Bi[k] * Ar[k] - Br[k] * Ai[k],
+				Br[k] * Ar[k] + Bi[k] * Ai[k]);
+		// group delay -d(arg H)/dw = Re(w*B'/B) - Re(w*A'/A)
+		double tau = 0.;
+		if (absB2 > 1e-300) {
+			double xr = wr[k] * dBr[k] - wi[k] * dBi[k];
+			double xi = wr[k] * dBi[k] + wi[k] * dBr[k];
+			tau += (xr * Br[k] + xi * Bi[k]) / absB2;
+		}
+		if (absA2 > 1e-300) {
+			double xr = wr[k] * dAr[k] - wi[k] * dAi[k];
+			double xi = wr[k] * dAi[k] + wi[k] * dAr[k];
+			tau -= (xr * Ar[k] + xi * Ai[k]) / absA2;
+		}
+		pResp->groupDelay[k] = tau;
+	}
+	delete[] buf;
+}
+
+bool CFilterAnalyzer::isStable(const double *a, int order) {
+	int n = _degree(a, order);
+	if (n == 0)
+		return a[0] != 0.;
+
+	// step-down (Schur-Cohn) recursion: the reflection coefficients km are
+	// the last coefficients of the polynomials of decreasing degree, all
+	// poles are inside the unit circle if |km| < 1 for all m
+	double *c = new double[2 * (n + 1)];
+	double *t = c + n + 1;
+	for (int i = 0; i <= n; i++)
+		c[i] = a[i] / a[0];
+	bool stable = true;
+	for (int m = n; (m >= 1) && stable; m--) {
+		double k = c[m];
+		if (fabs(k) >= 1.) {
+			stable = false;
+			break;
+		}
+		double s = 1. - k * k;
+		for (int i = 1; i < m; i++)
+			t[i] = (c[i] - k * c[m - i]) / s;
+		for (int i = 1; i < m; i++)
+			c[i] = t[i];
+	}
+	delete[] c;
+	return stable;
+}
+
+void CFilterAnalyzer::_analyzePoles(RESPONSE *pResp, const double *a,
+		int order) {
+	int n = _degree(a, order);
+	pResp->numPoles = 0;
+	pResp->poleRadius = NULL;
+	pResp->maxPoleRadius = 0.;
+	pResp->stable = isStable(a, n);
+	if (n == 0)
+		return;		// FIR filter: all poles at the origin
+
+	// a0*z^n + a1*z^(n-1) + ... + an (poles at the origin are removed)
+	if (n <= MAX_ROOTS_ORDER) {
+		complex<double> *r = new complex<double>[n];
+		if (CPolynomial::roots(a, n, r) == n) {
+			pResp->poleRadius = new double[n];
+			for (int i = 0; i < n; i++) {
+				pResp->poleRadius[i] = abs(r[i]);
+				pResp->maxPoleRadius = fmax(pResp->maxPoleRadius,
+						pResp->poleRadius[i]);
+			}
+			pResp->numPoles = n;
+		}
+		delete[] r;
+	}
+	if (pResp->numPoles == 0)
+		pResp->maxPoleRadius = _radiusBound(a, n);
+}
+
+double CFilterAnalyzer::_radiusBound(const double *a, int order) {
+	// f(r) = sum |ai/a0| r^-i is decreasing, bisection for f(r) = 1
+	double hi = 1.;
+	for (int i = 1; i <= order; i++)
+		hi = fmax(hi, 1. + fabs(a[i] / a[0]));
+	double lo = 0.;
+	for (int iter = 0; iter < 60; iter++) {
+		double r = 0.5 * (lo + hi), f = 0.;
+		for (int i = 1; i <= order; i++)
+			if (a[i] != 0.)		// sparse filters: few taps
+				f += fabs(a[i] / a[0]) * pow(r, -i);
+		if (f > 1.)
+			lo = r;
+		else
+			hi = r;
+	}
+	return hi;
+}
+
+double CFilterAnalyzer::_findCutoff(RESPONSE *pResp) {
+	// first crossing of the -3 dB level (relative to the maximum) from DC
+	double peak = pResp->magnitude[0];
+	for (int k = 1; k < pResp->numBins; k++)
+		peak = fmax(peak, pResp->magnitude[k]);
+	double level = peak - 3.;
+	bool pass = pResp->magnitude[0] >= level;
+	for (int k = 1; k < pResp->numBins; k++) {
+		if ((pResp->magnitude[k] >= level) != pass) {
+			// linear interpolation between the bins
+			double m0 = pResp->magnitude[k - 1], m1 = pResp->magnitude[k];
+			double f0 = pResp->freq[k - 1], f1 = pResp->freq[k];
+			return f0 + (f1 - f0) * (level - m0) / (m1 - m0);
+		}
+	}
+	return 0.;
+}
+
+CFilterAnalyzer::RESPONSE* CFilterAnalyzer::_find(const string &path, int fs,
+		time_t mtime) {
+	for (int i = 0; i < m_numEntries; i++) {
+		RESPONSE *pResp = m_cache[i];
+		if ((pResp->fs != fs) || (pResp->path != path))
+			continue;
+		if (pResp->mtime == mtime)
+			return pResp;
+		// the file has been changed: the entry is outdated
+		_delete(pResp);
+		m_cache[i] = m_cache[--m_numEntries];
+		return NULL;
+	}
+	return NULL;
+}
+
+void CFilterAnalyzer::_insert(RESPONSE *pResp) {
+	if (m_numEntries < MAX_ENTRIES) {
+		m_cache[m_numEntries++] = pResp;
+		return;
+	}
+	_delete(m_cache[m_next]);
+	m_cache[m_next] = pResp;
+	m_next = (m_next + 1) % MAX_ENTRIES;
+}
+
+void CFilterAnalyzer::clear() {
+	for (int i = 0; i < m_numEntries; i++)
+		_delete(m_cache[i]);
+	m_numEntries = 0;
+	m_next = 0;
+}
+
+int CFilterAnalyzer::getHits() {
+	return m_hits;
+}
+
+int CFilterAnalyzer::getMisses() {
+	return m_misses;
+}
+
+void CFilterAnalyzer::_delete(RESPONSE *pResp) {
+	delete[] pResp->freq;	// all arrays of the bins
+	if (pResp->poleRadius != NULL)
+		delete[] pResp->poleRadius;
+	delete pResp;
+}
+
+time_t CFilterAnalyzer::_getModificationTime(const string &path) {
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		return 0;
+	return st.st_mtime;
+}
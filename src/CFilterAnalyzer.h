@@ -0,0 +1,185 @@
+/**
+ * \file CFilterAnalyzer.h
+ * \brief interface CFilterAnalyzer
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERANALYZER_H_
+#define CFILTERANALYZER_H_
+
+#include <time.h>
+#include "CFileFilter.h"
+
+/**
+ * \brief frequency response and stability of filter coefficients
+ *
+ * For the coefficients of a filter file and a sampling frequency the analyzer
+ * calculates
+ * - magnitude (dB), phase and group delay at equidistant frequencies
+ *   0 ... fs/2 (bins)
+ * - the radii of the poles and the stability
+ * - the cutoff frequency (-3 dB edge next to DC)
+ *
+ * The polynomials are evaluated by the Horner scheme for all bins at the
+ * same time (AVX: 4 bins per register, selected at runtime), the derivative
+ * for the group delay is calculated in the same pass.
+ *
+ * The results are cached by file path, sampling frequency and modification
+ * time of the file. A changed file is analyzed again, the oldest entry is
+ * replaced if the cache is full.
+ */
+class CFilterAnalyzer {
+public:
+	/**
+	 * \brief default number of frequency bins
+	 */
+	static const int NUM_BINS = 512;
+	/**
+	 * \brief number of cache entries
+	 */
+	static const int MAX_ENTRIES = 32;
+	/**
+	 * \brief highest order (number of non-trivial poles) whose poles are
+	 * calculated, higher orders get an upper bound of the pole radii
+	 */
+	static const int MAX_ROOTS_ORDER = 64;
+
+	/**
+	 * \brief result of the analysis
+	 */
+	struct RESPONSE {
+		string path;			///< filter file (or name of the coefficients)
+		int fs;					///< sampling frequency in Hz
+		time_t mtime;			///< modification time of the file (0: no file)
+		int order;				///< filter order
+		int numBins;			///< number of frequency bins
+		double *freq;			///< frequency of the bins in Hz (0 ... fs/2)
+		double *magnitude;		///< magnitude in dB
+		double *phase;			///< phase in rad (-pi ... pi)
+		double *groupDelay;		///< group delay in samples
+		int numPoles;			///< number of poles in poleRadius (poles at the origin are omitted)
+		double *poleRadius;		///< radii of the poles (NULL if not calculated)
+		double maxPoleRadius;	///< largest pole radius (upper bound if numPoles is 0 for a recursive filter)
+		bool stable;			///< all poles inside the unit circle
+		double cutoff;			///< -3 dB edge next to DC in Hz (0 if there is none)
+	};
+
+private:
+	/**
+	 * \brief cached results, m_cache[0 ... m_numEntries-1]
+	 */
+	RESPONSE *m_cache[MAX_ENTRIES];
+	int m_numEntries;
+	/**
+	 * \brief entry to be replaced next if the cache is full
+	 */
+	int m_next;
+	/**
+	 * \brief number of frequency bins
+	 */
+	int m_numBins;
+	/**
+	 * \brief statistics: results taken from the cache resp. calculated
+	 */
+	int m_hits, m_misses;
+
+public:
+	/**
+	 * \brief Constructor
+	 * \param numBins number of frequency bins (at least 2)
+	 */
+	CFilterAnalyzer(int numBins = NUM_BINS);
+	/**
+	 * \brief Destructor, deletes the cached results
+	 */
+	~CFilterAnalyzer();
+
+	/**
+	 * \brief analyzes the coefficients of a filter file
+	 *
+	 * the file must have been read for the sampling frequency
+	 * (CFileFilter::read()), throws exception if there are no coefficients
+	 *
+	 * \param filterFile filter file
+	 * \return result, owned by the analyzer and valid until the next call
+	 */
+	const RESPONSE* analyze(CFileFilter &filterFile);
+	/**
+	 * \brief analyzes filter coefficients
+	 *
+	 * \param path filter file the coefficients are read from (modification
+	 * time is part of the cache key) or any other name
+	 * \param fs sampling frequency in Hz
+	 * \param a denominator coefficients (order+1)
+	 * \param b numerator coefficients (order+1)
+	 * \param order filter order
+	 * \return result, owned by the analyzer and valid until the next call
+	 */
+	const RESPONSE* analyze(const string &path, int fs, const double *a,
+			const double *b, int order);
+	/**
+	 * \brief deletes all cached results
+	 */
+	void clear();
+	/**
+	 * \brief gets the number of results taken from the cache
+	 */
+	int getHits();
+	/**
+	 * \brief gets the number of results calculated
+	 */
+	int getMisses();
+
+	/**
+	 * \brief evaluates B(w)/A(w) at the bins of a response (w = e^-jwT)
+	 *
+	 * fills magnitude, phase and groupDelay of the response
+	 *
+	 * \param pResp response with freq, fs and numBins set
+	 * \param a denominator coefficients (order+1)
+	 * \param b numerator coefficients (order+1)
+	 * \param order filter order
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar kernel
+	 */
+	static void evaluate(RESPONSE *pResp, const double *a, const double *b,
+			int order, bool vectorized = true);
+	/**
+	 * \brief checks the stability of a denominator (step-down recursion)
+	 * \param a denominator coefficients (order+1)
+	 * \param order filter order
+	 * \return true if all poles are inside the unit circle
+	 */
+	static bool isStable(const double *a, int order);
+
+private:
+	/**
+	 * \brief finds a cached result
+	 * \return result or NULL
+	 */
+	RESPONSE* _find(const string &path, int fs, time_t mtime);
+	/**
+	 * \brief stores a result in the cache (replaces the oldest if full)
+	 */
+	void _insert(RESPONSE *pResp);
+	/**
+	 * \brief poles, stability and cutoff frequency of a response
+	 */
+	static void _analyzePoles(RESPONSE *pResp, const double *a, int order);
+	static double _findCutoff(RESPONSE *pResp);
+	/**
+	 * \brief upper bound of the pole radii (unique positive root of
+	 * 1 = sum |ai/a0| r^-i, exact for a single recursive tap)
+	 */
+	static double _radiusBound(const double *a, int order);
+	/**
+	 * \brief deletes a result
+	 */
+	static void _delete(RESPONSE *pResp);
+	/**
+	 * \brief modification time of a file (0 if there is no such file)
+	 */
+	static time_t _getModificationTime(const string &path);
+};
+
+#endif /* CFILTERANALYZER_H_ */
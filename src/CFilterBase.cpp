@@ -6,17 +6,57 @@
  * \author A. Wirth <antje.wirth@h-da.de
  */
 #include <math.h>
+#include <atomic>
 #include <SKSLib.h>
+#include "CSimd.h"
+#include "CWorkerPool.h"
 #include "CFilterBase.h"
 
-CFilterBase::CFilterBase(uint16_t order, uint16_t channels) {
-	m_order = abs(order);
-	m_channels = abs(channels);
+/*
+ * minimum work per channel and block for the channel-parallel mode (frames *
+ * (order+1), roughly the multiply-adds), waking the workers takes some
+ * microseconds
+ */
+#define CFILTERBASE_PARALLEL_MIN_COST 16384
+
+/*
+ * block of the channel-parallel mode shared by the tasks
+ */
+struct CFILTERBASE_PARALLEL {
+	CFilterBase *pFilter;
+	float *inBuf;		// interleaved block
+	float *outBuf;
+	CAudioBlock *pIn;	// planar block (inBuf == NULL)
+	CAudioBlock *pOut;
+	uint16_t frames;
+	std::atomic<bool> ok;
+};
+
+CFilterBase::CFilterBase(uint32_t order, uint16_t channels) {
+	// intermediate buffer: for the intermediate filter states from last sample
+	_init(order, channels, channels * (order + 1));
+}
+
+CFilterBase::CFilterBase(uint32_t order, uint16_t channels,
+		uint32_t stateSize) {
+	_init(order, channels, stateSize);
+}
+
+void CFilterBase::_init(uint32_t order, uint16_t channels,
+		uint32_t stateSize) {
+	m_order = order;
+	m_channels = channels;
+	m_zSize = stateSize;
+	m_z = NULL;
+	m_hasChannelFilter = false;
+	m_channelParallel = false;
+	m_planes = NULL;
+	m_planeStride = 0;
+	m_denormalOffset = 0.;
 	if ((m_order != 0) && (m_channels != 0)) {
-		// intermediate buffer: for the intermediate filter states from last sample
-		m_z = new float[m_channels * (m_order + 1)];
-		for (int i = 0; i < m_channels * (m_order + 1); i++) {
-			m_z[i] = 0.;
+		if (m_zSize != 0) {
+			m_z = new float[m_zSize];
+			reset();
 		}
 	} else
 		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
@@ -28,15 +68,184 @@ CFilterBase::CFilterBase(uint16_t order, uint16_t channels) {
 CFilterBase::~CFilterBase() {
 	if (m_z != NULL)
 		delete[] m_z;
+	CSimd::freeAligned(m_planes);
 	cout << "CFilterBase@" << hex << this << dec << " destroyed" << endl;
 }
 
 void CFilterBase::reset() {
-	for (int i = 0; i < m_channels * (m_order + 1); i++) {
+	for (uint32_t i = 0; i < m_zSize; i++) {
 		m_z[i] = 0.;
 	}
 }
 
-uint16_t CFilterBase::getOrder() {
+void CFilterBase::prepare(uint16_t maxFrames) {
+	_reservePlanes(maxFrames);
+}
+
+uint32_t CFilterBase::getOrder() {
 	return m_order;
 }
+
+int CFilterBase::getLatency() {
+	return 0;
+}
+
+uint16_t CFilterBase::getNumChannels() {
+	return m_channels;
+}
+
+string CFilterBase::getFilePath() {
+	return string("");
+}
+
+bool CFilterBase::setChannelParallel(bool enable) {
+	if (enable && !m_hasChannelFilter)
+		return false;
+	m_channelParallel = enable;
+	return true;
+}
+
+bool CFilterBase::getChannelParallel() {
+	return m_channelParallel;
+}
+
+void CFilterBase::setDenormalOffset(float offset) {
+	m_denormalOffset = fabsf(offset);
+}
+
+float CFilterBase::getDenormalOffset() {
+	return fabsf(m_denormalOffset);
+}
+
+float CFilterBase::_nextDenormalOffset() {
+	float offset = m_denormalOffset;
+	m_denormalOffset = -offset;
+	return offset;
+}
+
+float* CFilterBase::_addDenormalOffset(float *inBuf, float *outBuf,
+		uint16_t framesPerBuffer) {
+	if (m_denormalOffset == 0.)
+		return inBuf;
+	float offset = _nextDenormalOffset();
+	for (uint32_t i = 0; i < (uint32_t) framesPerBuffer * m_channels; i++)
+		outBuf[i] = inBuf[i] + offset;
+	return outBuf;
+}
+
+bool CFilterBase::_filterChannel(uint16_t, float*, float*, uint16_t) {
+	return false;		// engine without channel kernel
+}
+
+bool CFilterBase::filter(CAudioBlock &inBlock, CAudioBlock &outBlock) {
+	uint16_t frames = inBlock.getNumFrames();
+	if ((inBlock.getNumChannels() != m_channels)
+			|| (outBlock.getNumChannels() != m_channels)
+			|| (frames > outBlock.getMaxFrames()))
+		return false;
+	outBlock.setNumFrames(frames);
+	outBlock.setSampleRate(inBlock.getSampleRate());
+
+	if (m_hasChannelFilter) {
+		// recursive filters: the offset is added while the planes are copied
+		// into the output block, which is filtered in place
+		CAudioBlock *pIn = &inBlock;
+		if (m_denormalOffset != 0.) {
+			float offset = _nextDenormalOffset();
+			for (int c = 0; c < m_channels; c++) {
+				float *x = inBlock.getChannel(c), *y = outBlock.getChannel(c);
+				for (int k = 0; k < frames; k++)
+					y[k] = x[k] + offset;
+			}
+			pIn = &outBlock;
+		}
+		// the planes are filtered directly (in parallel if worthwhile)
+		if (_useParallel(frames)) {
+			CFILTERBASE_PARALLEL block;
+			block.pFilter = this;
+			block.inBuf = block.outBuf = NULL;
+			block.pIn = pIn;
+			block.pOut = &outBlock;
+			block.frames = frames;
+			block.ok = true;
+			CWorkerPool::getShared()->run(m_channels, _channelTask, &block);
+			return block.ok;
+		}
+		bool ok = true;
+		for (int c = 0; c < m_channels; c++)
+			ok &= _filterChannel(c, pIn->getChannel(c),
+					outBlock.getChannel(c), frames);
+		return ok;
+	}
+
+	// engines for interleaved blocks only
+	_reservePlanes(frames);
+	inBlock.interleave(m_planes);
+	bool ok = filter(m_planes, m_planes, frames);
+	outBlock.deinterleave(m_planes, frames);
+	return ok;
+}
+
+bool CFilterBase::_useParallel(uint16_t framesPerBuffer) {
+	if (!m_channelParallel || (m_channels < 2))
+		return false;
+	// cost heuristic: the dispatch must be amortized by the work per channel
+	if ((uint64_t) framesPerBuffer * (m_order + 1) < CFILTERBASE_PARALLEL_MIN_COST)
+		return false;
+	return CWorkerPool::getShared()->getNumWorkers() > 0;
+}
+
+void CFilterBase::_reservePlanes(uint16_t framesPerBuffer) {
+	// planes are separated by a cache line (no false sharing)
+	uint32_t stride = CSimd::roundUp(framesPerBuffer, 16) + 16;
+	if (stride > m_planeStride) {
+		CSimd::freeAligned(m_planes);
+		m_planes = CSimd::allocAligned(m_channels * stride);
+		m_planeStride = stride;
+	}
+}
+
+bool CFilterBase::_filterParallel(float *inBuf, float *outBuf,
+		uint16_t framesPerBuffer, bool &ok) {
+	if (!_useParallel(framesPerBuffer))
+		return false;
+	_reservePlanes(framesPerBuffer);
+
+	CFILTERBASE_PARALLEL block;
+	block.pFilter = this;
+	block.inBuf = inBuf;
+	block.outBuf = outBuf;
+	block.pIn = block.pOut = NULL;
+	block.frames = framesPerBuffer;
+	block.ok = true;
+	CWorkerPool::getShared()->run(m_channels, _channelTask, &block);
+	ok = block.ok;
+	return true;
+}
+
+void CFilterBase::_channelTask(void *pArg, int channel) {
+	CFILTERBASE_PARALLEL *pBlock = (CFILTERBASE_PARALLEL*) pArg;
+	CFilterBase *pFilter = pBlock->pFilter;
+	int frames = pBlock->frames;
+
+	// planar block: nothing to rearrange
+	if (pBlock->pIn != NULL) {
+		if (!pFilter->_filterChannel(channel, pBlock->pIn->getChannel(channel),
+				pBlock->pOut->getChannel(channel), frames))
+			pBlock->ok = false;
+		return;
+	}
+
+	// each task reads and writes only the samples of its channel, therefore
+	// the block may be filtered in place
+	int channels = pFilter->m_channels;
+	float *plane = pFilter->m_planes + channel * pFilter->m_planeStride;
+	float *x = pBlock->inBuf + channel;
+	for (int k = 0; k < frames; k++)
+		plane[k] = x[k * channels];
+	if (!pFilter->_filterChannel(channel, plane, plane, frames))
+		pBlock->ok = false;
+	float *y = pBlock->outBuf + channel;
+	for (int k = 0; k < frames; k++)
+		y[k * channels] = plane[k];
+}
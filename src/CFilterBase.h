@@ -8,11 +8,28 @@
 #ifndef CFILTERBASE_H_
 #define CFILTERBASE_H_
 
+#include "CAudioBlock.h"
+
+/**
+ * \brief default level of the anti-denormal offset (about -400 dB)
+ */
+#define CFILTERBASE_DENORMAL_OFFSET 1e-20f
+
 /**
  * \brief filter base class
  *
  * provides common attributes for derived filter classes and defines basic
  * interface
+ *
+ * Filters with a kernel for a single channel (_filterChannel()) support a
+ * channel-parallel mode: a block is split into one plane per channel and the
+ * planes are filtered by the threads of the shared CWorkerPool. Blocks with
+ * too little work per channel to pay for the dispatch are filtered by the
+ * calling thread as usual.
+ *
+ * Recursive filters may add a tiny offset to their input (setDenormalOffset())
+ * which keeps their states away from subnormal numbers when the signal fades
+ * out, for threads that do not run with flush-to-zero (see CDenormalGuard).
  */
 class CFilterBase {
 protected:
@@ -21,13 +38,41 @@ protected:
 	 */
 	float *m_z;
 	/**
-	 * \brief filter order
+	 * \brief number of elements of m_z
 	 */
-	uint16_t m_order;
+	uint32_t m_zSize;
+	/**
+	 * \brief filter order (resp. delay in samples for delay filters)
+	 */
+	uint32_t m_order;
 	/**
 	 * \brief number of channels of the signals to be filtered
 	 */
 	uint16_t m_channels;
+	/**
+	 * \brief set by derived classes that implement _filterChannel()
+	 */
+	bool m_hasChannelFilter;
+
+private:
+	/**
+	 * \brief channel-parallel mode enabled
+	 */
+	bool m_channelParallel;
+	/**
+	 * \brief one aligned plane of m_planeStride elements per channel
+	 * (channel-parallel mode), interleaved buffer for filter(CAudioBlock&, CAudioBlock&)
+	 */
+	float *m_planes;
+	/**
+	 * \brief offset added to the input of recursive filters (0: disabled),
+	 * the sign changes with each block
+	 */
+	float m_denormalOffset;
+	/**
+	 * \brief distance of the planes (elements)
+	 */
+	uint32_t m_planeStride;
 
 public:
 	/**
@@ -40,7 +85,20 @@ public:
 	 * \param order order of the filter
 	 * \param channels no of channels of input signal
 	 */
-	CFilterBase(uint16_t order, uint16_t channels);
+	CFilterBase(uint32_t order, uint16_t channels);
+	/**
+	 * \brief Constructor for filters with a state layout of their own
+	 *
+	 * - initializes attributes
+	 * - initializes buffer for intermediate states with stateSize elements
+	 *   (no buffer if stateSize is zero)
+	 * - throws exception if order or channels are zero
+	 *
+	 * \param order order of the filter
+	 * \param channels no of channels of input signal
+	 * \param stateSize number of intermediate states (all channels)
+	 */
+	CFilterBase(uint32_t order, uint16_t channels, uint32_t stateSize);
 	/**
 	 * Destructor
 	 *
@@ -58,20 +116,158 @@ public:
 	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
 	 */
 	virtual bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer)=0;
+	/**
+	 * \brief filters a planar block
+	 *
+	 * Filters with a single channel kernel process the planes directly,
+	 * other filters interleave the block into an internal buffer. Derived
+	 * classes that override filter() make this overload visible by
+	 * "using CFilterBase::filter".
+	 *
+	 * \param inBlock original signal
+	 * \param outBlock filtered signal (may be inBlock), gets the number of frames of inBlock
+	 * \return flag for successful execution (true) or error condition (false,
+	 * e.g. different number of channels)
+	 */
+	virtual bool filter(CAudioBlock &inBlock, CAudioBlock &outBlock);
 	/**
 	 * \brief resets filter
 	 *
 	 * Clears all intermediate values. May be used before filtering a new signal
 	 * by the same filter object.
 	 */
-	void reset();
+	virtual void reset();
+	/**
+	 * \brief allocates the buffers for blocks of up to maxFrames frames
+	 *
+	 * To be called by the control thread before the filter is handed over to
+	 * the audio thread, filter() allocates only for larger blocks then.
+	 * Filters that contain other filters prepare them as well.
+	 *
+	 * \param maxFrames maximum number of frames per block
+	 */
+	virtual void prepare(uint16_t maxFrames);
+	/**
+	 * \brief retrieves the latency of the filter
+	 *
+	 * \return delay of the output in blocks (0: the output belongs to the
+	 * block passed to filter())
+	 */
+	virtual int getLatency();
 
 	/**
 	 * \brief retrieves the order of the filter
 	 *
 	 * \return order of the filter
 	 */
-	uint16_t getOrder();
+	uint32_t getOrder();
+
+	/**
+	 * \brief retrieves the number of channels the filter was created for
+	 *
+	 * \return number of channels
+	 */
+	uint16_t getNumChannels();
+
+	/**
+	 * \brief retrieves the path of the filter file the filter has been created from
+	 *
+	 * \return path of the filter file or an empty string for filters that are
+	 * configured by parameters (e.g. delay filters)
+	 */
+	virtual string getFilePath();
+
+	/**
+	 * \brief enables or disables the channel-parallel mode
+	 * \param enable true: filter the channels in parallel if the block is large enough
+	 * \return false if the filter has no single channel kernel (mode not changed)
+	 */
+	bool setChannelParallel(bool enable);
+	/**
+	 * \brief gets the channel-parallel mode
+	 * \return true if enabled
+	 */
+	bool getChannelParallel();
+
+	/**
+	 * \brief enables or disables the anti-denormal offset
+	 *
+	 * The offset is added to the input of recursive filters (direct form,
+	 * SOS, delay and sparse filters). Its sign changes with each block, i.e.
+	 * it is a square wave of very low frequency which passes lowpass as well
+	 * as highpass filters and keeps the states at least at about the level of
+	 * the offset. The level is far below the resolution of the samples.
+	 *
+	 * \param offset level of the offset (0: disabled)
+	 */
+	void setDenormalOffset(float offset = CFILTERBASE_DENORMAL_OFFSET);
+	/**
+	 * \brief gets the level of the anti-denormal offset
+	 * \return level (0: disabled)
+	 */
+	float getDenormalOffset();
+
+protected:
+	/**
+	 * \brief filters a block channel-parallel, to be called by filter() of derived classes
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers
+	 * \param ok [out] result of the filter operation (if the block has been filtered)
+	 * \return true if the block has been filtered, false if the mode is
+	 * disabled or the block is too small (the caller filters the block)
+	 */
+	bool _filterParallel(float *inBuf, float *outBuf, uint16_t framesPerBuffer,
+			bool &ok);
+	/**
+	 * \brief filters one channel of a block (contiguous samples)
+	 *
+	 * may be called by different threads for different channels at the same time
+	 *
+	 * \param channel index of the channel (selects the intermediate states)
+	 * \param x samples of the channel
+	 * \param y filtered samples of the channel (may be x)
+	 * \param framesPerBuffer no of samples
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	virtual bool _filterChannel(uint16_t channel, float *x, float *y,
+			uint16_t framesPerBuffer);
+	/**
+	 * \brief adds the anti-denormal offset to a block, to be called by filter()
+	 * of recursive filters before the block is filtered
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (gets the sum)
+	 * \param framesPerBuffer no of frames in the block buffers
+	 * \return buffer to be filtered in place: inBuf if the offset is
+	 * disabled, outBuf otherwise
+	 */
+	float* _addDenormalOffset(float *inBuf, float *outBuf,
+			uint16_t framesPerBuffer);
+
+private:
+	/**
+	 * \brief checks the channel-parallel mode and the cost heuristic
+	 * \return true if a block of this size is to be filtered in parallel
+	 */
+	bool _useParallel(uint16_t framesPerBuffer);
+	/**
+	 * \brief grows m_planes for blocks of the given size
+	 */
+	void _reservePlanes(uint16_t framesPerBuffer);
+	/**
+	 * \brief gets the anti-denormal offset for the next block (changes the sign)
+	 */
+	float _nextDenormalOffset();
+	/**
+	 * \brief task of the channel-parallel mode (one channel)
+	 */
+	static void _channelTask(void *pArg, int channel);
+	/**
+	 * \brief allocates and clears the intermediate state buffer
+	 */
+	void _init(uint32_t order, uint16_t channels, uint32_t stateSize);
 };
 #endif /* CFILTERBASE_H_ */
 
@@ -0,0 +1,146 @@
+/**
+ * \file CFilterChain.cpp
+ * \brief implementation CFilterChain
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <chrono>
+#include <string.h>
+#include <SKSLib.h>
+#include "CFilterChain.h"
+
+CFilterChain::CFilterChain(uint16_t channels) :
+		CFilterBase(1, channels, 0) {
+	// the order of the chain is the sum of the orders of its stages
+	m_order = 0;
+	m_numStages = 0;
+	for (int i = 0; i < MAX_STAGES; i++) {
+		m_stages[i] = NULL;
+		m_bypass[i] = false;
+	}
+	resetTiming();
+	cout << "CFilterChain@" << hex << this << dec << " created" << endl;
+}
+
+CFilterChain::~CFilterChain() {
+	for (int i = 0; i < m_numStages; i++)
+		delete m_stages[i];
+	cout << "CFilterChain@" << hex << this << dec << " destroyed" << endl;
+}
+
+int CFilterChain::addStage(CFilterBase *pStage) {
+	if (pStage == NULL)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"No filter for the chain!");
+	if (m_numStages >= MAX_STAGES)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter chain is full!");
+	if (pStage->getNumChannels() != m_channels)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Number of channels of the filter does not match the chain!");
+	m_stages[m_numStages] = pStage;
+	m_bypass[m_numStages] = false;
+	m_time_ns[m_numStages] = 0.;
+	m_samples[m_numStages] = 0.;
+	m_order += pStage->getOrder();
+	return m_numStages++;
+}
+
+int CFilterChain::getNumStages() {
+	return m_numStages;
+}
+
+CFilterBase* CFilterChain::getStage(int idx) {
+	if ((idx < 0) || (idx >= m_numStages))
+		return NULL;
+	return m_stages[idx];
+}
+
+void CFilterChain::setBypass(int idx, bool bypass) {
+	if ((idx >= 0) && (idx < m_numStages))
+		m_bypass[idx] = bypass;
+}
+
+bool CFilterChain::getBypass(int idx) {
+	if ((idx < 0) || (idx >= m_numStages))
+		return false;
+	return m_bypass[idx];
+}
+
+double CFilterChain::getStageTime(int idx) {
+	if ((idx < 0) || (idx >= m_numStages) || (m_samples[idx] == 0.))
+		return 0.;
+	return m_time_ns[idx] / m_samples[idx];
+}
+
+void CFilterChain::resetTiming() {
+	for (int i = 0; i < MAX_STAGES; i++) {
+		m_time_ns[i] = 0.;
+		m_samples[i] = 0.;
+	}
+}
+
+void CFilterChain::reset() {
+	for (int i = 0; i < m_numStages; i++)
+		m_stages[i]->reset();
+}
+
+void CFilterChain::prepare(uint16_t maxFrames) {
+	CFilterBase::prepare(maxFrames);
+	for (int i = 0; i < m_numStages; i++)
+		m_stages[i]->prepare(maxFrames);
+}
+
+bool CFilterChain::filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer) {
+	return filterStages(0, m_numStages, inBuf, outBuf, framesPerBuffer);
+}
+
+bool CFilterChain::filterStages(int first, int num, float *inBuf,
+		float *outBuf, uint16_t framesPerBuffer) {
+	if ((inBuf == NULL) || (outBuf == NULL) || (first < 0)
+			|| (first + num > m_numStages))
+		return false;
+
+	// the first active stage reads the input, all others work in place
+	float *x = inBuf;
+	bool ok = true;
+	for (int i = first; i < first + num; i++) {
+		if (m_bypass[i])
+			continue;
+		auto start = chrono::steady_clock::now();
+		ok &= m_stages[i]->filter(x, outBuf, framesPerBuffer);
+		auto stop = chrono::steady_clock::now();
+		m_time_ns[i] += chrono::duration<double, nano>(stop - start).count();
+		m_samples[i] += (double) framesPerBuffer * m_channels;
+		x = outBuf;
+	}
+	// all stages bypassed
+	if (x != outBuf)
+		memcpy(outBuf, inBuf, framesPerBuffer * m_channels * sizeof(float));
+	return ok;
+}
+
+bool CFilterChain::filter(CAudioBlock &inBlock, CAudioBlock &outBlock) {
+	if ((inBlock.getNumChannels() != m_channels)
+			|| (outBlock.getNumChannels() != m_channels))
+		return false;
+
+	// the first active stage reads the input, all others work in place
+	CAudioBlock *pX = &inBlock;
+	bool ok = true;
+	for (int i = 0; i < m_numStages; i++) {
+		if (m_bypass[i])
+			continue;
+		auto start = chrono::steady_clock::now();
+		ok &= m_stages[i]->filter(*pX, outBlock);
+		auto stop = chrono::steady_clock::now();
+		m_time_ns[i] += chrono::duration<double, nano>(stop - start).count();
+		m_samples[i] += (double) inBlock.getNumFrames() * m_channels;
+		pX = &outBlock;
+	}
+	// all stages bypassed
+	if (pX != &outBlock)
+		ok &= outBlock.copy(inBlock);
+	return ok;
+}
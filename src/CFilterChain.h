@@ -0,0 +1,149 @@
+/**
+ * \file CFilterChain.h
+ * \brief interface CFilterChain
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERCHAIN_H_
+#define CFILTERCHAIN_H_
+
+#include "CFilterBase.h"
+
+/**
+ * \brief series connection of filters (e.g. treble boost followed by a delay)
+ *
+ * The stages are processed one after another in place on the output buffer:
+ * the first active stage filters from the input into the output buffer, all
+ * following stages filter the output buffer in place. Therefore no
+ * intermediate buffers and no copies are necessary (all filters of this
+ * project may work in place). Bypassed stages are skipped.
+ *
+ * The chain measures the processing time of each stage to show which stage
+ * dominates. The chain owns its stages.
+ */
+class CFilterChain: public CFilterBase {
+public:
+	/**
+	 * \brief maximum number of stages
+	 */
+	static const int MAX_STAGES = 16;
+
+private:
+	/**
+	 * \brief stages in processing order
+	 */
+	CFilterBase *m_stages[MAX_STAGES];
+	/**
+	 * \brief bypass flag per stage
+	 */
+	bool m_bypass[MAX_STAGES];
+	/**
+	 * \brief accumulated processing time per stage (ns)
+	 */
+	double m_time_ns[MAX_STAGES];
+	/**
+	 * \brief accumulated number of processed samples per stage
+	 */
+	double m_samples[MAX_STAGES];
+	/**
+	 * \brief number of stages
+	 */
+	int m_numStages;
+
+public:
+	/**
+	 * \brief Constructor (empty chain, passes the signal unchanged)
+	 *
+	 * \param channels number of channels of the signal
+	 */
+	CFilterChain(uint16_t channels);
+	/**
+	 * \brief Destructor, deletes all stages
+	 */
+	virtual ~CFilterChain();
+	/**
+	 * \brief appends a stage (the chain takes ownership)
+	 *
+	 * throws an exception if the chain is full or if the number of channels
+	 * of the stage does not match
+	 *
+	 * \param pStage filter
+	 * \return index of the stage
+	 */
+	int addStage(CFilterBase *pStage);
+	/**
+	 * \brief gets the number of stages
+	 * \return number of stages
+	 */
+	int getNumStages();
+	/**
+	 * \brief gets a stage
+	 * \param idx index of the stage
+	 * \return filter of the stage or NULL for an invalid index
+	 */
+	CFilterBase* getStage(int idx);
+	/**
+	 * \brief bypasses a stage or enables it again
+	 * \param idx index of the stage
+	 * \param bypass true: stage is skipped, false: stage is processed
+	 */
+	void setBypass(int idx, bool bypass);
+	/**
+	 * \brief gets the bypass state of a stage
+	 * \param idx index of the stage
+	 * \return true: stage is skipped, false: stage is processed
+	 */
+	bool getBypass(int idx);
+	/**
+	 * \brief gets the mean processing time of a stage
+	 * \param idx index of the stage
+	 * \return processing time in ns per sample (0 if not yet processed)
+	 */
+	double getStageTime(int idx);
+	/**
+	 * \brief clears the measured processing times
+	 */
+	void resetTiming();
+	/**
+	 * \brief resets all stages
+	 */
+	void reset();
+	/**
+	 * \brief allocates the buffers of the chain and all stages (see CFilterBase)
+	 */
+	void prepare(uint16_t maxFrames);
+	/**
+	 * \brief Filters a signal by all stages that are not bypassed.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief Filters a planar block by all stages that are not bypassed.
+	 *
+	 * \param inBlock original signal
+	 * \param outBlock filtered signal (may be inBlock)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(CAudioBlock &inBlock, CAudioBlock &outBlock);
+	/**
+	 * \brief Filters a signal by a range of consecutive stages (bypassed stages are skipped).
+	 *
+	 * Different ranges may be processed by different threads (see CFilterPipeline).
+	 *
+	 * \param first index of the first stage
+	 * \param num number of stages
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filterStages(int first, int num, float *inBuf, float *outBuf,
+			uint16_t framesPerBuffer);
+};
+
+#endif /* CFILTERCHAIN_H_ */
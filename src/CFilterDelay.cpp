@@ -5,41 +5,431 @@
  * \date 11.09.2019
  * \author A. Wirth <antje.wirth@h-da.de
  */
-/************************************************************************
- *
- *	 					ATTENTION !!!!!!!!!
- *
- * This file contains only rudimentary code in a nonfunctional version
- * to make the start project compilable and executable in its initial version.
- *
- * It should be replaced by an complete implementation.
- *
- ************************************************************************/
+#define _USE_MATH_DEFINES
 #include <math.h>
 #include <SKSLib.h>
+#include "CSimd.h"
 #include "CFilterDelay.h"
 
-CFilterDelay::CFilterDelay(float gFF, float gFB, uint16_t delay_ms, uint32_t fs,
-		uint16_t channels) :
-		CFilterBase((uint16_t) (delay_ms * fs / 1000.), channels) {
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CFILTERDELAY_X86
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CFILTERDELAY_NEON
+#endif
+
+/*
+ * delays (frames) below this length are processed frame by frame, the spans
+ * would be too short for the vector kernels
+ */
+#define CFILTERDELAY_MIN_SPAN 16
+
+/*
+ * frames the circular buffer must provide behind the maximum delay
+ * (Lagrange interpolation reads D+2, the write head must not be reached)
+ */
+#define CFILTERDELAY_INTERP_FRAMES 3
+
+/*
+ * span kernels: y = x + gFF*d, z = x + gFB*d for n samples
+ *
+ * d and z are both located in the circular buffer. They may only overlap at
+ * the same index (if the buffer length equals the delay), each element of d is
+ * loaded before the same element of z is stored.
+ */
+static void _combSpan(const float *x, const float *d, float *y, float *z,
+		uint32_t n, float gFF, float gFB) {
+	for (uint32_t i = 0; i < n; i++) {
+		float xi = x[i], di = d[i];
+		y[i] = xi + gFF * di;
+		z[i] = xi + gFB * di;
+	}
+}
+
+#ifdef CFILTERDELAY_X86
+__attribute__((target("avx2,fma")))
+static void _combSpanFMA(const float *x, const float *d, float *y, float *z,
+		uint32_t n, float gFF, float gFB) {
+	__m256 vff = _mm256_set1_ps(gFF);
+	__m256 vfb = _mm256_set1_ps(gFB);
+	uint32_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 vx = _mm256_loadu_ps(x + i);
+		__m256 vd = _mm256_loadu_ps(d + i);
+		_mm256_storeu_ps(y + i, _mm256_fmadd_ps(vff, vd, vx));
+		_mm256_storeu_ps(z + i, _mm256_fmadd_ps(vfb, vd, vx));
+	}
+	_combSpan(x + i, d + i, y + i, z + i, n - i, gFF, gFB);
+}
+#endif
+
+#ifdef CFILTERDELAY_NEON
+static void _combSpanNEON(const float *x, const float *d, float *y, float *z,
+		uint32_t n, float gFF, float gFB) {
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		float32x4_t vx = vld1q_f32(x + i);
+		float32x4_t vd = vld1q_f32(d + i);
+		vst1q_f32(y + i, vmlaq_n_f32(vx, vd, gFF));
+		vst1q_f32(z + i, vmlaq_n_f32(vx, vd, gFB));
+	}
+	_combSpan(x + i, d + i, y + i, z + i, n - i, gFF, gFB);
+}
+#endif
+
+uint32_t CFilterDelay::_maxDelayFrames(float delay_ms, float maxDelay_ms,
+		uint32_t fs) {
+	if (maxDelay_ms < delay_ms)
+		maxDelay_ms = delay_ms;
+	if (maxDelay_ms <= 0.)
+		return 0;
+	double frames = ceil((double) maxDelay_ms * fs / 1000.);
+	return (frames < MAX_DELAY_FRAMES) ? (uint32_t) frames : MAX_DELAY_FRAMES;
+}
+
+uint32_t CFilterDelay::_ringSize(uint32_t delay) {
+	uint32_t size = 1;
+	while (size < delay + CFILTERDELAY_INTERP_FRAMES)
+		size <<= 1;
+	return size;
+}
+
+CFilterDelay::CFilterDelay(float gFF, float gFB, float delay_ms, uint32_t fs,
+		uint16_t channels, float maxDelay_ms) :
+		CFilterBase(_maxDelayFrames(delay_ms, maxDelay_ms, fs), channels,
+				channels
+						* _ringSize(
+								_maxDelayFrames(delay_ms, maxDelay_ms, fs))) {
+	m_fs = fs;
+	m_maxDelay = m_order;
+	m_mask = _ringSize(m_maxDelay) - 1;
+	m_firstZ = 0;
+	m_blockMode = true;
+	m_fma = CSimd::hasAVX2FMA();
+	m_interp = INTERP_LINEAR;
+	m_apState = new float[m_channels];
+	for (int c = 0; c < m_channels; c++)
+		m_apState[c] = 0.;
+
+	m_lfoDepth = 0.;
+	m_lfoRate = 0.;
+	m_lfoCos = m_lfoRotCos = 1.;
+	m_lfoSin = m_lfoRotSin = 0.;
+
+	m_delayF = 0.;
+	m_gFF = m_gFB = 0.;
+	m_glideFrames = 0;
+	setParameters(delay_ms, gFF, gFB);
+
+	cout << "CFilterDelay@" << hex << this << dec << " created" << endl;
+}
+
+CFilterDelay::~CFilterDelay() {
+	delete[] m_apState;
+	cout << "CFilterDelay@" << hex << this << dec << " destroyed" << endl;
 }
 
 void CFilterDelay::reset() {
+	CFilterBase::reset();
+	m_firstZ = 0;
+	for (int c = 0; c < m_channels; c++)
+		m_apState[c] = 0.;
+	m_lfoCos = 1.;
+	m_lfoSin = 0.;
 }
 
 bool CFilterDelay::filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer) {
-	return false;
+	if ((inBuf == NULL) || (outBuf == NULL))
+		return false;
+
+	inBuf = _addDenormalOffset(inBuf, outBuf, framesPerBuffer);
+	// constant delay of full frames: no interpolation necessary
+	bool isStatic = (m_glideFrames == 0) && (m_lfoDepth == 0.)
+			&& ((m_interp == INTERP_NONE) || (m_delayF == (float) m_delay));
+	if (!isStatic)
+		_filterModulated(inBuf, outBuf, framesPerBuffer);
+	else if (m_blockMode && (m_delay >= CFILTERDELAY_MIN_SPAN))
+		_filterSpans(inBuf, outBuf, framesPerBuffer);
+	else
+		_filterFrames(inBuf, outBuf, framesPerBuffer);
+	return true;
+}
+
+void CFilterDelay::_filterFrames(float *inBuf, float *outBuf, uint32_t frames) {
+	uint32_t w = m_firstZ;
+	for (uint32_t k = 0; k < frames * m_channels; k += m_channels) {
+		// the ring buffer may be exactly D frames long: read before write
+		float *zr = m_z + ((w - m_delay) & m_mask) * m_channels;
+		float *zw = m_z + w * m_channels;
+		for (int c = 0; c < m_channels; c++) {
+			float x = inBuf[k + c];
+			float d = zr[c];
+			outBuf[k + c] = x + m_gFF * d;
+			zw[c] = x + m_gFB * d;
+		}
+		w = (w + 1) & m_mask;
+	}
+	m_firstZ = w;
+}
+
+void CFilterDelay::_filterSpans(float *inBuf, float *outBuf, uint32_t frames) {
+	uint32_t size = m_mask + 1;
+	uint32_t w = m_firstZ;
+	for (uint32_t k = 0; k < frames;) {
+		uint32_t r = (w - m_delay) & m_mask;
+		// longest span without wrap of read/write head and without feedback
+		uint32_t n = frames - k;
+		if (n > m_delay)
+			n = m_delay;
+		if (n > size - w)
+			n = size - w;
+		if (n > size - r)
+			n = size - r;
+
+		const float *x = inBuf + k * m_channels;
+		float *y = outBuf + k * m_channels;
+		float *zr = m_z + r * m_channels;
+		float *zw = m_z + w * m_channels;
+#ifdef CFILTERDELAY_X86
+		if (m_fma)
+			_combSpanFMA(x, zr, y, zw, n * m_channels, m_gFF, m_gFB);
+		else
+			_combSpan(x, zr, y, zw, n * m_channels, m_gFF, m_gFB);
+#elif defined(CFILTERDELAY_NEON)
+		_combSpanNEON(x, zr, y, zw, n * m_channels, m_gFF, m_gFB);
+#else
+		_combSpan(x, zr, y, zw, n * m_channels, m_gFF, m_gFB);
+#endif
+		k += n;
+		w = (w + n) & m_mask;
+	}
+	m_firstZ = w;
+}
+
+void CFilterDelay::_filterModulated(float *inBuf, float *outBuf,
+		uint32_t frames) {
+	float dMin = _limitDelay(0.), dMax = (float) m_maxDelay;
+	// local copies, the stores into the buffers could alias the members
+	float *z = m_z;
+	uint32_t mask = m_mask;
+	int channels = m_channels;
+	float delay = m_delayF, gFF = m_gFF, gFB = m_gFB;
+	float lfoDepth = m_lfoDepth, lfoCos = m_lfoCos, lfoSin = m_lfoSin;
+	uint32_t glideFrames = m_glideFrames;
+
+	uint32_t w = m_firstZ;
+	for (uint32_t k = 0; k < frames * channels; k += channels) {
+		if (glideFrames) {
+			if (--glideFrames == 0) {
+				delay = m_delayTarget;
+				gFF = m_gFFTarget;
+				gFB = m_gFBTarget;
+			} else {
+				delay += m_dDelay;
+				gFF += m_dFF;
+				gFB += m_dFB;
+			}
+		}
+		float D = delay;
+		if (lfoDepth != 0.) {
+			D += lfoDepth * lfoSin;
+			// rotate the phasor instead of calling sin() per frame
+			float cosNew = lfoCos * m_lfoRotCos - lfoSin * m_lfoRotSin;
+			lfoSin = lfoSin * m_lfoRotCos + lfoCos * m_lfoRotSin;
+			lfoCos = cosNew;
+		}
+		if (D < dMin)
+			D = dMin;
+		if (D > dMax)
+			D = dMax;
+
+		float *zw = z + w * channels;
+		uint32_t n;
+		switch (m_interp) {
+		case INTERP_NONE: {
+			n = (uint32_t) (D + 0.5f);
+			float *z0 = z + ((w - n) & mask) * channels;
+			for (int c = 0; c < channels; c++) {
+				float x = inBuf[k + c], d = z0[c];
+				outBuf[k + c] = x + gFF * d;
+				zw[c] = x + gFB * d;
+			}
+			break;
+		}
+		case INTERP_LINEAR: {
+			n = (uint32_t) D;
+			float f = D - n;
+			float *z0 = z + ((w - n) & mask) * channels;
+			float *z1 = z + ((w - n - 1) & mask) * channels;
+			for (int c = 0; c < channels; c++) {
+				float x = inBuf[k + c], d = z0[c] + f * (z1[c] - z0[c]);
+				outBuf[k + c] = x + gFF * d;
+				zw[c] = x + gFB * d;
+			}
+			break;
+		}
+		case INTERP_ALLPASS: {
+			// D = N + delta with 0.5 <= delta < 1.5 keeps the pole away from -1
+			n = (uint32_t) (D - 0.5f);
+			float f = D - n;
+			float eta = (1.f - f) / (1.f + f);
+			float *z0 = z + ((w - n) & mask) * channels;
+			float *z1 = z + ((w - n - 1) & mask) * channels;
+			for (int c = 0; c < channels; c++) {
+				float x = inBuf[k + c];
+				float d = eta * (z0[c] - m_apState[c]) + z1[c];
+				m_apState[c] = d;
+				outBuf[k + c] = x + gFF * d;
+				zw[c] = x + gFB * d;
+			}
+			break;
+		}
+		case INTERP_LAGRANGE: {
+			// taps at n-1..n+2, t is the position relative to tap n-1
+			n = (uint32_t) D;
+			float t = D - n + 1.f;
+			float h0 = -(t - 1.f) * (t - 2.f) * (t - 3.f) * (1.f / 6.f);
+			float h1 = t * (t - 2.f) * (t - 3.f) * 0.5f;
+			float h2 = -t * (t - 1.f) * (t - 3.f) * 0.5f;
+			float h3 = t * (t - 1.f) * (t - 2.f) * (1.f / 6.f);
+			float *z0 = z + ((w - n + 1) & mask) * channels;
+			float *z1 = z + ((w - n) & mask) * channels;
+			float *z2 = z + ((w - n - 1) & mask) * channels;
+			float *z3 = z + ((w - n - 2) & mask) * channels;
+			for (int c = 0; c < channels; c++) {
+				float x = inBuf[k + c];
+				float d = h0 * z0[c] + h1 * z1[c] + h2 * z2[c] + h3 * z3[c];
+				outBuf[k + c] = x + gFF * d;
+				zw[c] = x + gFB * d;
+			}
+			break;
+		}
+		}
+		w = (w + 1) & mask;
+	}
+	m_firstZ = w;
+	m_delayF = delay;
+	m_gFF = gFF;
+	m_gFB = gFB;
+	m_glideFrames = glideFrames;
+
+	// keep the LFO phasor on the unit circle
+	float r = sqrtf(lfoCos * lfoCos + lfoSin * lfoSin);
+	m_lfoCos = lfoCos / r;
+	m_lfoSin = lfoSin / r;
+
+	_updateDelay();
+}
+
+float CFilterDelay::_limitDelay(float delay) {
+	// the interpolators must not read the frame that is written
+	float dMin = 1.;
+	if (m_interp == INTERP_ALLPASS)
+		dMin = 1.5;
+	else if (m_interp == INTERP_LAGRANGE)
+		dMin = 2.;
+	if (delay < dMin)
+		delay = dMin;
+	if (delay > (float) m_maxDelay)
+		delay = (float) m_maxDelay;
+	return delay;
+}
+
+void CFilterDelay::_updateDelay() {
+	if (m_interp == INTERP_NONE)
+		m_delay = (uint32_t) (m_delayF + 0.5f);
+	else
+		m_delay = (uint32_t) m_delayF;
+}
+
+void CFilterDelay::setParameters(float delay_ms, float gFF, float gFB,
+		float glide_ms) {
+	m_delayTarget = _limitDelay((float) ((double) delay_ms * m_fs / 1000.));
+	m_delay_ms = (float) (m_delayTarget * 1000. / m_fs);
+	m_gFFTarget = gFF;
+	m_gFBTarget = gFB;
+
+	uint32_t glideFrames = 0;
+	if (glide_ms > 0.)
+		glideFrames = (uint32_t) ((double) glide_ms * m_fs / 1000.);
+	if (glideFrames == 0) {
+		m_delayF = m_delayTarget;
+		m_gFF = gFF;
+		m_gFB = gFB;
+	} else {
+		m_dDelay = (m_delayTarget - m_delayF) / glideFrames;
+		m_dFF = (gFF - m_gFF) / glideFrames;
+		m_dFB = (gFB - m_gFB) / glideFrames;
+	}
+	m_glideFrames = glideFrames;
+	_updateDelay();
+}
+
+void CFilterDelay::setModulation(float depth_ms, float rate_Hz) {
+	float depth = fabsf((float) ((double) depth_ms * m_fs / 1000.));
+	if (depth > (float) m_maxDelay)
+		depth = (float) m_maxDelay;
+	m_lfoDepth = depth;
+	m_lfoRate = rate_Hz;
+	m_lfoRotCos = cos(2. * M_PI * rate_Hz / m_fs);
+	m_lfoRotSin = sin(2. * M_PI * rate_Hz / m_fs);
+}
+
+void CFilterDelay::setInterpolation(INTERP interp) {
+	m_interp = interp;
+	m_delayF = _limitDelay(m_delayF);
+	m_delayTarget = _limitDelay(m_delayTarget);
+	for (int c = 0; c < m_channels; c++)
+		m_apState[c] = 0.;
+	_updateDelay();
+}
+
+CFilterDelay::INTERP CFilterDelay::getInterpolation() {
+	return m_interp;
 }
 
-uint16_t CFilterDelay::getDelay() {
-	return 0;
+void CFilterDelay::setBlockMode(bool blockMode) {
+	m_blockMode = blockMode;
+}
+
+bool CFilterDelay::getBlockMode() {
+	return m_blockMode;
+}
+
+float CFilterDelay::getDelay() {
+	return m_delay_ms;
+}
+
+float CFilterDelay::getDelayFrames() {
+	return m_delayF;
+}
+
+float CFilterDelay::getMaxDelay() {
+	return (float) (m_maxDelay * 1000. / m_fs);
+}
+
+float CFilterDelay::getDelayLimit(uint32_t fs) {
+	return (float) (MAX_DELAY_FRAMES * 1000. / fs);
+}
+
+float CFilterDelay::getModulationDepth() {
+	return (float) (m_lfoDepth * 1000. / m_fs);
+}
+
+float CFilterDelay::getModulationRate() {
+	return m_lfoRate;
+}
+
+uint32_t CFilterDelay::getSampleRate() {
+	return m_fs;
 }
 
 float CFilterDelay::getGainFF() {
-	return 0.;
+	return m_gFFTarget;
 }
 
 float CFilterDelay::getGainFB() {
-	return 0.;
+	return m_gFBTarget;
 }
-
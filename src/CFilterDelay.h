@@ -5,36 +5,294 @@
  * \date 11.09.2019
  * \author A. Wirth <antje.wirth@h-da.de
  */
-/************************************************************************
- *
- *	 					ATTENTION !!!!!!!!!
- *
- * This file contains only rudimentary code in a nonfunctional version
- * to make the start project compilable and executable in its initial version.
- *
- * It should be replaced by an complete implementation.
- *
- ************************************************************************/
 #ifndef CFILTERDELAY_H_
 #define CFILTERDELAY_H_
 
 #include "CFilterBase.h"
 
+/**
+ * \brief comb filter / echo with feed forward and feedback path
+ *
+ * y(k) = x(k) + gFF*d(k) with d(k) = w(k-D) and w(k) = x(k) + gFB*d(k)
+ *
+ * which is the difference equation of
+ * H(z) = (1 + (gFF-gFB)*z^-D) / (1 - gFB*z^-D)
+ *
+ * w is stored in a circular buffer (m_z) with a power of 2 length, the frames
+ * of all channels are interleaved like in the signal buffers. The write head
+ * is m_firstZ, the read head is D frames behind. The cost per sample is
+ * constant and independent of the delay.
+ *
+ * In block mode (default) a buffer is split into spans of contiguous frames
+ * that neither cross the end of the circular buffer (read or write head) nor
+ * exceed the delay D. Within such a span the read values do not depend on
+ * values written in the same span, therefore the feedback stays exact and the
+ * span is processed by a vectorized (FMA) kernel as flat arrays of
+ * frames*channels samples.
+ *
+ * The circular buffer is sized for a maximum delay at construction. Within
+ * this limit the delay may be fractional (interpolated read), the delay and
+ * the gains may glide to new values and the delay may be modulated by a sine
+ * LFO (chorus, flanger) without any reallocation. As long as one of these is
+ * active the filter is processed frame by frame.
+ */
 class CFilterDelay: public CFilterBase {
+public:
+	/**
+	 * \brief interpolation of fractional delays
+	 */
+	enum INTERP {
+		INTERP_NONE,	///< delay rounded to full frames
+		INTERP_LINEAR,	///< linear interpolation of 2 frames
+		INTERP_ALLPASS,	///< first order allpass (Thiran), for constant delays
+		INTERP_LAGRANGE	///< third order Lagrange interpolation of 4 frames
+	};
+	/**
+	 * \brief largest maximum delay in frames (circular buffer of at most 4M frames)
+	 */
+	static const uint32_t MAX_DELAY_FRAMES = (1 << 22) - 4;
+
 private:
+	/**
+	 * \brief feed forward gain (linear)
+	 */
 	float m_gFF;
+	/**
+	 * \brief feedback gain (linear)
+	 */
 	float m_gFB;
-	uint16_t m_firstZ;
-	uint16_t m_delay_ms;
+	/**
+	 * \brief write position (frame index) in the circular buffer
+	 */
+	uint32_t m_firstZ;
+	/**
+	 * \brief delay in milliseconds (target value of a glide)
+	 */
+	float m_delay_ms;
+	/**
+	 * \brief current delay in frames (may be fractional)
+	 */
+	float m_delayF;
+	/**
+	 * \brief delay D in full frames (valid if m_delayF is a whole number)
+	 */
+	uint32_t m_delay;
+	/**
+	 * \brief maximum delay in frames
+	 */
+	uint32_t m_maxDelay;
+	/**
+	 * \brief length of the circular buffer in frames - 1
+	 */
+	uint32_t m_mask;
+	/**
+	 * \brief sampling frequency
+	 */
+	uint32_t m_fs;
+	/**
+	 * \brief true: process contiguous spans, false: process frame by frame
+	 */
+	bool m_blockMode;
+	/**
+	 * \brief the CPU supports the AVX2/FMA span kernel
+	 */
+	bool m_fma;
+	/**
+	 * \brief interpolation of fractional delays
+	 */
+	INTERP m_interp;
+	/**
+	 * \brief output of the allpass interpolator per channel
+	 */
+	float *m_apState;
+	/**
+	 * \brief remaining frames of a glide
+	 */
+	uint32_t m_glideFrames;
+	/**
+	 * \brief increments per frame of delay (frames) and gains during a glide
+	 */
+	float m_dDelay, m_dFF, m_dFB;
+	/**
+	 * \brief target values of a glide (delay in frames)
+	 */
+	float m_delayTarget, m_gFFTarget, m_gFBTarget;
+	/**
+	 * \brief modulation depth in frames (0: no modulation)
+	 */
+	float m_lfoDepth;
+	/**
+	 * \brief modulation rate in Hz
+	 */
+	float m_lfoRate;
+	/**
+	 * \brief LFO phasor (cos, sin) and its rotation per frame
+	 */
+	float m_lfoCos, m_lfoSin, m_lfoRotCos, m_lfoRotSin;
 
 public:
-	CFilterDelay(float gff, float gFB, uint16_t delay_ms, uint32_t fs, uint16_t channels = 2);
+	/**
+	 * \brief Constructor
+	 *
+	 * - creates the circular buffer for the maximum delay
+	 * - throws exception if the maximum delay (in samples) or channels are zero
+	 *
+	 * \param gFF feed forward gain (linear)
+	 * \param gFB feedback gain (linear, 0 <= gFB < 1)
+	 * \param delay_ms delay in milliseconds (may be fractional)
+	 * \param fs sampling frequency of the signal
+	 * \param channels number of channels of the signal
+	 * \param maxDelay_ms maximum delay that may be set later (default: delay_ms)
+	 */
+	CFilterDelay(float gFF, float gFB, float delay_ms, uint32_t fs,
+			uint16_t channels = 2, float maxDelay_ms = 0.);
+	/**
+	 * \brief Destructor
+	 */
+	virtual ~CFilterDelay();
+	/**
+	 * \brief clears the circular buffer
+	 */
 	void reset();
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
 	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
-	uint16_t getDelay();
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+	/**
+	 * \brief switches between block mode and frame by frame processing
+	 *
+	 * Both modes deliver the same output (up to rounding of the FMA) and
+	 * share the state, the mode may be changed between two blocks.
+	 * Delays shorter than a few frames are always processed frame by frame.
+	 *
+	 * \param blockMode true: block mode, false: frame by frame
+	 */
+	void setBlockMode(bool blockMode);
+	/**
+	 * \brief gets the processing mode
+	 * \return true: block mode, false: frame by frame
+	 */
+	bool getBlockMode();
+	/**
+	 * \brief changes delay and gains, optionally with a linear glide
+	 *
+	 * No memory is allocated, the delay is limited to the maximum delay of
+	 * the constructor (minus the modulation depth).
+	 *
+	 * \param delay_ms new delay in milliseconds
+	 * \param gFF new feed forward gain (linear)
+	 * \param gFB new feedback gain (linear, 0 <= gFB < 1)
+	 * \param glide_ms duration of the glide in milliseconds (0: immediately)
+	 */
+	void setParameters(float delay_ms, float gFF, float gFB, float glide_ms =
+			0.);
+	/**
+	 * \brief sets the modulation of the delay by a sine LFO
+	 *
+	 * D(k) = D + depth*sin(2*pi*rate*k/fs)
+	 *
+	 * \param depth_ms modulation depth in milliseconds (0: no modulation)
+	 * \param rate_Hz modulation frequency in Hz
+	 */
+	void setModulation(float depth_ms, float rate_Hz);
+	/**
+	 * \brief selects the interpolation of fractional delays
+	 * \param interp interpolation
+	 */
+	void setInterpolation(INTERP interp);
+	/**
+	 * \brief gets the interpolation of fractional delays
+	 * \return interpolation
+	 */
+	INTERP getInterpolation();
+	/**
+	 * \brief gets the delay
+	 * \return delay in milliseconds (target value of a glide)
+	 */
+	float getDelay();
+	/**
+	 * \brief gets the current delay
+	 * \return delay in frames (may be fractional)
+	 */
+	float getDelayFrames();
+	/**
+	 * \brief gets the maximum delay
+	 * \return maximum delay in milliseconds
+	 */
+	float getMaxDelay();
+	/**
+	 * \brief gets the largest maximum delay a filter can be created with
+	 * \param fs sampling frequency of the signal
+	 * \return delay in milliseconds (MAX_DELAY_FRAMES)
+	 */
+	static float getDelayLimit(uint32_t fs);
+	/**
+	 * \brief gets the modulation depth
+	 * \return depth in milliseconds
+	 */
+	float getModulationDepth();
+	/**
+	 * \brief gets the modulation rate
+	 * \return rate in Hz
+	 */
+	float getModulationRate();
+	/**
+	 * \brief gets the sampling frequency the filter was created for
+	 * \return sampling frequency in Hz
+	 */
+	uint32_t getSampleRate();
+	/**
+	 * \brief gets the feed forward gain
+	 * \return linear gain (target value of a glide)
+	 */
 	float getGainFF();
+	/**
+	 * \brief gets the feedback gain
+	 * \return linear gain (target value of a glide)
+	 */
 	float getGainFB();
+
+private:
+	/**
+	 * \brief frame by frame processing of a constant delay of full frames (reference)
+	 */
+	void _filterFrames(float *inBuf, float *outBuf, uint32_t frames);
+	/**
+	 * \brief block mode processing of a constant delay of full frames (contiguous spans)
+	 */
+	void _filterSpans(float *inBuf, float *outBuf, uint32_t frames);
+	/**
+	 * \brief frame by frame processing with fractional, gliding or modulated delay
+	 */
+	void _filterModulated(float *inBuf, float *outBuf, uint32_t frames);
+	/**
+	 * \brief limits a delay in frames to the range that can be read
+	 */
+	float _limitDelay(float delay);
+	/**
+	 * \brief updates m_delay from m_delayF
+	 */
+	void _updateDelay();
+	/**
+	 * \brief converts the maximum delay into frames (without 16 bit overflow)
+	 * \return maximum delay in frames (rounded up, at most MAX_DELAY_FRAMES)
+	 */
+	static uint32_t _maxDelayFrames(float delay_ms, float maxDelay_ms,
+			uint32_t fs);
+	/**
+	 * \brief length of the circular buffer for a maximum delay
+	 * \return power of 2 > delay + frames needed by the interpolation
+	 */
+	static uint32_t _ringSize(uint32_t delay);
 };
 
 #endif /* CFILTERDELAY_H_ */
-
@@ -0,0 +1,132 @@
+/**
+ * \file CFilterDerivation.cpp
+ * \brief implementation CFilterDerivation
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "CPolynomial.h"
+#include "CFilterDerivation.h"
+
+/*
+ * frequency bins of the comparison of re-warped and stored sections
+ */
+#define CFILTERDERIVATION_BINS 512
+
+/*
+ * c(u) = sum ci N(u)^i D(u)^(order-i), pN[i] = N^i, pD[j] = D^j (each with
+ * order+1 coefficients)
+ */
+static void substitute(const double *c, int order, const double *pN,
+		const double *pD, double *out) {
+	int len = order + 1;
+	for (int m = 0; m <= order; m++)
+		out[m] = 0.;
+	for (int i = 0; i <= order; i++) {
+		if (c[i] == 0.)
+			continue;
+		const double *n = pN + i * len, *d = pD + (order - i) * len;
+		// product of N^i (degree i) and D^(order-i) (degree order-i)
+		for (int p = 0; p <= i; p++)
+			for (int q = 0; q <= order - i; q++)
+				out[p + q] += c[i] * n[p] * d[q];
+	}
+}
+
+/*
+ * powers of the linear polynomial c0 + c1*u: pPow[i*len ... i*len+i]
+ */
+static void powers(double c0, double c1, int order, double *pPow) {
+	int len = order + 1;
+	for (int m = 0; m < len * len; m++)
+		pPow[m] = 0.;
+	pPow[0] = 1.;
+	for (int i = 1; i <= order; i++) {
+		const double *prev = pPow + (i - 1) * len;
+		double *cur = pPow + i * len;
+		for (int m = 0; m < i; m++) {
+			cur[m] += c0 * prev[m];
+			cur[m + 1] += c1 * prev[m];
+		}
+	}
+}
+
+bool CFilterDerivation::rewarp(const double *b, const double *a, int order,
+		double fsFrom, double fsTo, double fWarp, double *bOut, double *aOut) {
+	if ((order < 0) || (order > MAX_REWARP_ORDER) || (fsFrom <= 0.)
+			|| (fsTo <= 0.))
+		return false;
+
+	// (z0-1)/(z0+1) = k (z-1)/(z+1), on the unit circle j*tan(pi f/fs)
+	double k = fsTo / fsFrom;
+	if ((fWarp > 0.) && (fWarp < 0.45 * fmin(fsFrom, fsTo)))
+		k = tan(M_PI * fWarp / fsFrom) / tan(M_PI * fWarp / fsTo);
+
+	int len = order + 1;
+	double *pN = new double[2 * len * len], *pD = pN + len * len;
+	powers(1. - k, 1. + k, order, pN);
+	powers(1. + k, 1. - k, order, pD);
+	substitute(b, order, pN, pD, bOut);
+	substitute(a, order, pN, pD, aOut);
+	delete[] pN;
+
+	double a0 = aOut[0];
+	bool ok = (a0 != 0.) && isfinite(a0);
+	for (int i = 0; ok && (i <= order); i++) {
+		bOut[i] /= a0;
+		aOut[i] /= a0;
+		ok = isfinite(bOut[i]) && isfinite(aOut[i]);
+	}
+	return ok;
+}
+
+double CFilterDerivation::rewarpDeviation(const double *b, const double *a,
+		int order, double fsFrom, const double *bRef, const double *aRef,
+		double fsRef, double fWarp) {
+	if ((order < 0) || (order > MAX_REWARP_ORDER))
+		return HUGE_VAL;
+	double *bOut = new double[2 * (order + 1)], *aOut = bOut + order + 1;
+	double maxDev = HUGE_VAL;
+	if (rewarp(b, a, order, fsFrom, fsRef, fWarp, bOut, aOut)) {
+		maxDev = 0.;
+		for (int k = 0; k <= CFILTERDERIVATION_BINS; k++) {
+			complex<double> w = polar(1., -M_PI * k / CFILTERDERIVATION_BINS);
+			double ref = 20. * log10(abs(CPolynomial::evalInv(bRef, order, w)
+					/ CPolynomial::evalInv(aRef, order, w)));
+			if (!(ref > DEVIATION_FLOOR_DB))
+				continue;
+			double mag = 20. * log10(abs(CPolynomial::evalInv(bOut, order, w)
+					/ CPolynomial::evalInv(aOut, order, w)));
+			double dev = fabs(mag - ref);
+			if (!(dev <= maxDev))
+				maxDev = isnan(dev) ? HUGE_VAL : dev;
+		}
+	}
+	delete[] bOut;
+	return maxDev;
+}
+
+int CFilterDerivation::scaleTaps(const double *b, const double *a, int order,
+		double fsFrom, double fsTo, double *&bOut, double *&aOut) {
+	double ratio = fsTo / fsFrom;
+	int newOrder = (int) lround(order * ratio);
+	if ((newOrder < 1) && (order > 0))
+		newOrder = 1;
+	bOut = new double[newOrder + 1];
+	aOut = new double[newOrder + 1];
+	for (int i = 0; i <= newOrder; i++)
+		bOut[i] = aOut[i] = 0.;
+	for (int i = 0; i <= order; i++) {
+		int m = (int) lround(i * ratio);
+		if (m > newOrder)
+			m = newOrder;
+		bOut[m] += b[i];
+		// a0 stays at position 0, a recursive tap must not collapse onto it
+		if ((i > 0) && (m == 0))
+			m = 1;
+		aOut[m] += a[i];
+	}
+	return newOrder;
+}
@@ -0,0 +1,102 @@
+/**
+ * \file CFilterDerivation.h
+ * \brief interface CFilterDerivation
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERDERIVATION_H_
+#define CFILTERDERIVATION_H_
+
+/**
+ * \brief derivation of filter coefficients for another sampling frequency
+ *
+ * - recursive and short filters: bilinear re-warping, the analog prototype
+ *   of the filter (inverse bilinear transform at the stored sampling
+ *   frequency) is transformed again at the new sampling frequency. Both
+ *   steps are done at once by the substitution
+ *   z0^-1 = ((1-k) + (1+k) z^-1) / ((1+k) + (1-k) z^-1)
+ *   with k = tan(pi f/fs0) / tan(pi f/fs), i.e. the response at the warping
+ *   frequency f (e.g. the cutoff frequency) is kept exactly, the order does
+ *   not change. Filters designed by the bilinear transform with prewarping
+ *   at f (Butterworth, Chebyshev, ...) are reproduced. Other designs (e.g.
+ *   least squares fits like Yule-Walker) are not: their sections for
+ *   different sampling frequencies are no bilinear images of each other.
+ *   rewarpDeviation() checks this by re-warping a stored section to the
+ *   sampling frequency of another stored section.
+ * - sparse filters (delay lines): the tap positions are scaled by fs/fs0,
+ *   the delay times are kept, the order changes.
+ *
+ * The class provides static methods only.
+ */
+class CFilterDerivation {
+public:
+	/**
+	 * \brief highest order for the re-warping (the expansion of the
+	 * substitution loses precision for higher orders)
+	 */
+	static const int MAX_REWARP_ORDER = 32;
+	/**
+	 * \brief largest deviation (dB) of a re-warped section from a stored
+	 * section for which the design counts as re-warpable
+	 */
+	static constexpr double MAX_REWARP_DEVIATION_DB = 0.25;
+	/**
+	 * \brief magnitudes below this level (dB) are not compared
+	 */
+	static constexpr double DEVIATION_FLOOR_DB = -60.;
+
+	/**
+	 * \brief bilinear re-warping of filter coefficients
+	 *
+	 * \param b numerator coefficients (order+1)
+	 * \param a denominator coefficients (order+1)
+	 * \param order filter order (at most MAX_REWARP_ORDER)
+	 * \param fsFrom sampling frequency of the coefficients
+	 * \param fsTo new sampling frequency
+	 * \param fWarp frequency whose response is kept (0 or not below both
+	 * Nyquist frequencies: the analog frequencies are kept)
+	 * \param bOut [out] numerator coefficients (order+1, normalized by a0)
+	 * \param aOut [out] denominator coefficients (order+1, aOut[0] = 1)
+	 * \return false if the order is too high or the result is not finite
+	 */
+	static bool rewarp(const double *b, const double *a, int order,
+			double fsFrom, double fsTo, double fWarp, double *bOut,
+			double *aOut);
+	/**
+	 * \brief re-warps a section to the sampling frequency of a reference
+	 * section and compares the magnitude responses
+	 *
+	 * \param b numerator coefficients (order+1)
+	 * \param a denominator coefficients (order+1)
+	 * \param order filter order of both sections
+	 * \param fsFrom sampling frequency of the coefficients
+	 * \param bRef numerator coefficients of the reference (order+1)
+	 * \param aRef denominator coefficients of the reference (order+1)
+	 * \param fsRef sampling frequency of the reference
+	 * \param fWarp frequency whose response is kept (see rewarp())
+	 * \return largest deviation in dB (where the reference is above
+	 * DEVIATION_FLOOR_DB), HUGE_VAL if the section can't be re-warped
+	 */
+	static double rewarpDeviation(const double *b, const double *a, int order,
+			double fsFrom, const double *bRef, const double *aRef,
+			double fsRef, double fWarp);
+	/**
+	 * \brief scales the tap positions of a sparse filter
+	 *
+	 * coefficients moved to the same position are added
+	 *
+	 * \param b numerator coefficients (order+1)
+	 * \param a denominator coefficients (order+1)
+	 * \param order filter order
+	 * \param fsFrom sampling frequency of the coefficients
+	 * \param fsTo new sampling frequency
+	 * \param bOut [out] new numerator coefficients (allocated by new[])
+	 * \param aOut [out] new denominator coefficients (allocated by new[])
+	 * \return new order
+	 */
+	static int scaleTaps(const double *b, const double *a, int order,
+			double fsFrom, double fsTo, double *&bOut, double *&aOut);
+};
+
+#endif /* CFILTERDERIVATION_H_ */
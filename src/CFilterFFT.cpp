@@ -0,0 +1,196 @@
+/**
+ * \file CFilterFFT.cpp
+ * \brief implementation CFilterFFT
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <math.h>
+#include <string.h>
+#include <SKSLib.h>
+#include "CFilterFFT.h"
+
+CFilterFFT::CFilterFFT(const string &filePath, float *cb, uint32_t order,
+		uint16_t channels, uint32_t partSize) :
+		CFilterBase(order, channels, 0) {
+	m_filePath = filePath;
+	if (cb == NULL)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter coefficients not available!");
+
+	uint32_t numTaps = m_order + 1;
+	// first partition: balance the direct convolution (P0 multiply-adds per
+	// sample) against the transforms of the first segment
+	if ((partSize == 0) || ((partSize & (partSize - 1)) != 0))
+		partSize = 64;
+	m_partSize = partSize;
+
+	// segments: partitions 1...3 of size P0, then partitions 2 and 3 of twice
+	// the size of the previous segment (offset 4*B = 2*(2B)), the last segment
+	// ends with the partition containing the last tap
+	m_numSegments = 0;
+	for (uint32_t B = m_partSize, offset = m_partSize; offset < numTaps;
+			B <<= 1, offset = 4 * (B >> 1))
+		m_numSegments++;
+	m_segments = new SEGMENT[m_numSegments];
+	m_maxSize = m_partSize;
+	for (uint32_t s = 0; s < m_numSegments; s++) {
+		SEGMENT &seg = m_segments[s];
+		uint32_t B = m_partSize << s, bins = B + 1;
+		seg.size = B;
+		seg.first = (s == 0) ? 1 : 2;
+		uint32_t end = (numTaps + B - 1) / B;
+		seg.numParts = ((end < 4) ? end : 4) - seg.first;
+		seg.depth = seg.first + seg.numParts - 1;
+		seg.fft = new CFFT(2 * B);
+		seg.H = new complex<float>[seg.numParts * bins];
+		seg.X = new complex<float>[m_channels * seg.depth * bins];
+		seg.in = new float[m_channels * 2 * B];
+		seg.tail = new float[m_channels * B];
+		m_maxSize = B;
+	}
+	m_head = new float[m_partSize];
+	m_in = new float[m_channels * 2 * m_partSize];
+	m_work = new float[2 * m_maxSize];
+	m_acc = new complex<float>[m_maxSize + 1];
+
+	// first partition in the time domain (reversed), all others as spectra
+	uint32_t numHead = (numTaps < m_partSize) ? numTaps : m_partSize;
+	for (uint32_t k = 0; k < numHead; k++)
+		m_head[k] = cb[numHead - 1 - k];
+	for (uint32_t s = 0; s < m_numSegments; s++) {
+		SEGMENT &seg = m_segments[s];
+		uint32_t B = seg.size;
+		for (uint32_t p = 0; p < seg.numParts; p++) {
+			for (uint32_t k = 0; k < 2 * B; k++) {
+				uint32_t tap = (seg.first + p) * B + k;
+				m_work[k] = ((k < B) && (tap < numTaps)) ? cb[tap] : 0.f;
+			}
+			seg.fft->forward(m_work, seg.H + p * (B + 1));
+		}
+	}
+	reset();
+
+	cout << "CFilterFFT@" << hex << this << dec << " created" << endl;
+}
+
+CFilterFFT::~CFilterFFT() {
+	for (uint32_t s = 0; s < m_numSegments; s++) {
+		SEGMENT &seg = m_segments[s];
+		delete seg.fft;
+		delete[] seg.H;
+		delete[] seg.X;
+		delete[] seg.in;
+		delete[] seg.tail;
+	}
+	delete[] m_segments;
+	delete[] m_head;
+	delete[] m_in;
+	delete[] m_work;
+	delete[] m_acc;
+	cout << "CFilterFFT@" << hex << this << dec << " destroyed" << endl;
+}
+
+void CFilterFFT::reset() {
+	memset(m_in, 0, m_channels * 2 * m_partSize * sizeof(float));
+	for (uint32_t s = 0; s < m_numSegments; s++) {
+		SEGMENT &seg = m_segments[s];
+		uint32_t B = seg.size;
+		memset(seg.in, 0, m_channels * 2 * B * sizeof(float));
+		memset(seg.tail, 0, m_channels * B * sizeof(float));
+		for (uint32_t i = 0; i < m_channels * seg.depth * (B + 1); i++)
+			seg.X[i] = 0.f;
+		seg.xPos = 0;
+	}
+	m_pos = 0;
+}
+
+bool CFilterFFT::filter(float *x, float *y, uint16_t framesPerBuffer) {
+	if ((x == NULL) || (y == NULL))
+		return false;
+
+	uint32_t P = m_partSize;
+	uint32_t numHead = ((uint32_t) m_order + 1 < P) ? m_order + 1 : P;
+	for (int f = 0; f < framesPerBuffer; f++) {
+		uint32_t headPos = m_pos & (P - 1);
+		for (int c = 0; c < m_channels; c++) {
+			float sample = x[f * m_channels + c];
+			float *in = m_in + c * 2 * P + P + headPos;
+			*in = sample;
+			// first partition: direct convolution with the last P samples
+			// (taps reversed to run forward through memory), 8 partial sums
+			// break the dependency chain of the additions
+			const float *hist = in - (numHead - 1);
+			float acc[8] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+			uint32_t k = 0;
+			for (; k + 8 <= numHead; k += 8)
+				for (int j = 0; j < 8; j++)
+					acc[j] += m_head[k + j] * hist[k + j];
+			for (; k < numHead; k++)
+				acc[0] += m_head[k] * hist[k];
+			float out = ((acc[0] + acc[1]) + (acc[2] + acc[3]))
+					+ ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+			// all other partitions: contribution calculated by the segments
+			for (uint32_t s = 0; s < m_numSegments; s++) {
+				SEGMENT &seg = m_segments[s];
+				uint32_t B = seg.size, pos = m_pos & (B - 1);
+				seg.in[c * 2 * B + B + pos] = sample;
+				out += seg.tail[c * B + pos];
+			}
+			y[f * m_channels + c] = out;
+		}
+		m_pos = (m_pos + 1) & (m_maxSize - 1);
+		if ((m_pos & (P - 1)) == 0) {
+			// the completed block becomes the previous block
+			for (int c = 0; c < m_channels; c++)
+				memcpy(m_in + c * 2 * P, m_in + c * 2 * P + P,
+						P * sizeof(float));
+		}
+		for (uint32_t s = 0; s < m_numSegments; s++)
+			if ((m_pos & (m_segments[s].size - 1)) == 0)
+				_nextBlock(m_segments[s]);
+	}
+	return true;
+}
+
+void CFilterFFT::_nextBlock(SEGMENT &seg) {
+	uint32_t B = seg.size, bins = B + 1, D = seg.depth;
+
+	seg.xPos = (seg.xPos + 1) % D;
+	for (int c = 0; c < m_channels; c++) {
+		float *in = seg.in + c * 2 * B;
+		complex<float> *X = seg.X + c * D * bins;
+
+		// spectrum of the previous and the completed block (overlap-save)
+		seg.fft->forward(in, X + seg.xPos * bins);
+
+		// partition q is applied to the input block q-1 blocks before the newest
+		// (complex arrays accessed as float arrays re,im,re,im,... to allow vectorization)
+		float *acc = reinterpret_cast<float*>(m_acc);
+		for (uint32_t k = 0; k < 2 * bins; k++)
+			acc[k] = 0.f;
+		for (uint32_t p = 0; p < seg.numParts; p++) {
+			uint32_t q = seg.first + p;
+			const float *Hp = reinterpret_cast<const float*>(seg.H + p * bins);
+			const float *Xp = reinterpret_cast<const float*>(X
+					+ ((seg.xPos + D - (q - 1)) % D) * bins);
+			for (uint32_t k = 0; k < 2 * bins; k += 2) {
+				acc[k] += Hp[k] * Xp[k] - Hp[k + 1] * Xp[k + 1];
+				acc[k + 1] += Hp[k] * Xp[k + 1] + Hp[k + 1] * Xp[k];
+			}
+		}
+		seg.fft->inverse(m_acc, m_work);
+		memcpy(seg.tail + c * B, m_work + B, B * sizeof(float));
+
+		// the completed block becomes the previous block
+		memcpy(in, in + B, B * sizeof(float));
+	}
+}
+
+uint32_t CFilterFFT::getPartitionSize() {
+	return m_partSize;
+}
+
+string CFilterFFT::getFilePath() {
+	return m_filePath;
+}
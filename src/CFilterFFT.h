@@ -0,0 +1,160 @@
+/**
+ * \file CFilterFFT.h
+ * \brief interface CFilterFFT
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERFFT_H_
+#define CFILTERFFT_H_
+#include <complex>
+#include "CFilterBase.h"
+#include "CFFT.h"
+
+/**
+ * \brief FIR filter calculated by non-uniformly partitioned fast convolution (overlap-save)
+ *
+ * The first P0 taps of the impulse response (numerator coefficients b) are
+ * calculated directly in the time domain, so the filter has no latency. The
+ * remaining taps are split into segments of partitions whose size B doubles
+ * from segment to segment: partitions 1...3 of size P0, then partitions 2 and
+ * 3 of size 2*P0, 4*P0, ... A partition of size B is calculated with the
+ * latency of one block of B frames, which is hidden by its offset of at least
+ * B taps. The partitions are transformed once by the constructor. Whenever B
+ * frames of the input signal are complete, their spectrum is stored in the
+ * frequency domain delay line of the segment and the contribution of its
+ * partitions to the next B output frames is calculated by spectral
+ * multiplication and one inverse FFT (overlap-save).
+ *
+ * The number of segments is about log2((order+1)/P0). The cost per sample is
+ * P0 multiply-adds plus, per segment of size B, about 3 complex multiply-adds
+ * and 2*log2(2B) FFT operations, i.e. O(log(order)) multiply-adds and
+ * O(log(order)^2) FFT operations instead of order+1 multiply-adds of the
+ * direct form. A segment is calculated by the frame completing its block, so
+ * the cost of a call to filter() varies with the number of segments completed.
+ */
+class CFilterFFT: public CFilterBase {
+public:
+	/**
+	 * \brief minimum order for which _createFilter() uses the fast convolution
+	 */
+	static const uint16_t MIN_ORDER = 256;
+
+private:
+	/**
+	 * \brief partitions of equal size
+	 */
+	struct SEGMENT {
+		uint32_t size;			///< partition size B (frames), FFT size is 2B
+		uint32_t first;			///< index of the first partition (tap offset first*B)
+		uint32_t numParts;		///< number of partitions
+		uint32_t depth;			///< number of spectra in the delay line (first+numParts-1)
+		complex<float> *H;		///< spectra of the partitions (B+1 bins each)
+		complex<float> *X;		///< delay line: spectra of the last input blocks of all channels (ring buffer)
+		uint32_t xPos;			///< index of the newest spectrum in X
+		float *in;				///< previous and current block of each channel (2B per channel)
+		float *tail;			///< contribution of the partitions to the current block (B per channel)
+		CFFT *fft;				///< transform of size 2B
+	};
+
+	/**
+	 * \brief size of the directly calculated first partition P0 (frames)
+	 */
+	uint32_t m_partSize;
+	/**
+	 * \brief taps of the first partition (time domain, reversed)
+	 */
+	float *m_head;
+	/**
+	 * \brief input samples for the first partition (2*P0 per channel)
+	 */
+	float *m_in;
+	/**
+	 * \brief segments of the remaining taps (partition size doubles)
+	 */
+	SEGMENT *m_segments;
+	/**
+	 * \brief number of segments
+	 */
+	uint32_t m_numSegments;
+	/**
+	 * \brief position of the next frame in the block of the largest partition
+	 * (the position in the blocks of all others is given by its low order bits)
+	 */
+	uint32_t m_pos;
+	/**
+	 * \brief size of the largest partition
+	 */
+	uint32_t m_maxSize;
+	/**
+	 * \brief spectrum accumulator (bins of the largest partition)
+	 */
+	complex<float> *m_acc;
+	/**
+	 * \brief time domain work buffer (2 * largest partition)
+	 */
+	float *m_work;
+	/*
+	 * filter file path
+	 */
+	string m_filePath;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * - splits the impulse response into segments of partitions and transforms them
+	 * - throws exception if order or channels are zero or if the coefficients are missing
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param cb pointer to array of numerator filter coefficients (order+1 taps)
+	 * \param order filter order
+	 * \param channels number of channels of original signal
+	 * \param partSize size of the directly calculated first partition (power of 2), 0: default
+	 */
+	CFilterFFT(const string &filePath, float *cb, uint32_t order,
+			uint16_t channels = 2, uint32_t partSize = 0);
+	/**
+	 * \brief deletes partitions, buffers and transforms
+	 */
+	virtual ~CFilterFFT();
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+	/**
+	 * \brief clears input history and delay lines
+	 */
+	void reset();
+	/**
+	 * \brief gets the size of the first partition
+	 * \return partition size in frames
+	 */
+	uint32_t getPartitionSize();
+
+	/**
+	 * \brief gets full qualified pathname of the filter file
+	 * \return path of filter file
+	 */
+	string getFilePath();
+
+private:
+	/**
+	 * \brief transforms the completed input block of each channel and calculates
+	 * the contribution of the segment to the next block
+	 *
+	 * \param seg segment whose input block is complete
+	 */
+	void _nextBlock(SEGMENT &seg);
+};
+
+#endif /* CFILTERFFT_H_ */
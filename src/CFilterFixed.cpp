@@ -0,0 +1,68 @@
+/**
+ * \file CFilterFixed.cpp
+ * \brief implementation CFilterFixedFactory
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <SKSLib.h>
+#include "CFilter.h"
+#include "CFilterFixed.h"
+
+/*
+ * specialization for the given order and the number of channels
+ */
+template<int Order>
+static CFilterBase* _createFixed(const string &filePath, float *ca, float *cb,
+		uint16_t channels) {
+	switch (channels) {
+	case 1:
+		return new CFilterFixed<Order, 1>(filePath, ca, cb);
+	case 2:
+		return new CFilterFixed<Order, 2>(filePath, ca, cb);
+	default:
+		return NULL;
+	}
+}
+
+CFilterBase* CFilterFixedFactory::create(const string &filePath, float *ca,
+		float *cb, uint16_t order, uint16_t channels) {
+	CFilterBase *pFilter = NULL;
+	switch (order) {
+	case 1:
+		pFilter = _createFixed<1>(filePath, ca, cb, channels);
+		break;
+	case 2:
+		pFilter = _createFixed<2>(filePath, ca, cb, channels);
+		break;
+	case 3:
+		pFilter = _createFixed<3>(filePath, ca, cb, channels);
+		break;
+	case 4:
+		pFilter = _createFixed<4>(filePath, ca, cb, channels);
+		break;
+	case 5:
+		pFilter = _createFixed<5>(filePath, ca, cb, channels);
+		break;
+	case 6:
+		pFilter = _createFixed<6>(filePath, ca, cb, channels);
+		break;
+	case 7:
+		pFilter = _createFixed<7>(filePath, ca, cb, channels);
+		break;
+	case 8:
+		pFilter = _createFixed<8>(filePath, ca, cb, channels);
+		break;
+	default:
+		break;
+	}
+	// generic class for all other combinations
+	if (pFilter == NULL)
+		pFilter = new CFilter(filePath, ca, cb, order, channels);
+	return pFilter;
+}
+
+bool CFilterFixedFactory::isSpecialized(uint16_t order, uint16_t channels) {
+	return (order >= 1) && (order <= MAX_ORDER) && (channels >= 1)
+			&& (channels <= MAX_CHANNELS);
+}
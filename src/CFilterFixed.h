@@ -0,0 +1,184 @@
+/**
+ * \file CFilterFixed.h
+ * \brief interface and implementation CFilterFixed (template)
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERFIXED_H_
+#define CFILTERFIXED_H_
+
+#include <SKSLib.h>
+#include "CFilterBase.h"
+
+/**
+ * \brief direct form II transposed filter with order and number of channels
+ * known at compile time
+ *
+ * All loops over the states and channels have constant bounds and are
+ * unrolled by the compiler. The coefficients and the states of all channels
+ * are copied into local arrays for a block, so they stay in registers while
+ * the samples are processed; the states are written back at the end of the
+ * block.
+ *
+ * The difference equation is evaluated in the same order as the scalar
+ * kernel of CFilter, the results are bit exact.
+ *
+ * Instances are created by CFilterFixedFactory for the supported
+ * combinations (MAX_ORDER x MAX_CHANNELS).
+ */
+template<int Order, int Channels>
+class CFilterFixed: public CFilterBase {
+private:
+	/**
+	 * \brief filter coefficients of numerator (normalized by a0)
+	 */
+	float m_b[Order + 1];
+	/**
+	 * \brief filter coefficients of denominator (normalized by a0)
+	 */
+	float m_a[Order + 1];
+	/**
+	 * \brief filter file path
+	 */
+	string m_filePath;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * throws exception if the coefficients are not available
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param ca pointer to array of Order+1 denominator filter coefficients
+	 * \param cb pointer to array of Order+1 numerator filter coefficients
+	 */
+	CFilterFixed(const string &filePath, float *ca, float *cb) :
+			CFilterBase(Order, Channels) {
+		if ((ca == NULL) || (cb == NULL))
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Filter coefficients not available!");
+		m_filePath = filePath;
+		for (int i = 0; i <= Order; i++) {
+			m_a[i] = ca[i] / ca[0];
+			m_b[i] = cb[i] / ca[0];
+		}
+		m_hasChannelFilter = true;
+		cout << "CFilterFixed<" << Order << "," << Channels << ">@" << hex
+				<< this << dec << " created" << endl;
+	}
+	/**
+	 * \brief Destructor
+	 */
+	virtual ~CFilterFixed() {
+		cout << "CFilterFixed<" << Order << "," << Channels << ">@" << hex
+				<< this << dec << " destroyed" << endl;
+	}
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param x pointer on block buffer of original signal
+	 * \param y pointer on block buffer of filtered signal (may be x)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *x, float *y, uint16_t framesPerBuffer) {
+		if ((framesPerBuffer < Order) || (x == NULL) || (y == NULL))
+			return false;
+
+		x = _addDenormalOffset(x, y, framesPerBuffer);
+		// coefficients and states in locals (registers)
+		float b[Order + 1], a[Order + 1], z[Channels][Order + 1];
+		for (int n = 0; n <= Order; n++) {
+			b[n] = m_b[n];
+			a[n] = m_a[n];
+			for (int c = 0; c < Channels; c++)
+				z[c][n] = m_z[Channels * n + c];
+		}
+		for (int k = 0; k < framesPerBuffer * Channels; k += Channels)
+			for (int c = 0; c < Channels; c++) {
+				float xk = x[k + c];
+				float yk = b[0] * xk + z[c][0];
+				y[k + c] = yk;
+				for (int n = 1; n <= Order; n++)
+					z[c][n - 1] = b[n] * xk - a[n] * yk + z[c][n];
+			}
+		for (int n = 0; n <= Order; n++)
+			for (int c = 0; c < Channels; c++)
+				m_z[Channels * n + c] = z[c][n];
+		return true;
+	}
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+	/**
+	 * \brief gets full qualified pathname of the filter file
+	 * \return path of filter file
+	 */
+	string getFilePath() {
+		return m_filePath;
+	}
+
+protected:
+	/**
+	 * \brief filters one channel of a block (planar blocks)
+	 */
+	bool _filterChannel(uint16_t channel, float *x, float *y,
+			uint16_t framesPerBuffer) {
+		float b[Order + 1], a[Order + 1], z[Order + 1];
+		for (int n = 0; n <= Order; n++) {
+			b[n] = m_b[n];
+			a[n] = m_a[n];
+			z[n] = m_z[Channels * n + channel];
+		}
+		for (int k = 0; k < framesPerBuffer; k++) {
+			float xk = x[k];
+			float yk = b[0] * xk + z[0];
+			y[k] = yk;
+			for (int n = 1; n <= Order; n++)
+				z[n - 1] = b[n] * xk - a[n] * yk + z[n];
+		}
+		for (int n = 0; n <= Order; n++)
+			m_z[Channels * n + channel] = z[n];
+		return true;
+	}
+};
+
+/**
+ * \brief creates direct form filters, specialized ones if available
+ */
+class CFilterFixedFactory {
+public:
+	/**
+	 * \brief highest order with a specialization
+	 */
+	static const int MAX_ORDER = 8;
+	/**
+	 * \brief highest number of channels with a specialization
+	 */
+	static const int MAX_CHANNELS = 2;
+
+	/**
+	 * \brief creates a direct form II transposed filter
+	 *
+	 * returns a CFilterFixed for orders 1 ... MAX_ORDER and 1 ... MAX_CHANNELS
+	 * channels, a CFilter (runtime order, vectorized kernels) otherwise
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param ca pointer to array of denominator filter coefficients
+	 * \param cb pointer to array of numerator filter coefficients
+	 * \param order filter order
+	 * \param channels number of channels of original signal
+	 * \return new filter (owned by the caller)
+	 */
+	static CFilterBase* create(const string &filePath, float *ca, float *cb,
+			uint16_t order, uint16_t channels);
+	/**
+	 * \brief checks if there is a specialization
+	 * \return true if create() returns a CFilterFixed
+	 */
+	static bool isSpecialized(uint16_t order, uint16_t channels);
+};
+
+#endif /* CFILTERFIXED_H_ */
@@ -0,0 +1,447 @@
+/**
+ * \file CFilterLibrary.cpp
+ * \brief implementation CFilterLibrary
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <SKSLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <charconv>
+#include "CFileFilter.h"
+#include "CFilterAnalyzer.h"
+#include "CMappedFile.h"
+#include "CFilterLibrary.h"
+
+/*
+ * index file: a line per file and a line per section of the file, fields
+ * separated by tabs
+ * FLTLIB <version>
+ * F <name> <mtime> <size>
+ * S <fs> <offset> <order> <cutoff> <stable> <derivable> <type> <info>
+ */
+#define CFILTERLIBRARY_MAGIC "FLTLIB"
+#define CFILTERLIBRARY_VERSION 2
+
+const char *CFilterLibrary::INDEX_NAME = "library.fltidx";
+
+CFilterLibrary::CFilterLibrary(const string &path, const string &ext) {
+	m_pFiles = NULL;
+	m_numFiles = 0;
+	m_ppByRate = NULL;
+	m_pRates = NULL;
+	m_numRates = 0;
+	m_otherRate.fs = 0;
+	m_otherRate.ppDerived = NULL;
+	m_otherRate.numDerived = 0;
+	m_numParsed = 0;
+	setDirectory(path, ext);
+	cout << "CFilterLibrary@" << hex << this << dec << " created" << endl;
+}
+
+CFilterLibrary::~CFilterLibrary() {
+	_clear();
+	cout << "CFilterLibrary@" << hex << this << dec << " destroyed" << endl;
+}
+
+void CFilterLibrary::setDirectory(const string &path, const string &ext) {
+	if ((path == m_path) && (ext == m_ext))
+		return;
+	_clear();
+	m_path = path;
+	m_ext = ext;
+	if (!m_path.empty())
+		_load();
+}
+
+int CFilterLibrary::refresh() {
+	DIR *dp = opendir(m_path.c_str());
+	if (dp == NULL)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Could not open folder." + m_path);
+
+	// the entries of unchanged files are taken over, new and changed files
+	// are parsed
+	int maxFiles = m_numFiles + 16, numFiles = 0;
+	FILEENTRY *pFiles = new FILEENTRY[maxFiles];
+	m_numParsed = 0;
+	dirent *entry;
+	while ((entry = readdir(dp))) {
+		string name = entry->d_name;
+		int64_t mtime;
+		uint64_t size;
+		if ((name.size() <= m_ext.size())
+				|| name.compare(name.size() - m_ext.size(), m_ext.size(), m_ext)
+				|| !CMappedFile::getFileInfo(m_path + name, mtime, size))
+			continue;
+		if (numFiles == maxFiles) {
+			FILEENTRY *pOld = pFiles;
+			pFiles = new FILEENTRY[2 * maxFiles];
+			for (int i = 0; i < numFiles; i++)
+				pFiles[i] = pOld[i];
+			maxFiles *= 2;
+			delete[] pOld;
+		}
+		FILEENTRY &file = pFiles[numFiles++];
+		file.name = name;
+		file.mtime = mtime;
+		file.size = size;
+		file.numFilters = 0;
+		file.pFilters = NULL;
+		int j = 0;
+		while ((j < m_numFiles) && (m_pFiles[j].name != name))
+			j++;
+		if ((j < m_numFiles) && (m_pFiles[j].mtime == mtime)
+				&& (m_pFiles[j].size == size)) {
+			file.numFilters = m_pFiles[j].numFilters;
+			file.pFilters = m_pFiles[j].pFilters;
+			m_pFiles[j].pFilters = NULL;
+			m_pFiles[j].numFilters = 0;
+		} else {
+			_indexFile(&file);
+			m_numParsed++;
+		}
+	}
+	closedir(dp);
+
+	// sorted by name (the order of readdir() is undefined)
+	for (int i = 1; i < numFiles; i++) {
+		FILEENTRY file = pFiles[i];
+		int j = i;
+		for (; (j > 0) && (pFiles[j - 1].name > file.name); j--)
+			pFiles[j] = pFiles[j - 1];
+		pFiles[j] = file;
+	}
+
+	bool changed = (m_numParsed > 0) || (numFiles != m_numFiles);
+	_deleteEntries(m_pFiles, m_numFiles);
+	m_pFiles = pFiles;
+	m_numFiles = numFiles;
+	_buildRates();
+	if (changed)
+		_save();
+	return m_numParsed;
+}
+
+int CFilterLibrary::getNumFilters(int fs) {
+	for (int i = 0; i < m_numRates; i++)
+		if (m_pRates[i].fs == fs)
+			return m_pRates[i].num;
+	return 0;
+}
+
+const CFilterLibrary::FILTER* CFilterLibrary::getFilter(int fs, int i) {
+	for (int k = 0; k < m_numRates; k++)
+		if (m_pRates[k].fs == fs)
+			return ((i >= 0) && (i < m_pRates[k].num)) ?
+					m_ppByRate[m_pRates[k].first + i] : NULL;
+	return NULL;
+}
+
+int CFilterLibrary::getNumDerived(int fs) {
+	return _getRate(fs).numDerived;
+}
+
+const CFilterLibrary::FILTER* CFilterLibrary::getDerived(int fs, int i) {
+	const RATE &rate = _getRate(fs);
+	return ((i >= 0) && (i < rate.numDerived)) ? rate.ppDerived[i] : NULL;
+}
+
+int CFilterLibrary::getNumFiles() {
+	return m_numFiles;
+}
+
+string CFilterLibrary::getDirectory() {
+	return m_path;
+}
+
+string CFilterLibrary::getIndexPath() {
+	return m_path + INDEX_NAME;
+}
+
+void CFilterLibrary::_indexFile(FILEENTRY *pEntry) {
+	CFileFilter fltfile(m_path + pEntry->name);
+	try {
+		fltfile.open();
+	} catch (CException &e) {
+		return;		// no filters until the file changes
+	}
+	try {
+		int fs[MAX_SECTIONS];
+		long offset[MAX_SECTIONS];
+		int num = fltfile.getSections(fs, offset, MAX_SECTIONS);
+		if (num > MAX_SECTIONS)
+			num = MAX_SECTIONS;
+		pEntry->pFilters = new FILTER[num];
+		CFilterAnalyzer analyzer(64);
+		for (int i = 0; i < num; i++) {
+			// malformed sections are left out
+			try {
+				if (!fltfile.read(fs[i]))
+					continue;
+			} catch (CException &e) {
+				continue;
+			}
+			FILTER &flt = pEntry->pFilters[pEntry->numFilters++];
+			flt.file = pEntry->name;
+			flt.fs = fs[i];
+			flt.offset = offset[i];
+			flt.order = fltfile.getOrder();
+			flt.type = fltfile.getFilterType();
+			flt.info = fltfile.getFilterInfo();
+			flt.info.erase(flt.info.find_last_not_of(" \r\n") + 1);
+			const CFilterAnalyzer::RESPONSE *pResp = analyzer.analyze(
+					fltfile.getFilepath(), fs[i], fltfile.getACoeffsDouble(),
+					fltfile.getBCoeffsDouble(), flt.order);
+			flt.cutoff = pResp->cutoff;
+			flt.stable = pResp->stable;
+			try {
+				flt.derivable = fltfile.isDerivationSource(fs[i]);
+			} catch (CException &e) {
+				flt.derivable = false;	// malformed section next to it
+			}
+		}
+	} catch (CException &e) {
+		// the file can't be parsed, no filters until it changes
+	}
+	fltfile.close();
+}
+
+const CFilterLibrary::FILTER* CFilterLibrary::_findSource(
+		const FILEENTRY &file, int fs) {
+	const FILTER *pSource = NULL;
+	for (int k = 0; k < file.numFilters; k++) {
+		const FILTER &flt = file.pFilters[k];
+		if (flt.fs == fs)
+			return NULL;
+		if ((pSource == NULL)
+				|| (fabs(log((double) flt.fs / fs))
+						< fabs(log((double) pSource->fs / fs))))
+			pSource = &flt;
+	}
+	return pSource;
+}
+
+/*
+ * order of the filters: sampling frequency, file name
+ */
+static int compareFilters(const void *p1, const void *p2) {
+	const CFilterLibrary::FILTER *f1 = *(const CFilterLibrary::FILTER**) p1;
+	const CFilterLibrary::FILTER *f2 = *(const CFilterLibrary::FILTER**) p2;
+	if (f1->fs != f2->fs)
+		return (f1->fs < f2->fs) ? -1 : 1;
+	if (f1->file != f2->file)
+		return (f1->file < f2->file) ? -1 : 1;
+	return (f1->offset < f2->offset) ? -1 : (f1->offset > f2->offset);
+}
+
+void CFilterLibrary::_buildRates() {
+	_deleteRates();
+
+	int num = 0;
+	for (int i = 0; i < m_numFiles; i++)
+		num += m_pFiles[i].numFilters;
+	if (num == 0)
+		return;
+	m_ppByRate = new FILTER*[num];
+	num = 0;
+	for (int i = 0; i < m_numFiles; i++)
+		for (int k = 0; k < m_pFiles[i].numFilters; k++)
+			m_ppByRate[num++] = &m_pFiles[i].pFilters[k];
+	qsort(m_ppByRate, num, sizeof(FILTER*), compareFilters);
+
+	m_pRates = new RATE[num];
+	for (int i = 0; i < num; i++) {
+		if ((m_numRates == 0)
+				|| (m_pRates[m_numRates - 1].fs != m_ppByRate[i]->fs)) {
+			m_pRates[m_numRates].fs = m_ppByRate[i]->fs;
+			m_pRates[m_numRates].first = i;
+			m_pRates[m_numRates++].num = 0;
+		}
+		m_pRates[m_numRates - 1].num++;
+	}
+	for (int i = 0; i < m_numRates; i++)
+		_buildDerived(m_pRates[i]);
+}
+
+void CFilterLibrary::_deleteRates() {
+	for (int i = 0; i < m_numRates; i++)
+		delete[] m_pRates[i].ppDerived;
+	delete[] m_ppByRate;
+	delete[] m_pRates;
+	delete[] m_otherRate.ppDerived;
+	m_ppByRate = NULL;
+	m_pRates = NULL;
+	m_numRates = 0;
+	m_otherRate.fs = 0;
+	m_otherRate.ppDerived = NULL;
+	m_otherRate.numDerived = 0;
+}
+
+void CFilterLibrary::_buildDerived(RATE &rate) {
+	// at most one source per file, the files are ordered by name
+	rate.ppDerived = new const FILTER*[m_numFiles];
+	rate.numDerived = 0;
+	for (int i = 0; i < m_numFiles; i++) {
+		const FILTER *pSource = _findSource(m_pFiles[i], rate.fs);
+		if ((pSource != NULL) && pSource->derivable)
+			rate.ppDerived[rate.numDerived++] = pSource;
+	}
+}
+
+const CFilterLibrary::RATE& CFilterLibrary::_getRate(int fs) {
+	for (int i = 0; i < m_numRates; i++)
+		if (m_pRates[i].fs == fs)
+			return m_pRates[i];
+	if (m_otherRate.fs != fs) {
+		delete[] m_otherRate.ppDerived;
+		m_otherRate.fs = fs;
+		m_otherRate.first = 0;
+		m_otherRate.num = 0;
+		_buildDerived(m_otherRate);
+	}
+	return m_otherRate;
+}
+
+/*
+ * splits a line of the index file into fields separated by tabs
+ * \return number of fields (at most maxFields, the last field takes the
+ * rest of the line)
+ */
+static int splitFields(const char *p, const char *pEnd, const char **pField,
+		const char **pFieldEnd, int maxFields) {
+	int n = 0;
+	while (n < maxFields) {
+		const char *pTab =
+				(n < maxFields - 1) ?
+						(const char*) memchr(p, '\t', pEnd - p) : NULL;
+		pField[n] = p;
+		pFieldEnd[n++] = (pTab != NULL) ? pTab : pEnd;
+		if (pTab == NULL)
+			break;
+		p = pTab + 1;
+	}
+	return n;
+}
+
+template<typename T>
+static bool parseField(const char *p, const char *pEnd, T &value) {
+	from_chars_result r = from_chars(p, pEnd, value);
+	return (r.ec == errc()) && (r.ptr == pEnd);
+}
+
+void CFilterLibrary::_load() {
+	CMappedFile index;
+	if (!index.map(getIndexPath()) || (index.getData() == NULL))
+		return;
+	const char *p = (const char*) index.getData();
+	const char *pEnd = p + index.getSize();
+	int maxFiles = 16;
+	FILEENTRY *pFiles = new FILEENTRY[maxFiles];
+	int numFiles = 0;
+	bool ok = true, header = true;
+	while (ok && (p < pEnd)) {
+		const char *pLf = (const char*) memchr(p, '\n', pEnd - p);
+		const char *pLine = (pLf != NULL) ? pLf : pEnd;
+		const char *f[9], *fe[9];
+		int n = splitFields(p, pLine, f, fe, 9);
+		p = (pLf != NULL) ? pLf + 1 : pEnd;
+		if (header) {
+			int version = 0;
+			ok = (n == 2)
+					&& (string(f[0], fe[0] - f[0]) == CFILTERLIBRARY_MAGIC)
+					&& parseField(f[1], fe[1], version)
+					&& (version == CFILTERLIBRARY_VERSION);
+			header = false;
+		} else if ((n == 4) && (*f[0] == 'F')) {
+			if (numFiles == maxFiles) {
+				FILEENTRY *pOld = pFiles;
+				pFiles = new FILEENTRY[2 * maxFiles];
+				for (int i = 0; i < numFiles; i++)
+					pFiles[i] = pOld[i];
+				maxFiles *= 2;
+				delete[] pOld;
+			}
+			FILEENTRY &file = pFiles[numFiles++];
+			file.name.assign(f[1], fe[1] - f[1]);
+			file.numFilters = 0;
+			file.pFilters = new FILTER[MAX_SECTIONS];
+			ok = parseField(f[2], fe[2], file.mtime)
+					&& parseField(f[3], fe[3], file.size);
+		} else if ((n == 9) && (*f[0] == 'S') && (numFiles > 0)
+				&& (pFiles[numFiles - 1].numFilters < MAX_SECTIONS)) {
+			FILEENTRY &file = pFiles[numFiles - 1];
+			FILTER &flt = file.pFilters[file.numFilters++];
+			int stable = 0, derivable = 0;
+			flt.file = file.name;
+			ok = parseField(f[1], fe[1], flt.fs)
+					&& parseField(f[2], fe[2], flt.offset)
+					&& parseField(f[3], fe[3], flt.order)
+					&& parseField(f[4], fe[4], flt.cutoff)
+					&& parseField(f[5], fe[5], stable)
+					&& parseField(f[6], fe[6], derivable);
+			flt.stable = (stable != 0);
+			flt.derivable = (derivable != 0);
+			flt.type.assign(f[7], fe[7] - f[7]);
+			flt.info.assign(f[8], fe[8] - f[8]);
+		} else
+			ok = false;
+	}
+	if (!ok) {
+		// corrupt or outdated index: all files are parsed by refresh()
+		_deleteEntries(pFiles, numFiles);
+		return;
+	}
+	m_pFiles = pFiles;
+	m_numFiles = numFiles;
+	_buildRates();
+}
+
+bool CFilterLibrary::_save() {
+	// written to a temporary file and renamed, readers never see a partial index
+	string path = getIndexPath(), tmpPath = path + ".tmp";
+	FILE *pf = fopen(tmpPath.c_str(), "w");
+	if (pf == NULL)
+		return false;
+	bool ok = fprintf(pf, "%s\t%d\n", CFILTERLIBRARY_MAGIC,
+			CFILTERLIBRARY_VERSION) > 0;
+	for (int i = 0; ok && (i < m_numFiles); i++) {
+		FILEENTRY &file = m_pFiles[i];
+		ok = fprintf(pf, "F\t%s\t%lld\t%llu\n", file.name.c_str(),
+				(long long) file.mtime, (unsigned long long) file.size) > 0;
+		for (int k = 0; ok && (k < file.numFilters); k++) {
+			FILTER &flt = file.pFilters[k];
+			ok = fprintf(pf, "S\t%d\t%ld\t%d\t%.17g\t%d\t%d\t%s\t%s\n",
+					flt.fs, flt.offset, flt.order, flt.cutoff,
+					flt.stable ? 1 : 0, flt.derivable ? 1 : 0, flt.type.c_str(),
+					flt.info.c_str()) > 0;
+		}
+	}
+	ok = (fclose(pf) == 0) && ok;
+	if (ok) {
+		::remove(path.c_str());		// rename() does not replace files on Windows
+		ok = (::rename(tmpPath.c_str(), path.c_str()) == 0);
+	}
+	if (!ok)
+		::remove(tmpPath.c_str());
+	return ok;
+}
+
+void CFilterLibrary::_clear() {
+	_deleteRates();
+	_deleteEntries(m_pFiles, m_numFiles);
+	m_pFiles = NULL;
+	m_numFiles = 0;
+}
+
+void CFilterLibrary::_deleteEntries(FILEENTRY *pFiles, int numFiles) {
+	if (pFiles == NULL)
+		return;
+	for (int i = 0; i < numFiles; i++)
+		delete[] pFiles[i].pFilters;
+	delete[] pFiles;
+}
@@ -0,0 +1,212 @@
+/**
+ * \file CFilterLibrary.h
+ * \brief interface CFilterLibrary
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERLIBRARY_H_
+#define CFILTERLIBRARY_H_
+
+#include <stdint.h>
+#include <string>
+using namespace std;
+
+/**
+ * \brief index of the filter files of a directory by sampling frequency
+ *
+ * For every section (sampling frequency) of every filter file the index
+ * holds file name, position of the section, order, type, info, cutoff
+ * frequency and stability. The filters for a sampling frequency are
+ * available without opening any filter file, e.g. for the filter menu.
+ * Files without a section for a sampling frequency are listed as derived
+ * filters (getDerived()) if CFileFilter::readDerived() can derive the
+ * coefficients from their section with the nearest sampling frequency.
+ *
+ * The index is stored in the directory (INDEX_NAME) and kept up to date by
+ * refresh(): only new or changed files (size or modification time) are
+ * parsed and analyzed, removed files are dropped. Files that can't be
+ * parsed are kept in the index without filters until they change.
+ */
+class CFilterLibrary {
+public:
+	/**
+	 * \brief name of the index file in the directory
+	 */
+	static const char *INDEX_NAME;
+	/**
+	 * \brief maximum number of sections per filter file
+	 */
+	static const int MAX_SECTIONS = 32;
+
+	/**
+	 * \brief filter for a sampling frequency (section of a filter file)
+	 */
+	struct FILTER {
+		string file;		///< file name (without directory)
+		int fs;				///< sampling frequency in Hz
+		long offset;		///< position of the section in the file
+		int order;			///< filter order
+		string type;		///< filter type
+		string info;		///< filter info (without line feed)
+		double cutoff;		///< -3 dB edge next to DC in Hz (0: none)
+		bool stable;		///< all poles inside the unit circle
+		/**
+		 * \brief coefficients for other sampling frequencies can be derived
+		 * from the section (see CFileFilter::isDerivationSource())
+		 */
+		bool derivable;
+	};
+
+private:
+	/**
+	 * \brief indexed filter file
+	 */
+	struct FILEENTRY {
+		string name;
+		int64_t mtime;
+		uint64_t size;
+		int numFilters;
+		FILTER *pFilters;
+	};
+	/**
+	 * \brief filters of a sampling frequency: m_ppByRate[first ... first+num-1],
+	 * derived filters: source sections ppDerived[0 ... numDerived-1]
+	 */
+	struct RATE {
+		int fs;
+		int first;
+		int num;
+		const FILTER **ppDerived;
+		int numDerived;
+	};
+
+	string m_path;
+	string m_ext;
+	FILEENTRY *m_pFiles;
+	int m_numFiles;
+	/**
+	 * \brief all filters sorted by sampling frequency and file name
+	 */
+	FILTER **m_ppByRate;
+	RATE *m_pRates;
+	int m_numRates;
+	/**
+	 * \brief derived filters of the last requested sampling frequency without
+	 * filters (fs 0: none)
+	 */
+	RATE m_otherRate;
+	/**
+	 * \brief statistics: files parsed by the last refresh()
+	 */
+	int m_numParsed;
+
+public:
+	/**
+	 * \brief Constructor
+	 * \param path directory of the filter files (with trailing separator)
+	 * \param ext extension of the filter files
+	 */
+	CFilterLibrary(const string &path = "", const string &ext = ".txt");
+	/**
+	 * \brief Destructor
+	 */
+	~CFilterLibrary();
+
+	/**
+	 * \brief changes the directory, the index of the directory is loaded
+	 * (nothing happens if the directory is the current one)
+	 * \param path directory of the filter files (with trailing separator)
+	 * \param ext extension of the filter files
+	 */
+	void setDirectory(const string &path, const string &ext = ".txt");
+	/**
+	 * \brief brings the index up to date with the directory and stores it
+	 *
+	 * throws exception if the directory can't be read
+	 *
+	 * \return number of files that have been parsed (new or changed)
+	 */
+	int refresh();
+	/**
+	 * \brief gets the number of filters for a sampling frequency
+	 */
+	int getNumFilters(int fs);
+	/**
+	 * \brief gets a filter for a sampling frequency
+	 * \param fs sampling frequency
+	 * \param i 0 ... getNumFilters(fs)-1 (ordered by file name)
+	 * \return filter or NULL
+	 */
+	const FILTER* getFilter(int fs, int i);
+	/**
+	 * \brief gets the number of files without a section for a sampling
+	 * frequency whose coefficients can be derived from the section with the
+	 * nearest sampling frequency
+	 */
+	int getNumDerived(int fs);
+	/**
+	 * \brief gets a derived filter for a sampling frequency
+	 * \param fs sampling frequency
+	 * \param i 0 ... getNumDerived(fs)-1 (ordered by file name)
+	 * \return source section of the derivation (fs: sampling frequency of
+	 * the source) or NULL
+	 */
+	const FILTER* getDerived(int fs, int i);
+	/**
+	 * \brief gets the number of indexed files (including files without filters)
+	 */
+	int getNumFiles();
+	/**
+	 * \brief gets the directory of the filter files
+	 */
+	string getDirectory();
+	/**
+	 * \brief gets the path of the index file
+	 */
+	string getIndexPath();
+
+private:
+	/**
+	 * \brief parses and analyzes a filter file
+	 * \param pEntry entry with name, mtime and size, filters are added
+	 */
+	void _indexFile(FILEENTRY *pEntry);
+	/**
+	 * \brief builds the table of sampling frequencies and their derived filters
+	 */
+	void _buildRates();
+	/**
+	 * \brief deletes the table of sampling frequencies
+	 */
+	void _deleteRates();
+	/**
+	 * \brief lists the source sections of the derived filters of a rate
+	 * (ordered by file name)
+	 */
+	void _buildDerived(RATE &rate);
+	/**
+	 * \brief gets the entry of a sampling frequency, the derived filters of a
+	 * sampling frequency without filters are listed on the first request
+	 */
+	const RATE& _getRate(int fs);
+	/**
+	 * \brief finds the section of a file the coefficients for a sampling
+	 * frequency are derived from (nearest sampling frequency like
+	 * CFileFilter::readDerived())
+	 * \return section or NULL if the file has a section for fs or none
+	 */
+	static const FILTER* _findSource(const FILEENTRY &file, int fs);
+	/**
+	 * \brief loads resp. stores the index file
+	 */
+	void _load();
+	bool _save();
+	/**
+	 * \brief deletes all entries
+	 */
+	void _clear();
+	static void _deleteEntries(FILEENTRY *pFiles, int numFiles);
+};
+
+#endif /* CFILTERLIBRARY_H_ */
@@ -0,0 +1,266 @@
+/**
+ * \file CFilterPipeline.cpp
+ * \brief implementation CFilterPipeline
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <thread>
+#include <SKSLib.h>
+#include "CDenormalGuard.h"
+#include "CFilterPipeline.h"
+
+CFilterPipeline::CFilterPipeline(CFilterChain *pChain, uint16_t framesPerBlock,
+		int latencyBlocks) :
+		CFilterBase(1, pChain ? pChain->getNumChannels() : 0, 0), m_pushed(0),
+		m_fpMode(CDenormalGuard::getMode()), m_ok(true), m_stop(false) {
+	m_pChain = pChain;
+	m_order = m_pChain->getOrder();
+	m_framesPerBlock = framesPerBlock;
+	m_consumed = 0;
+
+	// one group per thread, more threads than stages or cores are useless
+	int numGroups = latencyBlocks + 1;
+	if (numGroups > m_pChain->getNumStages())
+		numGroups = m_pChain->getNumStages();
+	int cores = (int) std::thread::hardware_concurrency();
+	if ((cores > 0) && (numGroups > cores))
+		numGroups = cores;
+	if (numGroups > MAX_GROUPS)
+		numGroups = MAX_GROUPS;
+	if (numGroups < 1)
+		numGroups = 1;
+	_partition(numGroups);
+
+	// block k is stored in ring slot k % m_numGroups, the caller never has
+	// more than m_numGroups-1 blocks in flight
+	m_blocks = new float[m_numGroups * m_framesPerBlock * m_channels];
+	for (int g = 0; g < MAX_GROUPS; g++) {
+		m_done[g].store(0);
+		m_sleeping[g].store(false);
+	}
+	for (int g = 0; g < m_numGroups - 1; g++)
+		sem_init(&m_wake[g], 0, 0);
+
+	for (int g = 0; g < m_numGroups - 1; g++) {
+		m_workers[g].pPipeline = this;
+		m_workers[g].group = g;
+		if (pthread_create(&m_threads[g], NULL, _workerThread, &m_workers[g])
+				!= 0) {
+			m_stop = true;
+			for (int i = 0; i < g; i++) {
+				sem_post(&m_wake[i]);
+				pthread_join(m_threads[i], NULL);
+			}
+			for (int i = 0; i < m_numGroups - 1; i++)
+				sem_destroy(&m_wake[i]);
+			delete[] m_blocks;
+			m_pChain = NULL;	// the caller keeps the chain
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Could not start pipeline thread!");
+		}
+	}
+	cout << "CFilterPipeline@" << hex << this << dec << " created ("
+			<< m_numGroups << " groups)" << endl;
+}
+
+CFilterPipeline::~CFilterPipeline() {
+	m_stop = true;
+	for (int g = 0; g < m_numGroups - 1; g++) {
+		sem_post(&m_wake[g]);
+		pthread_join(m_threads[g], NULL);
+		sem_destroy(&m_wake[g]);
+	}
+	delete[] m_blocks;
+	if (m_pChain)
+		delete m_pChain;
+	cout << "CFilterPipeline@" << hex << this << dec << " destroyed" << endl;
+}
+
+void CFilterPipeline::_partition(int numGroups) {
+	// cost of the stages: measured time if available, otherwise the order
+	int n = m_pChain->getNumStages();
+	double cost[CFilterChain::MAX_STAGES + 1];
+	double sum[CFilterChain::MAX_STAGES + 1];
+	sum[0] = 0.;
+	for (int i = 0; i < n; i++) {
+		cost[i] = m_pChain->getStageTime(i);
+		if (cost[i] == 0.)
+			cost[i] = m_pChain->getStage(i)->getOrder() + 1.;
+		sum[i + 1] = sum[i] + cost[i];
+	}
+
+	// linear partition: best[g][i] = minimal maximum cost of the first i
+	// stages in g groups, cut[g][i] = first stage of the last of these groups
+	double best[MAX_GROUPS + 1][CFilterChain::MAX_STAGES + 1];
+	int cut[MAX_GROUPS + 1][CFilterChain::MAX_STAGES + 1];
+	for (int i = 0; i <= n; i++) {
+		best[1][i] = sum[i];
+		cut[1][i] = 0;
+	}
+	for (int g = 2; g <= numGroups; g++)
+		for (int i = g; i <= n; i++) {
+			best[g][i] = -1.;
+			for (int j = g - 1; j < i; j++) {
+				double c = best[g - 1][j];
+				if (sum[i] - sum[j] > c)
+					c = sum[i] - sum[j];
+				if ((best[g][i] < 0.) || (c < best[g][i])) {
+					best[g][i] = c;
+					cut[g][i] = j;
+				}
+			}
+		}
+
+	m_numGroups = numGroups;
+	int end = n;
+	for (int g = numGroups; g >= 1; g--) {
+		int first = (g == 1) ? 0 : cut[g][end];
+		m_groupFirst[g - 1] = first;
+		m_groupNum[g - 1] = end - first;
+		end = first;
+	}
+}
+
+void* CFilterPipeline::_workerThread(void *pArg) {
+	WORKER *pWorker = (WORKER*) pArg;
+	pWorker->pPipeline->_work(pWorker->group);
+	return NULL;
+}
+
+void CFilterPipeline::_waitFor(std::atomic<uint64_t> &counter, uint64_t value) {
+	// spin briefly (block handoff during playback), then give up the CPU
+	for (int spin = 0; counter.load(std::memory_order_acquire) < value;
+			spin++) {
+		if (m_stop.load(std::memory_order_relaxed))
+			return;
+		if (spin >= 256)
+			sched_yield();
+	}
+}
+
+void CFilterPipeline::_waitInput(int group, std::atomic<uint64_t> &counter,
+		uint64_t value) {
+	// spin briefly (block handoff during playback)
+	for (int spin = 0; spin < 1024; spin++) {
+		if ((counter.load(std::memory_order_acquire) >= value)
+				|| m_stop.load(std::memory_order_relaxed))
+			return;
+		if (spin >= 256)
+			sched_yield();
+	}
+	// sleep: the flag is set before the counter is checked, the producer
+	// increases the counter before it checks the flag (sequentially
+	// consistent), so one of both sees the other
+	while (true) {
+		m_sleeping[group].store(true);
+		if ((counter.load() >= value) || m_stop.load()) {
+			// a producer that has cleared the flag posts the semaphore
+			if (!m_sleeping[group].exchange(false))
+				while ((sem_wait(&m_wake[group]) != 0) && (errno == EINTR))
+					;
+			return;
+		}
+		while ((sem_wait(&m_wake[group]) != 0) && (errno == EINTR))
+			;
+	}
+}
+
+void CFilterPipeline::_signal(int group) {
+	if ((group < m_numGroups - 1) && m_sleeping[group].exchange(false))
+		sem_post(&m_wake[group]);
+}
+
+float* CFilterPipeline::_block(uint64_t k) {
+	return m_blocks + (k % m_numGroups) * m_framesPerBlock * m_channels;
+}
+
+void CFilterPipeline::_work(int group) {
+	std::atomic<uint64_t> &input = (group == 0) ? m_pushed : m_done[group - 1];
+	uint64_t k = m_done[group].load(std::memory_order_relaxed);
+	uint32_t fpMode = CDenormalGuard::getMode();
+	while (true) {
+		_waitInput(group, input, k + 1);
+		if (m_stop.load(std::memory_order_relaxed))
+			break;
+		// floating point mode of the caller (flush-to-zero)
+		uint32_t callerMode = m_fpMode.load(std::memory_order_relaxed);
+		if (callerMode != fpMode) {
+			CDenormalGuard::setMode(callerMode);
+			fpMode = callerMode;
+		}
+		float *pBlock = _block(k);
+		if (!m_pChain->filterStages(m_groupFirst[group], m_groupNum[group],
+				pBlock, pBlock, m_framesPerBlock))
+			m_ok = false;
+		m_done[group].store(++k);
+		_signal(group + 1);
+	}
+}
+
+bool CFilterPipeline::filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer) {
+	if ((inBuf == NULL) || (outBuf == NULL)
+			|| (framesPerBuffer != m_framesPerBlock))
+		return false;
+	int blockSize = m_framesPerBlock * m_channels;
+
+	// hand over the new block (its slot has been consumed before)
+	uint64_t k = m_pushed.load(std::memory_order_relaxed);
+	memcpy(_block(k), inBuf, blockSize * sizeof(float));
+	m_fpMode.store(CDenormalGuard::getMode(), std::memory_order_relaxed);
+	m_pushed.store(k + 1);
+	_signal(0);
+
+	// pipeline still filling
+	if (k + 1 - m_consumed < (uint64_t) m_numGroups) {
+		memset(outBuf, 0, blockSize * sizeof(float));
+		return m_ok;
+	}
+
+	// the oldest block has passed all worker groups: last group and output
+	if (m_numGroups > 1)
+		_waitFor(m_done[m_numGroups - 2], m_consumed + 1);
+	float *pBlock = _block(m_consumed);
+	bool ok = m_pChain->filterStages(m_groupFirst[m_numGroups - 1],
+			m_groupNum[m_numGroups - 1], pBlock, outBuf, m_framesPerBlock);
+	m_consumed++;
+	return ok && m_ok;
+}
+
+void CFilterPipeline::reset() {
+	// let the workers finish the blocks in flight, then discard them
+	uint64_t pushed = m_pushed.load(std::memory_order_relaxed);
+	for (int g = 0; g < m_numGroups - 1; g++)
+		_waitFor(m_done[g], pushed);
+	m_consumed = pushed;
+	m_pChain->reset();
+	m_ok = true;
+}
+
+void CFilterPipeline::prepare(uint16_t maxFrames) {
+	CFilterBase::prepare(maxFrames);
+	m_pChain->prepare(maxFrames);
+}
+
+int CFilterPipeline::getLatency() {
+	return m_numGroups - 1;
+}
+
+int CFilterPipeline::getNumGroups() {
+	return m_numGroups;
+}
+
+void CFilterPipeline::getGroup(int group, int &first, int &num) {
+	first = num = 0;
+	if ((group >= 0) && (group < m_numGroups)) {
+		first = m_groupFirst[group];
+		num = m_groupNum[group];
+	}
+}
+
+CFilterChain* CFilterPipeline::getChain() {
+	return m_pChain;
+}
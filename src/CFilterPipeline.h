@@ -0,0 +1,206 @@
+/**
+ * \file CFilterPipeline.h
+ * \brief interface CFilterPipeline
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERPIPELINE_H_
+#define CFILTERPIPELINE_H_
+
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+#include "CFilterChain.h"
+
+/**
+ * \brief pipelined processing of a filter chain by several threads
+ *
+ * The stages of the chain are split into groups of consecutive stages with
+ * about the same processing cost. Each group but the last one runs on a
+ * worker thread, the last group runs on the thread that calls filter().
+ * While group g works on block k, group g+1 works on block k-1.
+ *
+ * The blocks are stored in a ring of block buffers. Each link between two
+ * groups is a single producer/single consumer queue of blocks within this
+ * ring: the producer publishes the number of blocks it has finished by an
+ * atomic counter, the consumer processes the block in place and publishes
+ * its own counter. There are no locks and no copies between the groups.
+ *
+ * The output is delayed by getLatency() blocks (zeros while the pipeline is
+ * filling). The pipeline requires a constant block size.
+ *
+ * The workers process the blocks with the floating point mode
+ * (CDenormalGuard) of the thread that calls filter(). An idle worker spins
+ * briefly, then sleeps on a semaphore that the producer of its input posts
+ * if the worker has announced to sleep (sem_post() does not block, the
+ * caller of filter() never sleeps or locks).
+ */
+class CFilterPipeline: public CFilterBase {
+public:
+	/**
+	 * \brief maximum number of stage groups (threads including the caller)
+	 */
+	static const int MAX_GROUPS = 8;
+
+private:
+	/**
+	 * \brief arguments of a worker thread
+	 */
+	struct WORKER {
+		CFilterPipeline *pPipeline;
+		int group;
+	};
+
+	/**
+	 * \brief the chain (owned)
+	 */
+	CFilterChain *m_pChain;
+	/**
+	 * \brief frames per block
+	 */
+	uint16_t m_framesPerBlock;
+	/**
+	 * \brief number of stage groups
+	 */
+	int m_numGroups;
+	/**
+	 * \brief first stage and number of stages of each group
+	 */
+	int m_groupFirst[MAX_GROUPS], m_groupNum[MAX_GROUPS];
+	/**
+	 * \brief ring of block buffers (m_numGroups blocks)
+	 */
+	float *m_blocks;
+	/**
+	 * \brief number of blocks handed over by the caller
+	 */
+	std::atomic<uint64_t> m_pushed;
+	/**
+	 * \brief floating point mode of the caller for the blocks handed over
+	 */
+	std::atomic<uint32_t> m_fpMode;
+	/**
+	 * \brief number of blocks finished by each worker group
+	 */
+	std::atomic<uint64_t> m_done[MAX_GROUPS];
+	/**
+	 * \brief number of blocks finished by the last group (caller only)
+	 */
+	uint64_t m_consumed;
+	/**
+	 * \brief false if a stage of a worker failed
+	 */
+	std::atomic<bool> m_ok;
+	/**
+	 * \brief terminates the worker threads
+	 */
+	std::atomic<bool> m_stop;
+	/**
+	 * \brief sleeping worker groups: flag set by the worker before it
+	 * sleeps, cleared by the producer that posts the semaphore
+	 */
+	std::atomic<bool> m_sleeping[MAX_GROUPS];
+	sem_t m_wake[MAX_GROUPS];
+	/**
+	 * \brief worker threads and their arguments
+	 */
+	pthread_t m_threads[MAX_GROUPS];
+	WORKER m_workers[MAX_GROUPS];
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * - splits the stages into groups and starts one thread per group but the last
+	 * - throws exception if a thread can not be started
+	 *
+	 * \param pChain filter chain (the pipeline takes ownership)
+	 * \param framesPerBlock frames of each block passed to filter()
+	 * \param latencyBlocks maximum latency in blocks (number of additional threads)
+	 */
+	CFilterPipeline(CFilterChain *pChain, uint16_t framesPerBlock,
+			int latencyBlocks);
+	/**
+	 * \brief Destructor, stops the threads and deletes the chain
+	 */
+	virtual ~CFilterPipeline();
+	/**
+	 * \brief Filters a block (the result is the block of getLatency() calls before).
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (must be framesPerBlock)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+	/**
+	 * \brief discards the blocks in the pipeline and resets all stages
+	 */
+	void reset();
+	/**
+	 * \brief allocates the buffers of the pipeline and the chain (see CFilterBase)
+	 */
+	void prepare(uint16_t maxFrames);
+	/**
+	 * \brief gets the latency (see CFilterBase)
+	 * \return delay of the output in blocks
+	 */
+	int getLatency();
+	/**
+	 * \brief gets the number of stage groups (threads including the caller)
+	 * \return number of groups
+	 */
+	int getNumGroups();
+	/**
+	 * \brief gets the stages of a group
+	 * \param group index of the group
+	 * \param first [out] index of the first stage
+	 * \param num [out] number of stages
+	 */
+	void getGroup(int group, int &first, int &num);
+	/**
+	 * \brief gets the filter chain
+	 * \return chain (owned by the pipeline)
+	 */
+	CFilterChain* getChain();
+
+private:
+	/**
+	 * \brief splits the stages into groups of consecutive stages with minimal maximum cost
+	 */
+	void _partition(int numGroups);
+	/**
+	 * \brief processing loop of a worker thread
+	 */
+	void _work(int group);
+	/**
+	 * \brief thread function
+	 */
+	static void* _workerThread(void *pArg);
+	/**
+	 * \brief waits until a counter has reached a value (or the pipeline
+	 * stops), caller of filter(): spins without sleeping
+	 */
+	void _waitFor(std::atomic<uint64_t> &counter, uint64_t value);
+	/**
+	 * \brief waits until the input counter of a worker group has reached a
+	 * value (or the pipeline stops), spins briefly, then sleeps
+	 */
+	void _waitInput(int group, std::atomic<uint64_t> &counter, uint64_t value);
+	/**
+	 * \brief wakes a worker group if it sleeps (after its input counter has
+	 * been increased)
+	 */
+	void _signal(int group);
+	/**
+	 * \brief address of a block of the ring
+	 */
+	float* _block(uint64_t k);
+};
+
+#endif /* CFILTERPIPELINE_H_ */
@@ -0,0 +1,35 @@
+/**
+ * \file CFilterPrecise.cpp
+ * \brief implementation CFilterPreciseFactory
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <SKSLib.h>
+#include "CFilterPrecise.h"
+
+CFilterBase* CFilterPreciseFactory::create(const string &filePath, double *ca,
+		double *cb, uint16_t order, uint16_t channels, PRECISION precision) {
+	switch (precision) {
+	case PRECISION_MIXED:
+		return new CFilterPrecise<CPrecisionMixed>(filePath, ca, cb, order,
+				channels);
+	case PRECISION_DOUBLE:
+		return new CFilterPrecise<CPrecisionDouble>(filePath, ca, cb, order,
+				channels);
+	default:
+		return new CFilterPrecise<CPrecisionFloat>(filePath, ca, cb, order,
+				channels);
+	}
+}
+
+string CFilterPreciseFactory::getPrecisionName(PRECISION precision) {
+	switch (precision) {
+	case PRECISION_MIXED:
+		return string(CPrecisionMixed::getName());
+	case PRECISION_DOUBLE:
+		return string(CPrecisionDouble::getName());
+	default:
+		return string(CPrecisionFloat::getName());
+	}
+}
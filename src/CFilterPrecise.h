@@ -0,0 +1,270 @@
+/**
+ * \file CFilterPrecise.h
+ * \brief interface and implementation CFilterPrecise (template) and precision policies
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERPRECISE_H_
+#define CFILTERPRECISE_H_
+
+#include <SKSLib.h>
+#include "CFilterBase.h"
+
+/**
+ * \brief precision policy: float coefficients and states (like CFilter)
+ */
+struct CPrecisionFloat {
+	typedef float coef_t;	///< type of the coefficients
+	typedef float state_t;	///< type of the states and the arithmetic
+	static const char* getName() {
+		return "float";
+	}
+};
+
+/**
+ * \brief precision policy: float coefficients, double states and arithmetic
+ *
+ * the rounding errors of the recursion are not accumulated in float, the
+ * poles are still those of the float coefficients
+ */
+struct CPrecisionMixed {
+	typedef float coef_t;
+	typedef double state_t;
+	static const char* getName() {
+		return "mixed (double state)";
+	}
+};
+
+/**
+ * \brief precision policy: double coefficients, states and arithmetic
+ */
+struct CPrecisionDouble {
+	typedef double coef_t;
+	typedef double state_t;
+	static const char* getName() {
+		return "double";
+	}
+};
+
+/**
+ * \brief direct form II transposed filter with selectable precision
+ *
+ * The precision policy (CPrecisionFloat, CPrecisionMixed, CPrecisionDouble)
+ * defines the types of the coefficients and of the intermediate states. The
+ * samples are converted to the state type when they are read and rounded to
+ * the type of the output buffer when they are written, i.e. blocks of float
+ * samples (player) as well as blocks of double samples (offline processing,
+ * reference signals) may be filtered.
+ *
+ * Filters with poles close to the unit circle (e.g. lowpass filters of higher
+ * order with a low cutoff frequency) accumulate the rounding errors of float
+ * states, the output drifts or hisses on long signals. Double states avoid
+ * this at the cost of throughput (no vector kernels, see CFilter).
+ *
+ * The states are stored by the derived class (CFilterBase::m_z is not used).
+ */
+template<class Precision>
+class CFilterPrecise: public CFilterBase {
+public:
+	typedef typename Precision::coef_t coef_t;
+	typedef typename Precision::state_t state_t;
+
+private:
+	/**
+	 * \brief filter coefficients of numerator (normalized by a0)
+	 */
+	coef_t *m_b;
+	/**
+	 * \brief filter coefficients of denominator (normalized by a0)
+	 */
+	coef_t *m_a;
+	/**
+	 * \brief intermediate states, m_zs[(m_order+1)*c+n] is zn of channel c
+	 */
+	state_t *m_zs;
+	/**
+	 * \brief filter file path
+	 */
+	string m_filePath;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * the coefficients are normalized with double precision and rounded to
+	 * the coefficient type of the policy afterwards
+	 *
+	 * - throws exception if order or channels are zero or if the coefficients
+	 *   are not available
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param ca pointer to array of denominator filter coefficients
+	 * \param cb pointer to array of numerator filter coefficients
+	 * \param order filter order
+	 * \param channels number of channels of original signal
+	 */
+	CFilterPrecise(const string &filePath, double *ca, double *cb,
+			uint16_t order, uint16_t channels = 2) :
+			CFilterBase(order, channels, 0) {
+		if ((ca == NULL) || (cb == NULL) || (ca[0] == 0.))
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Filter coefficients not available!");
+		m_filePath = filePath;
+		m_a = new coef_t[m_order + 1];
+		m_b = new coef_t[m_order + 1];
+		for (uint32_t i = 0; i <= m_order; i++) {
+			m_a[i] = (coef_t) (ca[i] / ca[0]);
+			m_b[i] = (coef_t) (cb[i] / ca[0]);
+		}
+		m_zs = new state_t[(m_order + 1) * m_channels];
+		reset();
+		m_hasChannelFilter = true;
+		cout << "CFilterPrecise<" << Precision::getName() << ">@" << hex
+				<< this << dec << " created" << endl;
+	}
+	/**
+	 * \brief deletes coefficients and states
+	 */
+	virtual ~CFilterPrecise() {
+		delete[] m_a;
+		delete[] m_b;
+		delete[] m_zs;
+		cout << "CFilterPrecise<" << Precision::getName() << ">@" << hex
+				<< this << dec << " destroyed" << endl;
+	}
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param x pointer on block buffer of original signal
+	 * \param y pointer on block buffer of filtered signal (may be x)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *x, float *y, uint16_t framesPerBuffer) {
+		if ((framesPerBuffer < m_order) || (x == NULL) || (y == NULL))
+			return false;
+
+		x = _addDenormalOffset(x, y, framesPerBuffer);
+		bool ok;
+		if (_filterParallel(x, y, framesPerBuffer, ok))
+			return ok;
+		_filterDF2T(x, y, framesPerBuffer, m_channels, 0, m_channels);
+		return true;
+	}
+	/**
+	 * \brief Filters a signal with double precision samples.
+	 *
+	 * \param x pointer on block buffer of original signal (interleaved)
+	 * \param y pointer on block buffer of filtered signal (may be x)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(double *x, double *y, uint16_t framesPerBuffer) {
+		if ((framesPerBuffer < m_order) || (x == NULL) || (y == NULL))
+			return false;
+		_filterDF2T(x, y, framesPerBuffer, m_channels, 0, m_channels);
+		return true;
+	}
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+
+	/**
+	 * \brief clears the intermediate states
+	 */
+	void reset() {
+		CFilterBase::reset();
+		for (uint32_t i = 0; i < (m_order + 1) * m_channels; i++)
+			m_zs[i] = 0.;
+	}
+	/**
+	 * \brief gets full qualified pathname of the filter file
+	 * \return path of filter file
+	 */
+	string getFilePath() {
+		return m_filePath;
+	}
+	/**
+	 * \brief gets the name of the precision policy
+	 * \return name of the policy
+	 */
+	static string getPrecisionName() {
+		return string(Precision::getName());
+	}
+
+protected:
+	/**
+	 * \brief filters one channel of a block (channel-parallel mode, planar blocks)
+	 */
+	bool _filterChannel(uint16_t channel, float *x, float *y,
+			uint16_t framesPerBuffer) {
+		_filterDF2T(x, y, framesPerBuffer, 1, channel, 1);
+		return true;
+	}
+
+private:
+	/**
+	 * \brief difference equation for the channels firstChannel ...
+	 * firstChannel+numChannels-1 (frames are stride samples apart)
+	 *
+	 * the same expression as the scalar kernel of CFilter, evaluated with the
+	 * state type of the policy
+	 */
+	template<typename T>
+	void _filterDF2T(T *x, T *y, uint16_t framesPerBuffer, int stride,
+			uint16_t firstChannel, uint16_t numChannels) {
+		int bufsize = framesPerBuffer * stride;
+		// locals: the stores into y and z do not force reloads of the members
+		const coef_t *b = m_b, *a = m_a;
+		uint32_t order = m_order;
+		for (int i = 0; i < numChannels; i++) {
+			state_t *z = m_zs + (order + 1) * (firstChannel + i);
+			for (int k = i; k < bufsize; k += stride) {
+				state_t xk = x[k];
+				state_t yk = b[0] * xk + z[0];
+				y[k] = (T) yk;
+				for (uint32_t n = 1; n <= order; n++)
+					z[n - 1] = b[n] * xk - a[n] * yk + z[n];
+			}
+		}
+	}
+};
+
+/**
+ * \brief creates direct form filters with the chosen precision
+ */
+class CFilterPreciseFactory {
+public:
+	/**
+	 * \brief available precision policies
+	 */
+	enum PRECISION {
+		PRECISION_FLOAT,	///< float coefficients and states (CPrecisionFloat)
+		PRECISION_MIXED,	///< float coefficients, double states (CPrecisionMixed)
+		PRECISION_DOUBLE	///< double coefficients and states (CPrecisionDouble)
+	};
+
+	/**
+	 * \brief creates a direct form II transposed filter
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param ca pointer to array of denominator filter coefficients
+	 * \param cb pointer to array of numerator filter coefficients
+	 * \param order filter order
+	 * \param channels number of channels of original signal
+	 * \param precision precision policy
+	 * \return new filter (owned by the caller)
+	 */
+	static CFilterBase* create(const string &filePath, double *ca, double *cb,
+			uint16_t order, uint16_t channels, PRECISION precision);
+	/**
+	 * \brief gets the name of a precision policy
+	 * \param precision precision policy
+	 * \return name of the policy
+	 */
+	static string getPrecisionName(PRECISION precision);
+};
+
+#endif /* CFILTERPRECISE_H_ */
@@ -0,0 +1,314 @@
+/**
+ * \file CFilterSOS.cpp
+ * \brief implementation CFilterSOS
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <math.h>
+#include <float.h>
+#include <SKSLib.h>
+#include "CPolynomial.h"
+#include "CFilterSOS.h"
+
+/*
+ * roots with an imaginary part below this (relative) value are real
+ */
+#define CSOS_REALTOL 1e-9
+
+/*
+ * zero units used to build the numerators of the sections
+ */
+enum CSOS_UNITKIND {
+	CSOS_COMPLEX, // conjugate complex pair (2 zeros)
+	CSOS_REAL,    // real zero
+	CSOS_DELAY    // pure delay z^-1 (leading zero numerator coefficients)
+};
+struct CSOS_UNIT {
+	CSOS_UNITKIND kind;
+	complex<double> q;
+	bool used;
+};
+
+/*
+ * helper: first order factor f0 + f1*z^-1 of a unit (real zeros and delays only)
+ */
+static void _firstOrder(CSOS_UNIT &u, double *f) {
+	if (u.kind == CSOS_DELAY) {
+		f[0] = 0.;
+		f[1] = 1.;
+	} else {
+		f[0] = 1.;
+		f[1] = -u.q.real();
+	}
+}
+
+/*
+ * helper: distance of a zero unit to a pole (delays are "far away")
+ */
+static double _distance(CSOS_UNIT &u, complex<double> p) {
+	if (u.kind == CSOS_DELAY)
+		return DBL_MAX;
+	return abs(u.q - p);
+}
+
+/*
+ * helper: is the root real?
+ */
+static bool _isReal(complex<double> r) {
+	return fabs(r.imag()) <= CSOS_REALTOL * fmax(1., abs(r));
+}
+
+CFilterSOS::CFilterSOS(const string &filePath, float *ca, float *cb,
+		uint16_t order, uint16_t channels) :
+		CFilterBase(order, channels, channels * 2 * ((order + 1) / 2)) {
+	m_filePath = filePath;
+	m_numSections = (m_order + 1) / 2;
+	m_sos = NULL;
+	m_hasChannelFilter = true;
+
+	if ((ca == NULL) || (cb == NULL) || (ca[0] == 0.))
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter coefficients not available!");
+	if (m_order > MAX_ORDER)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter order too high for second order sections!");
+
+	m_sos = new float[5 * m_numSections];
+	if (!_factor(ca, cb)) {
+		delete[] m_sos;
+		m_sos = NULL;
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter coefficients could not be factored!");
+	}
+	cout << "CFilterSOS@" << hex << this << dec << " created" << endl;
+}
+
+CFilterSOS::~CFilterSOS() {
+	if (m_sos != NULL)
+		delete[] m_sos;
+	cout << "CFilterSOS@" << hex << this << dec << " destroyed" << endl;
+}
+
+bool CFilterSOS::_factor(float *ca, float *cb) {
+	int n = m_order;
+	double a[MAX_ORDER + 1] = {}, b[MAX_ORDER + 1] = {};
+	complex<double> p[MAX_ORDER], q[MAX_ORDER];
+	for (int i = 0; i <= n; i++) {
+		a[i] = (double) ca[i] / ca[0];
+		b[i] = (double) cb[i] / ca[0];
+	}
+
+	// poles
+	if (CPolynomial::roots(a, n, p) != n)
+		return false;
+
+	// zeros: leading zero coefficients of b are delays
+	int lead = 0;
+	while ((lead <= n) && (b[lead] == 0.))
+		lead++;
+	double gain = 0.;
+	int nq = 0;
+	if (lead <= n) {
+		gain = b[lead];
+		nq = CPolynomial::roots(b + lead, n - lead, q);
+		if (nq != n - lead)
+			return false;
+	} else
+		lead = n;	// numerator is zero, any delays will do
+
+	CSOS_UNIT units[MAX_ORDER];
+	int numUnits = 0, numReal = lead;
+	for (int i = 0; i < lead; i++)
+		units[numUnits++] = { CSOS_DELAY, 0., false };
+	for (int i = 0; i < nq; i++) {
+		if (_isReal(q[i])) {
+			units[numUnits++] = { CSOS_REAL, q[i].real(), false };
+			numReal++;
+		} else if (q[i].imag() > 0.)
+			units[numUnits++] = { CSOS_COMPLEX, q[i], false };
+	}
+
+	// pole sections: conjugate pairs, real poles paired by decreasing radius
+	complex<double> secPole[MAX_ORDER]; // representative pole (Im >= 0)
+	double secA[MAX_ORDER][2];
+	int secOrder[MAX_ORDER];
+	int numSec = 0;
+	double realPoles[MAX_ORDER];
+	int numRealPoles = 0;
+	for (int i = 0; i < n; i++) {
+		if (_isReal(p[i]))
+			realPoles[numRealPoles++] = p[i].real();
+		else if (p[i].imag() > 0.) {
+			secPole[numSec] = p[i];
+			secA[numSec][0] = -2. * p[i].real();
+			secA[numSec][1] = norm(p[i]);
+			secOrder[numSec++] = 2;
+		}
+	}
+	for (int i = 1; i < numRealPoles; i++)	// insertion sort, |p| descending
+		for (int j = i; (j > 0) && (fabs(realPoles[j]) > fabs(realPoles[j - 1])); j--) {
+			double t = realPoles[j];
+			realPoles[j] = realPoles[j - 1];
+			realPoles[j - 1] = t;
+		}
+	for (int i = 0; i < numRealPoles; i += 2) {
+		secPole[numSec] = realPoles[i];
+		if (i + 1 < numRealPoles) {
+			secA[numSec][0] = -(realPoles[i] + realPoles[i + 1]);
+			secA[numSec][1] = realPoles[i] * realPoles[i + 1];
+			secOrder[numSec++] = 2;
+		} else {
+			secA[numSec][0] = -realPoles[i];
+			secA[numSec][1] = 0.;
+			secOrder[numSec++] = 1;
+		}
+	}
+	if (numSec != m_numSections)
+		return false;
+
+	// process the sections from the pole closest to the unit circle, the
+	// first order section (if any) is processed last
+	int idx[MAX_ORDER];
+	for (int i = 0; i < numSec; i++)
+		idx[i] = i;
+	for (int i = 1; i < numSec; i++)
+		for (int j = i; j > 0; j--) {
+			int s0 = idx[j - 1], s1 = idx[j];
+			bool swap = (secOrder[s1] > secOrder[s0])
+					|| ((secOrder[s1] == secOrder[s0])
+							&& (abs(secPole[s1]) > abs(secPole[s0])));
+			if (!swap)
+				break;
+			idx[j - 1] = s1;
+			idx[j] = s0;
+		}
+
+	// assign the zeros nearest to the poles of each section
+	double secB[MAX_ORDER][3];
+	bool firstOrderPending = (secOrder[idx[numSec - 1]] == 1);
+	for (int k = 0; k < numSec; k++) {
+		int s = idx[k];
+		int reserve = (firstOrderPending && (secOrder[s] == 2)) ? 1 : 0;
+		if (secOrder[s] == 1) {
+			// the remaining unit is a real zero or a delay
+			for (int u = 0; u < numUnits; u++)
+				if (!units[u].used) {
+					units[u].used = true;
+					_firstOrder(units[u], secB[s]);
+					secB[s][2] = 0.;
+					break;
+				}
+			firstOrderPending = false;
+			continue;
+		}
+		// nearest conjugate pair and the two nearest real units
+		int uc = -1, ur0 = -1, ur1 = -1;
+		for (int u = 0; u < numUnits; u++) {
+			if (units[u].used)
+				continue;
+			double d = _distance(units[u], secPole[s]);
+			if (units[u].kind == CSOS_COMPLEX) {
+				if ((uc < 0) || (d < _distance(units[uc], secPole[s])))
+					uc = u;
+			} else if ((ur0 < 0) || (d < _distance(units[ur0], secPole[s]))) {
+				ur1 = ur0;
+				ur0 = u;
+			} else if ((ur1 < 0) || (d < _distance(units[ur1], secPole[s])))
+				ur1 = u;
+		}
+		bool useComplex = (uc >= 0)
+				&& ((numReal < 2 + reserve)
+						|| (_distance(units[uc], secPole[s])
+								<= _distance(units[ur0], secPole[s])));
+		if (useComplex) {
+			units[uc].used = true;
+			secB[s][0] = 1.;
+			secB[s][1] = -2. * units[uc].q.real();
+			secB[s][2] = norm(units[uc].q);
+		} else if ((ur0 >= 0) && (ur1 >= 0)) {
+			double f[2], g[2];
+			units[ur0].used = true;
+			units[ur1].used = true;
+			numReal -= 2;
+			_firstOrder(units[ur0], f);
+			_firstOrder(units[ur1], g);
+			secB[s][0] = f[0] * g[0];
+			secB[s][1] = f[0] * g[1] + f[1] * g[0];
+			secB[s][2] = f[1] * g[1];
+		} else
+			return false;
+	}
+
+	// store the sections, poles farthest from the unit circle first, the
+	// gain is applied to the first section
+	for (int k = 0; k < numSec; k++) {
+		int s = idx[numSec - 1 - k];
+		double g = (k == 0) ? gain : 1.;
+		m_sos[5 * k + 0] = g * secB[s][0];
+		m_sos[5 * k + 1] = g * secB[s][1];
+		m_sos[5 * k + 2] = g * secB[s][2];
+		m_sos[5 * k + 3] = secA[s][0];
+		m_sos[5 * k + 4] = secA[s][1];
+	}
+	return true;
+}
+
+bool CFilterSOS::filter(float *x, float *y, uint16_t framesPerBuffer) {
+	if ((x == NULL) || (y == NULL) || (m_sos == NULL))
+		return false;
+
+	x = _addDenormalOffset(x, y, framesPerBuffer);
+	bool ok;
+	if (_filterParallel(x, y, framesPerBuffer, ok))
+		return ok;
+	for (int c = 0; c < m_channels; c++)
+		_cascade(c, x + c, y + c, framesPerBuffer, m_channels);
+	return true;
+}
+
+bool CFilterSOS::_filterChannel(uint16_t channel, float *x, float *y,
+		uint16_t framesPerBuffer) {
+	if (m_sos == NULL)
+		return false;
+	_cascade(channel, x, y, framesPerBuffer, 1);
+	return true;
+}
+
+void CFilterSOS::_cascade(int c, float *xc, float *yc, int N, int stride) {
+	int S = m_numSections;
+	float *z = m_z + c * 2 * S;
+	// p[s]: output of section s, waiting to be processed by section s+1
+	float p[MAX_ORDER / 2];
+	// time step t: section s processes frame t-s (prologue t<S-1, epilogue t>=N)
+	for (int t = 0; t < N + S - 1; t++) {
+		int sLo = (t - N + 1 > 0) ? t - N + 1 : 0;
+		int sHi = (t < S - 1) ? t : S - 1;
+		// descending order: p[s-1] is read before section s-1 overwrites it
+		for (int s = sHi; s >= sLo; s--) {
+			const float *cf = m_sos + 5 * s;
+			float *zs = z + 2 * s;
+			float in = (s == 0) ? xc[t * stride] : p[s - 1];
+			float out = cf[0] * in + zs[0];
+			zs[0] = cf[1] * in - cf[3] * out + zs[1];
+			zs[1] = cf[2] * in - cf[4] * out;
+			p[s] = out;
+		}
+		if (t >= S - 1)
+			yc[(t - S + 1) * stride] = p[S - 1];
+	}
+}
+
+uint16_t CFilterSOS::getNumSections() {
+	return m_numSections;
+}
+
+const float* CFilterSOS::getSection(uint16_t section) {
+	if (section >= m_numSections)
+		return NULL;
+	return m_sos + 5 * section;
+}
+
+string CFilterSOS::getFilePath() {
+	return m_filePath;
+}
@@ -0,0 +1,125 @@
+/**
+ * \file CFilterSOS.h
+ * \brief interface CFilterSOS
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERSOS_H_
+#define CFILTERSOS_H_
+#include "CFilterBase.h"
+
+/**
+ * \brief IIR filter calculated as a cascade of second order sections (biquads)
+ *
+ * The numerator and denominator polynomials of the filter are factored into
+ * their roots when the filter is created. Poles and zeros are grouped into
+ * sections of order 2 (one section of order 1 for odd filter orders). The
+ * sections are ordered by the pole radius, the section with the poles closest
+ * to the unit circle comes last. Each section is calculated by direct form II
+ * transposed.
+ *
+ * Compared with a single high order direct form this is numerically robust,
+ * because the poles of a section only depend on its own two coefficients.
+ *
+ * The sections are pipelined over the frames of a block: in time step t
+ * section s processes frame t-s, so all sections work on independent data
+ * and are in flight at the same time. Prologue and epilogue of the pipeline
+ * are handled within each block, therefore the filter has no additional latency.
+ */
+class CFilterSOS: public CFilterBase {
+public:
+	/**
+	 * \brief maximum filter order that is factored into sections
+	 */
+	static const uint16_t MAX_ORDER = 32;
+
+private:
+	/**
+	 * \brief number of sections
+	 */
+	uint16_t m_numSections;
+	/**
+	 * \brief coefficients of the sections
+	 *
+	 * 5 elements per section: b0, b1, b2, a1, a2 (a0 is 1)
+	 */
+	float *m_sos;
+	/*
+	 * filter file path
+	 */
+	string m_filePath;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * - factors the filter coefficients into sections
+	 * - initializes the states of the sections (m_z: 2 states per section and channel)
+	 * - throws exception if order or channels are zero, if the order exceeds
+	 *   MAX_ORDER or if the polynomials could not be factored
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param ca pointer to array of denominator filter coefficients
+	 * \param cb pointer to array of numerator filter coefficients
+	 * \param order filter order
+	 * \param channels number of channels of original signal
+	 */
+	CFilterSOS(const string &filePath, float *ca, float *cb, uint16_t order,
+			uint16_t channels = 2);
+	/**
+	 * \brief deletes the section coefficients
+	 */
+	virtual ~CFilterSOS();
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+
+	/**
+	 * \brief gets the number of second order sections
+	 * \return number of sections
+	 */
+	uint16_t getNumSections();
+	/**
+	 * \brief gets the coefficients of a section
+	 * \param section index of the section
+	 * \return pointer to b0, b1, b2, a1, a2 of the section or NULL for an invalid index
+	 */
+	const float* getSection(uint16_t section);
+
+	/**
+	 * \brief gets full qualified pathname of the filter file
+	 * \return path of filter file
+	 */
+	string getFilePath();
+
+protected:
+	/**
+	 * \brief filters one channel of a block (channel-parallel mode)
+	 */
+	bool _filterChannel(uint16_t channel, float *x, float *y,
+			uint16_t framesPerBuffer);
+
+private:
+	/**
+	 * \brief runs the sections of one channel (frames are stride samples apart)
+	 */
+	void _cascade(int c, float *xc, float *yc, int N, int stride);
+	/**
+	 * \brief factors the coefficients into sections and stores them in m_sos
+	 * \return false if the roots could not be calculated
+	 */
+	bool _factor(float *ca, float *cb);
+};
+
+#endif /* CFILTERSOS_H_ */
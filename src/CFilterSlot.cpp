@@ -0,0 +1,249 @@
+/**
+ * \file CFilterSlot.cpp
+ * \brief implementation CFilterSlot
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <string.h>
+#include <SKSLib.h>
+#include "CFilterSlot.h"
+
+CFilterSlot::CFilterSlot(uint32_t scratchSize) :
+		m_pending(NULL), m_pendingScratch(NULL), m_retiredScratch(NULL) {
+	for (int i = 0; i < RETIRE_SLOTS; i++)
+		m_retired[i].store(NULL);
+	m_pActive = NULL;
+	m_pCurrent = NULL;
+	m_channels = 0;
+	m_scratchCapacity = scratchSize;
+	m_pScratch = _newScratch(scratchSize);
+	cout << "CFilterSlot@" << hex << this << dec << " created" << endl;
+}
+
+CFilterSlot::~CFilterSlot() {
+	collect();
+	CFilterBase *pPending = m_pending.exchange(NULL);
+	if ((pPending != NULL) && (pPending != _noFilter()))
+		delete pPending;
+	if (m_pActive)
+		delete m_pActive;
+	_deleteScratch(m_pScratch);
+	_deleteScratch(m_pendingScratch.exchange(NULL));
+	cout << "CFilterSlot@" << hex << this << dec << " destroyed" << endl;
+}
+
+CFilterBase* CFilterSlot::_noFilter() {
+	return reinterpret_cast<CFilterBase*>(&m_noFilter);
+}
+
+CFilterSlot::SCRATCH* CFilterSlot::_newScratch(uint32_t size) {
+	SCRATCH *pScratch = new SCRATCH;
+	pScratch->samples = new float[size];
+	pScratch->size = size;
+	return pScratch;
+}
+
+void CFilterSlot::_deleteScratch(SCRATCH *pScratch) {
+	if (pScratch == NULL)
+		return;
+	delete[] pScratch->samples;
+	delete pScratch;
+}
+
+void CFilterSlot::publish(CFilterBase *pFilter, uint16_t maxFrames) {
+	collect();
+	// a block of the new filter fits into the scratch buffer (handed over
+	// before the filter, taken by the audio thread with the filter)
+	uint32_t size =
+			pFilter ? (uint32_t) pFilter->getNumChannels() * maxFrames : 0;
+	if (size > m_scratchCapacity) {
+		m_scratchCapacity = size;
+		_deleteScratch(m_pendingScratch.exchange(_newScratch(size),
+				std::memory_order_acq_rel));
+	}
+	CFilterBase *pOld = m_pending.exchange(pFilter ? pFilter : _noFilter(),
+			std::memory_order_acq_rel);
+	// the audio thread has never seen the replaced filter
+	if ((pOld != NULL) && (pOld != _noFilter()))
+		delete pOld;
+	m_pCurrent = pFilter;
+}
+
+int CFilterSlot::collect() {
+	int num = 0;
+	for (int i = 0; i < RETIRE_SLOTS; i++) {
+		CFilterBase *pOld = m_retired[i].exchange(NULL,
+				std::memory_order_acquire);
+		if (pOld) {
+			delete pOld;
+			num++;
+		}
+	}
+	_deleteScratch(m_retiredScratch.exchange(NULL, std::memory_order_acquire));
+	return num;
+}
+
+CFilterBase* CFilterSlot::getFilter() {
+	return m_pCurrent;
+}
+
+int CFilterSlot::_freeRetireSlot() {
+	for (int i = 0; i < RETIRE_SLOTS; i++)
+		if (m_retired[i].load(std::memory_order_acquire) == NULL)
+			return i;
+	return -1;
+}
+
+bool CFilterSlot::_run(CFilterBase *pFilter, float *inBuf, float *outBuf,
+		uint16_t frames, uint16_t channels) {
+	if (pFilter)
+		return pFilter->filter(inBuf, outBuf, frames);
+	if (inBuf != outBuf)
+		memcpy(outBuf, inBuf, frames * channels * sizeof(float));
+	return true;
+}
+
+CFilterBase* CFilterSlot::_takePending(int &retireSlot) {
+	// take a new filter only if the old one can be retired afterwards
+	retireSlot = -1;
+	if (m_pending.load(std::memory_order_relaxed) == NULL)
+		return NULL;
+	retireSlot = _freeRetireSlot();
+	if (retireSlot < 0)
+		return NULL;
+	return m_pending.exchange(NULL, std::memory_order_acquire);
+}
+
+void CFilterSlot::_takeScratch() {
+	if ((m_pendingScratch.load(std::memory_order_relaxed) == NULL)
+			|| (m_retiredScratch.load(std::memory_order_acquire) != NULL))
+		return;
+	SCRATCH *pScratch = m_pendingScratch.exchange(NULL,
+			std::memory_order_acquire);
+	if (pScratch) {
+		m_retiredScratch.store(m_pScratch, std::memory_order_release);
+		m_pScratch = pScratch;
+	}
+}
+
+bool CFilterSlot::_canCrossfade(CFilterBase *pNew, CFilterBase *pOld) {
+	if ((pNew == NULL) && (pOld == NULL))
+		return false;
+	// different signal (new sound file)
+	if (pNew && pOld && (pNew->getNumChannels() != pOld->getNumChannels()))
+		return false;
+	// the outputs must belong to the same block (pipeline)
+	return (pNew ? pNew->getLatency() : 0) == (pOld ? pOld->getLatency() : 0);
+}
+
+void CFilterSlot::_retire(CFilterBase *pNew, CFilterBase *pOld,
+		int retireSlot) {
+	m_pActive = pNew;
+	if (pOld)
+		m_retired[retireSlot].store(pOld, std::memory_order_release);
+}
+
+bool CFilterSlot::_run(CFilterBase *pFilter, CAudioBlock &inBlock,
+		CAudioBlock &outBlock) {
+	if (pFilter)
+		return pFilter->filter(inBlock, outBlock);
+	return outBlock.copy(inBlock);
+}
+
+bool CFilterSlot::filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer) {
+	if ((inBuf == NULL) || (outBuf == NULL))
+		return false;
+
+	int retireSlot;
+	CFilterBase *pNext = _takePending(retireSlot);
+	if (pNext == NULL) {
+		if (m_pActive)
+			return m_pActive->filter(inBuf, outBuf, framesPerBuffer);
+		if ((inBuf != outBuf) && (m_channels == 0))
+			return false;
+		return _run(NULL, inBuf, outBuf, framesPerBuffer, m_channels);
+	}
+	_takeScratch();
+
+	CFilterBase *pNew = (pNext == _noFilter()) ? NULL : pNext;
+	CFilterBase *pOld = m_pActive;
+	if ((pNew == NULL) && (pOld == NULL)) {
+		if ((inBuf != outBuf) && (m_channels == 0))
+			return false;
+		return _run(NULL, inBuf, outBuf, framesPerBuffer, m_channels);
+	}
+	uint16_t channels = (pNew ? pNew : pOld)->getNumChannels();
+	m_channels = channels;
+	bool fits = (uint32_t) framesPerBuffer * channels <= m_pScratch->size;
+	if (!_canCrossfade(pNew, pOld) || !fits) {
+		// switch over without crossfade
+		bool ok = _run(pNew, inBuf, outBuf, framesPerBuffer, channels);
+		_retire(pNew, pOld, retireSlot);
+		return ok && fits;
+	}
+
+	// crossfade: new filter into the scratch buffer first, the old one may
+	// work in place
+	float *scratch = m_pScratch->samples;
+	bool ok = _run(pNew, inBuf, scratch, framesPerBuffer, channels);
+	ok &= _run(pOld, inBuf, outBuf, framesPerBuffer, channels);
+	float step = 1.f / framesPerBuffer;
+	for (uint32_t k = 0; k < framesPerBuffer; k++) {
+		float g = (k + 0.5f) * step;
+		for (int c = 0; c < channels; c++) {
+			float yOld = outBuf[k * channels + c];
+			outBuf[k * channels + c] = yOld
+					+ g * (scratch[k * channels + c] - yOld);
+		}
+	}
+	_retire(pNew, pOld, retireSlot);
+	return ok;
+}
+
+bool CFilterSlot::filter(CAudioBlock &inBlock, CAudioBlock &outBlock) {
+	uint16_t framesPerBuffer = inBlock.getNumFrames();
+	uint16_t channels = inBlock.getNumChannels();
+	if ((outBlock.getNumChannels() != channels)
+			|| (outBlock.getMaxFrames() < framesPerBuffer))
+		return false;
+
+	int retireSlot;
+	CFilterBase *pNext = _takePending(retireSlot);
+	if (pNext == NULL)
+		return _run(m_pActive, inBlock, outBlock);
+	_takeScratch();
+	CFilterBase *pNew = (pNext == _noFilter()) ? NULL : pNext;
+	CFilterBase *pOld = m_pActive;
+	if (pNew)
+		m_channels = pNew->getNumChannels();
+	bool fits = (uint32_t) framesPerBuffer * channels <= m_pScratch->size;
+	if (!_canCrossfade(pNew, pOld) || !fits) {
+		// switch over without crossfade
+		bool ok = _run(pNew, inBlock, outBlock);
+		_retire(pNew, pOld, retireSlot);
+		return ok && fits;
+	}
+
+	// crossfade plane by plane: new filter into the scratch planes first, the
+	// old one may work in place
+	CAudioBlock scratch(m_pScratch->samples, channels, framesPerBuffer,
+			framesPerBuffer);
+	bool ok = _run(pNew, inBlock, scratch);
+	ok &= _run(pOld, inBlock, outBlock);
+	float step = 1.f / framesPerBuffer;
+	for (int c = 0; c < channels; c++) {
+		float *yc = outBlock.getChannel(c), *sc = scratch.getChannel(c);
+		for (uint32_t k = 0; k < framesPerBuffer; k++) {
+			float g = (k + 0.5f) * step;
+			yc[k] = yc[k] + g * (sc[k] - yc[k]);
+		}
+	}
+	_retire(pNew, pOld, retireSlot);
+	return ok;
+}
+
+void CFilterSlot::reset() {
+	if (m_pActive)
+		m_pActive->reset();
+}
@@ -0,0 +1,212 @@
+/**
+ * \file CFilterSlot.h
+ * \brief interface CFilterSlot
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERSLOT_H_
+#define CFILTERSLOT_H_
+
+#include <atomic>
+#include "CFilterBase.h"
+
+/**
+ * \brief slot for the filter of a running audio stream (lock-free hot-swap)
+ *
+ * Two threads share the slot:
+ * - the control thread creates filters (allocation, file access, console
+ *   output) and hands them over by publish(), it deletes the filters that are
+ *   no longer used by collect()
+ * - the audio thread calls filter() for each block
+ *
+ * A published filter is passed through an atomic pointer. The audio thread
+ * takes it at the beginning of the next block and crossfades from the old to
+ * the new filter across this block (both filters process the block). Filters
+ * of different latency (see CFilterBase::getLatency()) or number of channels
+ * are switched over without crossfade, their outputs do not belong to the
+ * same block resp. signal. The old
+ * filter is then put into a retire list of atomic pointers, where the control
+ * thread picks it up. filter() neither locks, allocates nor prints.
+ *
+ * The output of the new filter is buffered by a scratch buffer during the
+ * crossfade. publish() allocates a larger one if the new filter processes
+ * larger blocks, the audio thread takes it with the filter and retires the
+ * old one. A block is always crossfaded in one piece (filters like
+ * CFilterPipeline only accept complete blocks), a block larger than the
+ * scratch buffer is switched over without crossfade.
+ *
+ * The slot owns all filters that have been published.
+ */
+class CFilterSlot {
+public:
+	/**
+	 * \brief size of the retire list
+	 */
+	static const int RETIRE_SLOTS = 4;
+
+private:
+	/**
+	 * \brief crossfade buffer
+	 */
+	struct SCRATCH {
+		float *samples;
+		uint32_t size;		///< samples
+	};
+
+	/**
+	 * \brief filter published by the control thread, not yet taken by the audio thread
+	 *
+	 * NULL: nothing published, _noFilter(): the filter has been removed
+	 */
+	std::atomic<CFilterBase*> m_pending;
+	/**
+	 * \brief filters no longer used by the audio thread (NULL: free entry)
+	 */
+	std::atomic<CFilterBase*> m_retired[RETIRE_SLOTS];
+	/**
+	 * \brief filter used by the audio thread (NULL: no filter)
+	 */
+	CFilterBase *m_pActive;
+	/**
+	 * \brief most recently published filter (control thread only)
+	 */
+	CFilterBase *m_pCurrent;
+	/**
+	 * \brief channels of the last filter used by the audio thread (0: none yet)
+	 */
+	uint16_t m_channels;
+	/**
+	 * \brief output of the new filter during the crossfade (audio thread)
+	 */
+	SCRATCH *m_pScratch;
+	/**
+	 * \brief larger scratch buffer published with a filter, old scratch
+	 * buffer retired by the audio thread (NULL: none)
+	 */
+	std::atomic<SCRATCH*> m_pendingScratch;
+	std::atomic<SCRATCH*> m_retiredScratch;
+	/**
+	 * \brief size of the largest scratch buffer published (control thread only)
+	 */
+	uint32_t m_scratchCapacity;
+	/**
+	 * \brief its address marks a removed filter in m_pending
+	 */
+	char m_noFilter;
+
+public:
+	/**
+	 * \brief Constructor (control thread)
+	 *
+	 * \param scratchSize initial samples of the crossfade buffer (see publish())
+	 */
+	CFilterSlot(uint32_t scratchSize = 16384);
+	/**
+	 * \brief Destructor, deletes all filters (audio must not run)
+	 */
+	~CFilterSlot();
+
+	/**
+	 * \brief hands over a new filter to the audio thread (control thread)
+	 *
+	 * A filter that has been published before but not yet been taken by the
+	 * audio thread is deleted immediately.
+	 *
+	 * \param pFilter new filter (the slot takes ownership), NULL removes the filter
+	 * \param maxFrames maximum frames per block, the crossfade buffer is
+	 * enlarged to hold a block of the filter (larger blocks are switched over
+	 * without crossfade)
+	 */
+	void publish(CFilterBase *pFilter, uint16_t maxFrames = 0);
+	/**
+	 * \brief deletes the filters (and the scratch buffer) retired by the
+	 * audio thread (control thread)
+	 * \return number of deleted filters
+	 */
+	int collect();
+	/**
+	 * \brief most recently published filter (control thread)
+	 *
+	 * The filter stays valid until the next call of publish(). Its parameters
+	 * must not be changed while audio is running.
+	 *
+	 * \return filter or NULL
+	 */
+	CFilterBase* getFilter();
+
+	/**
+	 * \brief filters a block by the current filter (audio thread)
+	 *
+	 * copies the block if there is no filter, crossfades if a new filter has
+	 * been published since the last block
+	 *
+	 * Without any filter so far the number of channels is unknown, the block
+	 * is then only passed if the filtering is done in place.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false:
+	 * outBuf has not been written, or the block exceeded the crossfade buffer
+	 * and the filters have been switched over without crossfade)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief filters a planar block by the current filter (audio thread)
+	 *
+	 * same as the interleaved variant, the block is copied if there is no filter
+	 *
+	 * \param inBlock original signal
+	 * \param outBlock filtered signal (may be inBlock)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(CAudioBlock &inBlock, CAudioBlock &outBlock);
+	/**
+	 * \brief resets the active filter (audio thread or audio stopped)
+	 */
+	void reset();
+
+private:
+	/**
+	 * \brief marker for a removed filter
+	 */
+	CFilterBase* _noFilter();
+	/**
+	 * \brief index of a free entry of the retire list or -1
+	 */
+	int _freeRetireSlot();
+	/**
+	 * \brief takes the published filter if the active one can be retired
+	 * \param retireSlot [out] free entry of the retire list
+	 * \return published filter, _noFilter() or NULL (nothing to take)
+	 */
+	CFilterBase* _takePending(int &retireSlot);
+	/**
+	 * \brief takes the published scratch buffer if the old one can be retired
+	 */
+	void _takeScratch();
+	/**
+	 * \brief checks if the outputs of two filters can be crossfaded (same
+	 * signal and latency, not both missing)
+	 */
+	static bool _canCrossfade(CFilterBase *pNew, CFilterBase *pOld);
+	/**
+	 * \brief makes the new filter the active one, retires the old one
+	 */
+	void _retire(CFilterBase *pNew, CFilterBase *pOld, int retireSlot);
+	static SCRATCH* _newScratch(uint32_t size);
+	static void _deleteScratch(SCRATCH *pScratch);
+	/**
+	 * \brief runs a filter or copies if there is none
+	 */
+	static bool _run(CFilterBase *pFilter, float *inBuf, float *outBuf,
+			uint16_t frames, uint16_t channels);
+	/**
+	 * \brief runs a filter on a planar block or copies if there is none
+	 */
+	static bool _run(CFilterBase *pFilter, CAudioBlock &inBlock,
+			CAudioBlock &outBlock);
+};
+
+#endif /* CFILTERSLOT_H_ */
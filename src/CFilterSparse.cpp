@@ -0,0 +1,103 @@
+/**
+ * \file CFilterSparse.cpp
+ * \brief implementation CFilterSparse
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <SKSLib.h>
+#include "CFilterSparse.h"
+
+uint32_t CFilterSparse::_ringSize(uint32_t order) {
+	uint32_t size = 1;
+	while (size <= order)
+		size <<= 1;
+	return size;
+}
+
+CFilterSparse::CFilterSparse(const string &filePath, uint32_t *aIdx,
+		float *aVal, int numA, uint32_t *bIdx, float *bVal, int numB,
+		uint32_t order, uint16_t channels) :
+		CFilterBase(order, channels, channels * _ringSize(order)) {
+	m_filePath = filePath;
+	m_mask = _ringSize(m_order) - 1;
+	m_pos = 0;
+	m_numA = 0;
+	m_numB = 0;
+	m_aIdx = NULL;
+	m_aVal = NULL;
+	m_bIdx = NULL;
+	m_bVal = NULL;
+
+	// a0 for normalization
+	float a0 = 0.;
+	if ((aIdx != NULL) && (aVal != NULL) && (bIdx != NULL) && (bVal != NULL))
+		for (int i = 0; i < numA; i++)
+			if (aIdx[i] == 0)
+				a0 = aVal[i];
+	if (a0 == 0.)
+		throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+				"Filter coefficients not available!");
+
+	m_bIdx = new uint32_t[numB];
+	m_bVal = new float[numB];
+	for (int i = 0; i < numB; i++)
+		if (bIdx[i] <= m_order) {
+			m_bIdx[m_numB] = bIdx[i];
+			m_bVal[m_numB++] = bVal[i] / a0;
+		}
+	m_aIdx = new uint32_t[numA];
+	m_aVal = new float[numA];
+	for (int i = 0; i < numA; i++)
+		if ((aIdx[i] != 0) && (aIdx[i] <= m_order)) {
+			m_aIdx[m_numA] = aIdx[i];
+			m_aVal[m_numA++] = aVal[i] / a0;
+		}
+
+	cout << "CFilterSparse@" << hex << this << dec << " created" << endl;
+}
+
+CFilterSparse::~CFilterSparse() {
+	if (m_aIdx != NULL) {
+		delete[] m_aIdx;
+		delete[] m_aVal;
+	}
+	if (m_bIdx != NULL) {
+		delete[] m_bIdx;
+		delete[] m_bVal;
+	}
+	cout << "CFilterSparse@" << hex << this << dec << " destroyed" << endl;
+}
+
+bool CFilterSparse::filter(float *x, float *y, uint16_t framesPerBuffer) {
+	if ((x == NULL) || (y == NULL))
+		return false;
+
+	x = _addDenormalOffset(x, y, framesPerBuffer);
+	uint32_t ringSize = m_mask + 1;
+	for (int f = 0; f < framesPerBuffer; f++) {
+		m_pos = (m_pos + 1) & m_mask;
+		for (int c = 0; c < m_channels; c++) {
+			float *w = m_z + c * ringSize;
+			// w(k) = x(k) - sum ai*w(k-i)
+			float wk = x[f * m_channels + c];
+			for (int i = 0; i < m_numA; i++)
+				wk -= m_aVal[i] * w[(m_pos - m_aIdx[i]) & m_mask];
+			w[m_pos] = wk;
+			// y(k) = sum bi*w(k-i)
+			float yk = 0.;
+			for (int i = 0; i < m_numB; i++)
+				yk += m_bVal[i] * w[(m_pos - m_bIdx[i]) & m_mask];
+			y[f * m_channels + c] = yk;
+		}
+	}
+	return true;
+}
+
+int CFilterSparse::getNumTaps() {
+	return m_numA + 1 + m_numB;
+}
+
+string CFilterSparse::getFilePath() {
+	return m_filePath;
+}
@@ -0,0 +1,119 @@
+/**
+ * \file CFilterSparse.h
+ * \brief interface CFilterSparse
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CFILTERSPARSE_H_
+#define CFILTERSPARSE_H_
+#include "CFilterBase.h"
+
+/**
+ * \brief filter for sparse coefficient sets (e.g. delay lines approximated by long filters)
+ *
+ * Only the non-zero coefficients (taps) are stored and calculated. The filter
+ * is calculated by direct form II, so there is only one intermediate signal
+ * w(k) = x(k) - a1*w(k-1) - ... - an*w(k-n) and y(k) = b0*w(k) + ... + bn*w(k-n).
+ * The history of w is kept in a circular buffer per channel (m_z), its length is
+ * the power of 2 above the highest tap index. The cost per sample only depends
+ * on the number of taps, not on the order.
+ */
+class CFilterSparse: public CFilterBase {
+private:
+	/**
+	 * \brief number of numerator taps
+	 */
+	int m_numB;
+	/**
+	 * \brief indices (delays) of the numerator taps
+	 */
+	uint32_t *m_bIdx;
+	/**
+	 * \brief values of the numerator taps (normalized by a0)
+	 */
+	float *m_bVal;
+	/**
+	 * \brief number of denominator taps without a0
+	 */
+	int m_numA;
+	/**
+	 * \brief indices (delays) of the denominator taps without a0
+	 */
+	uint32_t *m_aIdx;
+	/**
+	 * \brief values of the denominator taps (normalized by a0)
+	 */
+	float *m_aVal;
+	/**
+	 * \brief length of the circular buffer of each channel (power of 2) - 1
+	 */
+	uint32_t m_mask;
+	/**
+	 * \brief position of w(k) in the circular buffers
+	 */
+	uint32_t m_pos;
+	/*
+	 * filter file path
+	 */
+	string m_filePath;
+
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * - copies the taps
+	 * - creates the circular buffers (m_z)
+	 * - throws exception if order or channels are zero or if a0 is missing
+	 *
+	 * \param filePath path of the associated filter file
+	 * \param aIdx indices of the denominator taps (must contain index 0)
+	 * \param aVal values of the denominator taps
+	 * \param numA number of denominator taps
+	 * \param bIdx indices of the numerator taps
+	 * \param bVal values of the numerator taps
+	 * \param numB number of numerator taps
+	 * \param order filter order (highest tap index)
+	 * \param channels number of channels of original signal
+	 */
+	CFilterSparse(const string &filePath, uint32_t *aIdx, float *aVal,
+			int numA, uint32_t *bIdx, float *bVal, int numB, uint32_t order,
+			uint16_t channels = 2);
+	/**
+	 * \brief deletes the taps
+	 */
+	virtual ~CFilterSparse();
+	/**
+	 * \brief Filters a signal.
+	 *
+	 * \param inBuf pointer on block buffer of original signal
+	 * \param outBuf pointer on block buffer of filtered signal (may be inBuf)
+	 * \param framesPerBuffer no of frames in the block buffers (original & filtered)
+	 * \return flag for successful execution (true) or error condition (false)
+	 */
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer);
+	/**
+	 * \brief filters a planar block (see CFilterBase)
+	 */
+	using CFilterBase::filter;
+	/**
+	 * \brief gets the total number of taps (a0 included)
+	 * \return number of taps
+	 */
+	int getNumTaps();
+
+	/**
+	 * \brief gets full qualified pathname of the filter file
+	 * \return path of filter file
+	 */
+	string getFilePath();
+
+private:
+	/**
+	 * \brief length of the circular buffer for the given order
+	 * \return power of 2 above order
+	 */
+	static uint32_t _ringSize(uint32_t order);
+};
+
+#endif /* CFILTERSPARSE_H_ */
@@ -0,0 +1,116 @@
+/**
+ * \file CMappedFile.cpp
+ * \brief implementation CMappedFile
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "CMappedFile.h"
+
+CMappedFile::CMappedFile() {
+	m_pData = NULL;
+	m_size = 0;
+	m_hFile = m_hMapping = NULL;
+}
+
+CMappedFile::~CMappedFile() {
+	unmap();
+}
+
+bool CMappedFile::map(const string &path) {
+	unmap();
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+			NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size)) {
+		CloseHandle(hFile);
+		return false;
+	}
+	m_hFile = hFile;
+	m_size = (size_t) size.QuadPart;
+	if (m_size == 0)
+		return true;	// empty files can't be mapped
+	m_hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_hMapping != NULL)
+		m_pData = (const uint8_t*) MapViewOfFile(m_hMapping, FILE_MAP_READ, 0,
+				0, 0);
+	if (m_pData == NULL) {
+		unmap();
+		return false;
+	}
+	return true;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		::close(fd);
+		return false;
+	}
+	m_size = (size_t) st.st_size;
+	if (m_size > 0) {
+		void *p = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED)
+			m_pData = (const uint8_t*) p;
+	}
+	::close(fd);	// the mapping keeps the file open
+	if ((m_size > 0) && (m_pData == NULL)) {
+		m_size = 0;
+		return false;
+	}
+	// marks the file as mapped even if it is empty
+	m_hFile = (void*) this;
+	return true;
+#endif
+}
+
+void CMappedFile::unmap() {
+#ifdef _WIN32
+	if (m_pData != NULL)
+		UnmapViewOfFile(m_pData);
+	if (m_hMapping != NULL)
+		CloseHandle(m_hMapping);
+	if (m_hFile != NULL)
+		CloseHandle(m_hFile);
+#else
+	if (m_pData != NULL)
+		munmap((void*) m_pData, m_size);
+#endif
+	m_pData = NULL;
+	m_size = 0;
+	m_hFile = m_hMapping = NULL;
+}
+
+bool CMappedFile::isMapped() {
+	return m_hFile != NULL;
+}
+
+const uint8_t* CMappedFile::getData() {
+	return m_pData;
+}
+
+size_t CMappedFile::getSize() {
+	return m_size;
+}
+
+bool CMappedFile::getFileInfo(const string &path, int64_t &mtime,
+		uint64_t &size) {
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		return false;
+	mtime = (int64_t) st.st_mtime;
+	size = (uint64_t) st.st_size;
+	return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * \file CMappedFile.h
+ * \brief interface CMappedFile
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CMAPPEDFILE_H_
+#define CMAPPEDFILE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+using namespace std;
+
+/**
+ * \brief read only memory mapping of a whole file
+ *
+ * The contents of the file are accessed like an array, the operating system
+ * loads the pages on demand (no read buffer, no copy). Unchanged pages of
+ * recently used files stay in the page cache, mapping them again is cheap.
+ *
+ * POSIX: mmap(), Windows: file mapping objects.
+ */
+class CMappedFile {
+private:
+	/**
+	 * \brief first byte of the mapping (NULL if not mapped)
+	 */
+	const uint8_t *m_pData;
+	/**
+	 * \brief size of the file in bytes
+	 */
+	size_t m_size;
+	/**
+	 * \brief file and mapping handles (Windows only)
+	 */
+	void *m_hFile, *m_hMapping;
+
+public:
+	/**
+	 * \brief Constructor (no file mapped)
+	 */
+	CMappedFile();
+	/**
+	 * \brief Destructor, unmaps the file
+	 */
+	~CMappedFile();
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+
+	/**
+	 * \brief maps a file (a file mapped before is unmapped)
+	 * \param path path of the file
+	 * \return true if the file is mapped (an empty file is mapped with size
+	 * 0), false if it can't be opened or mapped
+	 */
+	bool map(const string &path);
+	/**
+	 * \brief unmaps the file
+	 */
+	void unmap();
+	/**
+	 * \brief checks if a file is mapped
+	 */
+	bool isMapped();
+	/**
+	 * \brief gets the contents of the file
+	 * \return first byte (NULL if the file is empty or not mapped)
+	 */
+	const uint8_t* getData();
+	/**
+	 * \brief gets the size of the file
+	 * \return number of bytes
+	 */
+	size_t getSize();
+
+	/**
+	 * \brief gets size and modification time of a file without opening it
+	 * \param path path of the file
+	 * \param mtime [out] modification time (seconds since the epoch)
+	 * \param size [out] size in bytes
+	 * \return false if there is no such file
+	 */
+	static bool getFileInfo(const string &path, int64_t &mtime,
+			uint64_t &size);
+};
+
+#endif /* CMAPPEDFILE_H_ */
@@ -0,0 +1,595 @@
+/**
+ * \file CPcmConvert.cpp
+ * \brief implementation CPcmConvert
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <math.h>
+#include <string.h>
+#include "CSimd.h"
+#include "CPcmConvert.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPCMCONVERT_X86
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CPCMCONVERT_NEON
+#endif
+
+/*
+ * normalization factors (2^-(n-1))
+ */
+#define CPCMCONVERT_SCALE8 (1.f / 128.f)
+#define CPCMCONVERT_SCALE16 (1.f / 32768.f)
+#define CPCMCONVERT_SCALE24 (1.f / 8388608.f)
+#define CPCMCONVERT_SCALE32 (1.f / 2147483648.f)
+/*
+ * random numbers of the dither: upper 24 bits of the generator * 2^-24
+ */
+#define CPCMCONVERT_RANDSCALE (1.f / 16777216.f)
+
+/*
+ * xorshift generator of the dither (period 2^32-1, state must not be 0)
+ */
+static inline uint32_t _xorshift(uint32_t x) {
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+/*
+ * TPDF random number -1 ... 1 (difference of two uniform numbers 0 ... 1)
+ */
+static inline float _tpdf(uint32_t &state) {
+	state = _xorshift(state);
+	float r1 = (float) (state >> 8) * CPCMCONVERT_RANDSCALE;
+	state = _xorshift(state);
+	float r2 = (float) (state >> 8) * CPCMCONVERT_RANDSCALE;
+	return r1 - r2;
+}
+
+/*
+ * scaled, dithered, clipped and rounded sample (the scalar reference of the
+ * quantizing kernels), pState is the generator of the sample or NULL
+ */
+static inline int32_t _quantize(float x, float scale, float lo, float hi,
+		uint32_t *pState) {
+	float v = x * scale;
+	if (pState)
+		v += _tpdf(*pState);
+	// fmaxf() maps NaN to lo like the max instructions of the kernels
+	v = fminf(fmaxf(v, lo), hi);
+	return (int32_t) lrintf(v);
+}
+
+/*
+ * scaling factor and clipping range of n bit samples, the upper limit is the
+ * largest float not above 2^(n-1)-1
+ */
+static void _quantRange(int bits, float &scale, float &lo, float &hi) {
+	scale = ldexpf(1.f, bits - 1);
+	lo = -scale;
+	hi = (bits > 24) ? nextafterf(scale, 0.f) : scale - 1.f;
+}
+
+/*
+ * The kernels convert as many samples as fit into whole registers and return
+ * the number of samples converted, the rest is left to the scalar loop.
+ *
+ * 24 bit: the bytes of a sample are shuffled into the upper three bytes of a
+ * 32 bit lane, an arithmetic shift by 8 extends the sign. A load of 16 bytes
+ * covers 4 samples (12 bytes), the kernel stops early enough not to read
+ * behind the last sample.
+ *
+ * The quantizing kernels keep the 8 dither generators in registers (one AVX
+ * register resp. two SSE/NEON registers), the generator of a lane is advanced
+ * twice per sample like the scalar loop does. Each kernel converts a multiple
+ * of 8 samples, therefore the scalar loop continues with the right generator.
+ * The 24 bit output stores 16 bytes per 4 samples (12 bytes), the bytes
+ * behind a group are overwritten by the next group, the kernel stops early
+ * enough not to write behind the last sample.
+ */
+#ifdef CPCMCONVERT_X86
+__attribute__((target("sse2")))
+static size_t _int16SSE(const int16_t *in, float *out, size_t num) {
+	const __m128 scale = _mm_set1_ps(CPCMCONVERT_SCALE16);
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+		// the sample in the upper half of each lane, then sign extended
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t _int16AVX2(const int16_t *in, float *out, size_t num) {
+	const __m256 scale = _mm256_set1_ps(CPCMCONVERT_SCALE16);
+	size_t i = 0;
+	for (; i + 16 <= num; i += 16) {
+		__m256i lo = _mm256_cvtepi16_epi32(
+				_mm_loadu_si128((const __m128i*) (in + i)));
+		__m256i hi = _mm256_cvtepi16_epi32(
+				_mm_loadu_si128((const __m128i*) (in + i + 8)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+		_mm256_storeu_ps(out + i + 8,
+				_mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t _int24AVX2(const uint8_t *in, float *out, size_t num) {
+	const __m256 scale = _mm256_set1_ps(CPCMCONVERT_SCALE24);
+	// lane j: zero byte, bytes 3j ... 3j+2 of the sample
+	const __m256i shuffle = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6,
+			7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9,
+			10, 11);
+	size_t i = 0;
+	// 8 samples from two loads of 16 bytes at 0 and 12 (28 bytes read)
+	for (; i + 10 <= num; i += 8) {
+		const uint8_t *p = in + 3 * i;
+		__m256i v = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) p)),
+				_mm_loadu_si128((const __m128i*) (p + 12)), 1);
+		v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, shuffle), 8);
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+	return i;
+}
+
+__attribute__((target("sse2")))
+static size_t _int32SSE(const int32_t *in, float *out, size_t num) {
+	const __m128 scale = _mm_set1_ps(CPCMCONVERT_SCALE32);
+	size_t i = 0;
+	for (; i + 4 <= num; i += 4)
+		_mm_storeu_ps(out + i,
+				_mm_mul_ps(
+						_mm_cvtepi32_ps(
+								_mm_loadu_si128((const __m128i*) (in + i))),
+						scale));
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t _int32AVX2(const int32_t *in, float *out, size_t num) {
+	const __m256 scale = _mm256_set1_ps(CPCMCONVERT_SCALE32);
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8)
+		_mm256_storeu_ps(out + i,
+				_mm256_mul_ps(
+						_mm256_cvtepi32_ps(
+								_mm256_loadu_si256((const __m256i*) (in + i))),
+						scale));
+	return i;
+}
+
+__attribute__((target("sse2")))
+static inline __m128i _xorshiftSSE(__m128i x) {
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i _quantizeSSE(const float *in, __m128 scale, __m128 lo,
+		__m128 hi, __m128i *pState) {
+	__m128 v = _mm_mul_ps(_mm_loadu_ps(in), scale);
+	if (pState) {
+		const __m128 k = _mm_set1_ps(CPCMCONVERT_RANDSCALE);
+		*pState = _xorshiftSSE(*pState);
+		__m128 r1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(*pState, 8)), k);
+		*pState = _xorshiftSSE(*pState);
+		__m128 r2 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(*pState, 8)), k);
+		v = _mm_add_ps(v, _mm_sub_ps(r1, r2));
+	}
+	// max returns the second operand for NaN
+	return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(v, lo), hi));
+}
+
+__attribute__((target("sse2")))
+static size_t _toInt16SSE(const float *in, int16_t *out, size_t num,
+		uint32_t *pState) {
+	const __m128 scale = _mm_set1_ps(32768.f), lo = _mm_set1_ps(-32768.f),
+			hi = _mm_set1_ps(32767.f);
+	__m128i state[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+	if (pState) {
+		state[0] = _mm_loadu_si128((const __m128i*) pState);
+		state[1] = _mm_loadu_si128((const __m128i*) (pState + 4));
+	}
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8) {
+		__m128i q0 = _quantizeSSE(in + i, scale, lo, hi,
+				pState ? state : NULL);
+		__m128i q1 = _quantizeSSE(in + i + 4, scale, lo, hi,
+				pState ? state + 1 : NULL);
+		_mm_storeu_si128((__m128i*) (out + i), _mm_packs_epi32(q0, q1));
+	}
+	if (pState) {
+		_mm_storeu_si128((__m128i*) pState, state[0]);
+		_mm_storeu_si128((__m128i*) (pState + 4), state[1]);
+	}
+	return i;
+}
+
+__attribute__((target("sse2")))
+static size_t _toInt32SSE(const float *in, int32_t *out, size_t num,
+		int bits, uint32_t *pState) {
+	float fScale, fLo, fHi;
+	_quantRange(bits, fScale, fLo, fHi);
+	const __m128 scale = _mm_set1_ps(fScale), lo = _mm_set1_ps(fLo), hi =
+			_mm_set1_ps(fHi);
+	const __m128i shift = _mm_cvtsi32_si128(32 - bits);
+	__m128i state[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+	if (pState) {
+		state[0] = _mm_loadu_si128((const __m128i*) pState);
+		state[1] = _mm_loadu_si128((const __m128i*) (pState + 4));
+	}
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8)
+		for (int h = 0; h < 2; h++)
+			_mm_storeu_si128((__m128i*) (out + i + 4 * h),
+					_mm_sll_epi32(
+							_quantizeSSE(in + i + 4 * h, scale, lo, hi,
+									pState ? state + h : NULL), shift));
+	if (pState) {
+		_mm_storeu_si128((__m128i*) pState, state[0]);
+		_mm_storeu_si128((__m128i*) (pState + 4), state[1]);
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i _xorshiftAVX2(__m256i x) {
+	x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+	return _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i _quantizeAVX2(const float *in, __m256 scale, __m256 lo,
+		__m256 hi, __m256i *pState) {
+	__m256 v = _mm256_mul_ps(_mm256_loadu_ps(in), scale);
+	if (pState) {
+		const __m256 k = _mm256_set1_ps(CPCMCONVERT_RANDSCALE);
+		*pState = _xorshiftAVX2(*pState);
+		__m256 r1 = _mm256_mul_ps(
+				_mm256_cvtepi32_ps(_mm256_srli_epi32(*pState, 8)), k);
+		*pState = _xorshiftAVX2(*pState);
+		__m256 r2 = _mm256_mul_ps(
+				_mm256_cvtepi32_ps(_mm256_srli_epi32(*pState, 8)), k);
+		v = _mm256_add_ps(v, _mm256_sub_ps(r1, r2));
+	}
+	return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(v, lo), hi));
+}
+
+__attribute__((target("avx2")))
+static size_t _toInt16AVX2(const float *in, int16_t *out, size_t num,
+		uint32_t *pState) {
+	const __m256 scale = _mm256_set1_ps(32768.f), lo = _mm256_set1_ps(
+			-32768.f), hi = _mm256_set1_ps(32767.f);
+	__m256i state = _mm256_setzero_si256();
+	if (pState)
+		state = _mm256_loadu_si256((const __m256i*) pState);
+	size_t i = 0;
+	for (; i + 16 <= num; i += 16) {
+		__m256i q0 = _quantizeAVX2(in + i, scale, lo, hi,
+				pState ? &state : NULL);
+		__m256i q1 = _quantizeAVX2(in + i + 8, scale, lo, hi,
+				pState ? &state : NULL);
+		// packs works on 128 bit lanes: q0 lo, q1 lo, q0 hi, q1 hi
+		_mm256_storeu_si256((__m256i*) (out + i),
+				_mm256_permute4x64_epi64(_mm256_packs_epi32(q0, q1), 0xD8));
+	}
+	if (pState)
+		_mm256_storeu_si256((__m256i*) pState, state);
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t _toInt24AVX2(const float *in, uint8_t *out, size_t num,
+		uint32_t *pState) {
+	const __m256 scale = _mm256_set1_ps(8388608.f), lo = _mm256_set1_ps(
+			-8388608.f), hi = _mm256_set1_ps(8388607.f);
+	// lower three bytes of the 4 lanes into the first 12 bytes
+	const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12,
+			13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1,
+			-1, -1, -1);
+	__m256i state = _mm256_setzero_si256();
+	if (pState)
+		state = _mm256_loadu_si256((const __m256i*) pState);
+	size_t i = 0;
+	// 8 samples by two stores of 16 bytes at 0 and 12 (28 bytes written)
+	for (; i + 10 <= num; i += 8) {
+		__m256i q = _mm256_shuffle_epi8(
+				_quantizeAVX2(in + i, scale, lo, hi, pState ? &state : NULL),
+				shuffle);
+		uint8_t *p = out + 3 * i;
+		_mm_storeu_si128((__m128i*) p, _mm256_castsi256_si128(q));
+		_mm_storeu_si128((__m128i*) (p + 12), _mm256_extracti128_si256(q, 1));
+	}
+	if (pState)
+		_mm256_storeu_si256((__m256i*) pState, state);
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t _toInt32AVX2(const float *in, int32_t *out, size_t num,
+		int bits, uint32_t *pState) {
+	float fScale, fLo, fHi;
+	_quantRange(bits, fScale, fLo, fHi);
+	const __m256 scale = _mm256_set1_ps(fScale), lo = _mm256_set1_ps(fLo),
+			hi = _mm256_set1_ps(fHi);
+	const __m128i shift = _mm_cvtsi32_si128(32 - bits);
+	__m256i state = _mm256_setzero_si256();
+	if (pState)
+		state = _mm256_loadu_si256((const __m256i*) pState);
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8)
+		_mm256_storeu_si256((__m256i*) (out + i),
+				_mm256_sll_epi32(
+						_quantizeAVX2(in + i, scale, lo, hi,
+								pState ? &state : NULL), shift));
+	if (pState)
+		_mm256_storeu_si256((__m256i*) pState, state);
+	return i;
+}
+#endif
+
+#ifdef CPCMCONVERT_NEON
+static size_t _int16NEON(const int16_t *in, float *out, size_t num) {
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8) {
+		int16x8_t v = vld1q_s16(in + i);
+		vst1q_f32(out + i,
+				vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))),
+						CPCMCONVERT_SCALE16));
+		vst1q_f32(out + i + 4,
+				vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))),
+						CPCMCONVERT_SCALE16));
+	}
+	return i;
+}
+
+static size_t _int24NEON(const uint8_t *in, float *out, size_t num) {
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8) {
+		// de-interleaves the low, middle and high bytes of 8 samples
+		uint8x8x3_t b = vld3_u8(in + 3 * i);
+		uint16x8_t low = vorrq_u16(vmovl_u8(b.val[0]), vshll_n_u8(b.val[1], 8));
+		int16x8_t high = vmovl_s8(vreinterpret_s8_u8(b.val[2]));
+		int32x4_t v0 = vorrq_s32(vshll_n_s16(vget_low_s16(high), 16),
+				vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+		int32x4_t v1 = vorrq_s32(vshll_n_s16(vget_high_s16(high), 16),
+				vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+		vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(v0), CPCMCONVERT_SCALE24));
+		vst1q_f32(out + i + 4,
+				vmulq_n_f32(vcvtq_f32_s32(v1), CPCMCONVERT_SCALE24));
+	}
+	return i;
+}
+
+static size_t _int32NEON(const int32_t *in, float *out, size_t num) {
+	size_t i = 0;
+	for (; i + 4 <= num; i += 4)
+		vst1q_f32(out + i,
+				vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in + i)),
+						CPCMCONVERT_SCALE32));
+	return i;
+}
+
+static inline uint32x4_t _xorshiftNEON(uint32x4_t x) {
+	x = veorq_u32(x, vshlq_n_u32(x, 13));
+	x = veorq_u32(x, vshrq_n_u32(x, 17));
+	return veorq_u32(x, vshlq_n_u32(x, 5));
+}
+
+static inline int32x4_t _quantizeNEON(const float *in, float32x4_t scale,
+		float32x4_t lo, float32x4_t hi, uint32x4_t *pState) {
+	float32x4_t v = vmulq_f32(vld1q_f32(in), scale);
+	if (pState) {
+		*pState = _xorshiftNEON(*pState);
+		float32x4_t r1 = vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(*pState, 8)),
+				CPCMCONVERT_RANDSCALE);
+		*pState = _xorshiftNEON(*pState);
+		float32x4_t r2 = vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(*pState, 8)),
+				CPCMCONVERT_RANDSCALE);
+		v = vaddq_f32(v, vsubq_f32(r1, r2));
+	}
+	// maxnm returns the number for NaN
+	return vcvtnq_s32_f32(vminnmq_f32(vmaxnmq_f32(v, lo), hi));
+}
+
+static size_t _toIntNEON(const float *in, void *out, size_t num, int bits,
+		uint32_t *pState) {
+	float fScale, fLo, fHi;
+	_quantRange(bits, fScale, fLo, fHi);
+	const float32x4_t scale = vdupq_n_f32(fScale), lo = vdupq_n_f32(fLo), hi =
+			vdupq_n_f32(fHi);
+	const int32x4_t shift = vdupq_n_s32(32 - bits);
+	uint32x4_t state[2] = { vdupq_n_u32(0), vdupq_n_u32(0) };
+	if (pState) {
+		state[0] = vld1q_u32(pState);
+		state[1] = vld1q_u32(pState + 4);
+	}
+	size_t i = 0;
+	for (; i + 8 <= num; i += 8) {
+		int32x4_t q0 = _quantizeNEON(in + i, scale, lo, hi,
+				pState ? state : NULL);
+		int32x4_t q1 = _quantizeNEON(in + i + 4, scale, lo, hi,
+				pState ? state + 1 : NULL);
+		if (bits == 16)
+			vst1q_s16((int16_t*) out + i,
+					vcombine_s16(vqmovn_s32(q0), vqmovn_s32(q1)));
+		else if (bits == 24) {
+			// low, middle and high bytes interleaved by the store
+			uint8x8x3_t b;
+			uint32x4_t u0 = vreinterpretq_u32_s32(q0), u1 =
+					vreinterpretq_u32_s32(q1);
+			for (int k = 0; k < 3; k++)
+				b.val[k] = vmovn_u16(
+						vcombine_u16(
+								vmovn_u32(vshlq_u32(u0, vdupq_n_s32(-8 * k))),
+								vmovn_u32(vshlq_u32(u1, vdupq_n_s32(-8 * k)))));
+			vst3_u8((uint8_t*) out + 3 * i, b);
+		} else {
+			vst1q_s32((int32_t*) out + i, vshlq_s32(q0, shift));
+			vst1q_s32((int32_t*) out + i + 4, vshlq_s32(q1, shift));
+		}
+	}
+	if (pState) {
+		vst1q_u32(pState, state[0]);
+		vst1q_u32(pState + 4, state[1]);
+	}
+	return i;
+}
+#endif
+
+void CPcmConvert::initDither(DITHER &dither, uint32_t seed) {
+	for (int l = 0; l < DITHER_LANES; l++) {
+		// different, non-zero start values of the generators
+		uint32_t x = seed + 0x9E3779B9u * (l + 1);
+		for (int k = 0; k < 4; k++)
+			x = _xorshift(x ? x : 1);
+		dither.state[l] = x;
+	}
+}
+
+void CPcmConvert::uint8ToFloat(const uint8_t *in, float *out, size_t num) {
+	for (size_t i = 0; i < num; i++)
+		out[i] = (float) ((int) in[i] - 128) * CPCMCONVERT_SCALE8;
+}
+
+void CPcmConvert::int16ToFloat(const int16_t *in, float *out, size_t num,
+		bool vectorized) {
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _int16AVX2(in, out, num);
+		else if (CSimd::hasSSE2())
+			i = _int16SSE(in, out, num);
+#endif
+#ifdef CPCMCONVERT_NEON
+		i = _int16NEON(in, out, num);
+#endif
+	}
+	for (; i < num; i++)
+		out[i] = (float) in[i] * CPCMCONVERT_SCALE16;
+}
+
+void CPcmConvert::int24ToFloat(const uint8_t *in, float *out, size_t num,
+		bool vectorized) {
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _int24AVX2(in, out, num);
+#endif
+#ifdef CPCMCONVERT_NEON
+		i = _int24NEON(in, out, num);
+#endif
+	}
+	for (; i < num; i++) {
+		const uint8_t *p = in + 3 * i;
+		// sample in the upper 24 bits, the shift extends the sign
+		int32_t s = (int32_t) (((uint32_t) p[0] << 8) | ((uint32_t) p[1] << 16)
+				| ((uint32_t) p[2] << 24)) >> 8;
+		out[i] = (float) s * CPCMCONVERT_SCALE24;
+	}
+}
+
+void CPcmConvert::int32ToFloat(const int32_t *in, float *out, size_t num,
+		bool vectorized) {
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _int32AVX2(in, out, num);
+		else if (CSimd::hasSSE2())
+			i = _int32SSE(in, out, num);
+#endif
+#ifdef CPCMCONVERT_NEON
+		i = _int32NEON(in, out, num);
+#endif
+	}
+	for (; i < num; i++)
+		out[i] = (float) in[i] * CPCMCONVERT_SCALE32;
+}
+
+void CPcmConvert::floatToInt16(const float *in, int16_t *out, size_t num,
+		DITHER *pDither, bool vectorized) {
+	uint32_t *pState = pDither ? pDither->state : NULL;
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _toInt16AVX2(in, out, num, pState);
+		else if (CSimd::hasSSE2())
+			i = _toInt16SSE(in, out, num, pState);
+#endif
+#ifdef CPCMCONVERT_NEON
+		i = _toIntNEON(in, out, num, 16, pState);
+#endif
+	}
+	for (; i < num; i++)
+		out[i] = (int16_t) _quantize(in[i], 32768.f, -32768.f, 32767.f,
+				pState ? pState + i % DITHER_LANES : NULL);
+}
+
+void CPcmConvert::floatToInt24(const float *in, uint8_t *out, size_t num,
+		DITHER *pDither, bool vectorized) {
+	uint32_t *pState = pDither ? pDither->state : NULL;
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _toInt24AVX2(in, out, num, pState);
+#endif
+#ifdef CPCMCONVERT_NEON
+		i = _toIntNEON(in, out, num, 24, pState);
+#endif
+	}
+	for (; i < num; i++) {
+		int32_t q = _quantize(in[i], 8388608.f, -8388608.f, 8388607.f,
+				pState ? pState + i % DITHER_LANES : NULL);
+		uint8_t *p = out + 3 * i;
+		p[0] = (uint8_t) q;
+		p[1] = (uint8_t) (q >> 8);
+		p[2] = (uint8_t) (q >> 16);
+	}
+}
+
+void CPcmConvert::floatToInt32(const float *in, int32_t *out, size_t num,
+		int bits, DITHER *pDither, bool vectorized) {
+	if (bits < 16)
+		bits = 16;
+	if (bits > 32)
+		bits = 32;
+	uint32_t *pState = pDither ? pDither->state : NULL;
+	size_t i = 0;
+	if (vectorized) {
+#ifdef CPCMCONVERT_X86
+		if (CSimd::hasAVX2FMA())
+			i = _toInt32AVX2(in, out, num, bits, pState);
+		else if (CSimd::hasSSE2())
+			i = _toInt32SSE(in, out, num, bits, pState);
+#endif
+#ifdef CPCMCONVERT_NEON
+		if ((bits != 16) && (bits != 24))
+			i = _toIntNEON(in, out, num, bits, pState);
+#endif
+	}
+	float scale, lo, hi;
+	_quantRange(bits, scale, lo, hi);
+	for (; i < num; i++)
+		out[i] = (int32_t) ((uint32_t) _quantize(in[i], scale, lo, hi,
+				pState ? pState + i % DITHER_LANES : NULL) << (32 - bits));
+}
@@ -0,0 +1,126 @@
+/**
+ * \file CPcmConvert.h
+ * \brief interface CPcmConvert
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CPCMCONVERT_H_
+#define CPCMCONVERT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * \brief conversion of PCM samples to float and back
+ *
+ * The samples are normalized like libsndfile normalizes them when reading:
+ * an n bit sample is divided by 2^(n-1), the results are in
+ * -1 ... 1-2^(1-n). The scaling factors are powers of two, therefore the
+ * conversion is exact and the vectorized kernels deliver the same results as
+ * the scalar loops.
+ *
+ * Float to PCM multiplies by 2^(n-1), rounds to the nearest integer (ties to
+ * even) and clips to the range of n bits (NaN gives the smallest value).
+ * For 16 and 24 bit PCM -> float -> PCM gives the original samples. An
+ * optional TPDF dither (difference of two uniform random numbers, -1 ... 1
+ * LSB) is added before rounding, it decorrelates the quantization error from
+ * the signal (no distortion of quiet passages). The random numbers come from
+ * 8 xorshift generators, sample i uses generator i % 8, therefore all
+ * kernels deliver the same dithered results.
+ *
+ * The samples are little endian (WAV). 16 and 32 bit samples must be aligned
+ * to their size, 8 and 24 bit samples need no alignment. The vectorized
+ * kernels are selected at runtime (CSimd), the class provides static methods
+ * only.
+ */
+class CPcmConvert {
+public:
+	/**
+	 * \brief number of random generators of the dither
+	 */
+	static const int DITHER_LANES = 8;
+	/**
+	 * \brief state of the dither, continued by the next call
+	 */
+	struct DITHER {
+		uint32_t state[DITHER_LANES];
+	};
+
+	/**
+	 * \brief initializes a dither
+	 * \param dither dither
+	 * \param seed start value of the random numbers
+	 */
+	static void initDither(DITHER &dither, uint32_t seed = 1);
+
+	/**
+	 * \brief converts unsigned 8 bit samples (offset 128)
+	 * \param in samples
+	 * \param out float samples
+	 * \param num number of samples
+	 */
+	static void uint8ToFloat(const uint8_t *in, float *out, size_t num);
+	/**
+	 * \brief converts signed 16 bit samples
+	 * \param in samples
+	 * \param out float samples
+	 * \param num number of samples
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void int16ToFloat(const int16_t *in, float *out, size_t num,
+			bool vectorized = true);
+	/**
+	 * \brief converts packed signed 24 bit samples (3 bytes per sample)
+	 * \param in first byte of the samples
+	 * \param out float samples
+	 * \param num number of samples
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void int24ToFloat(const uint8_t *in, float *out, size_t num,
+			bool vectorized = true);
+	/**
+	 * \brief converts signed 32 bit samples (rounded to 24 bit mantissa)
+	 * \param in samples
+	 * \param out float samples
+	 * \param num number of samples
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void int32ToFloat(const int32_t *in, float *out, size_t num,
+			bool vectorized = true);
+
+	/**
+	 * \brief converts float samples to signed 16 bit
+	 * \param in float samples
+	 * \param out samples
+	 * \param num number of samples
+	 * \param pDither dither (NULL: no dither)
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void floatToInt16(const float *in, int16_t *out, size_t num,
+			DITHER *pDither = NULL, bool vectorized = true);
+	/**
+	 * \brief converts float samples to packed signed 24 bit
+	 * \param in float samples
+	 * \param out first byte of the samples (3 bytes per sample)
+	 * \param num number of samples
+	 * \param pDither dither (NULL: no dither)
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void floatToInt24(const float *in, uint8_t *out, size_t num,
+			DITHER *pDither = NULL, bool vectorized = true);
+	/**
+	 * \brief converts float samples to n bit samples in the upper bits of
+	 * 32 bit integers (libsndfile int format)
+	 * \param in float samples
+	 * \param out samples
+	 * \param num number of samples
+	 * \param bits resolution 16 ... 32 (the lower 32-bits bits are zero)
+	 * \param pDither dither (NULL: no dither)
+	 * \param vectorized true: fastest kernel of the CPU, false: scalar loop
+	 */
+	static void floatToInt32(const float *in, int32_t *out, size_t num,
+			int bits = 32, DITHER *pDither = NULL, bool vectorized = true);
+};
+
+#endif /* CPCMCONVERT_H_ */
@@ -56,6 +56,14 @@ public:
 	 */
 	virtual bool keyPressed()=0;
 
+	/**
+	 * \brief Queries the text entered with the last key press (devices with
+	 * a keyboard), empty for single button devices.
+	 */
+	virtual string getKeyText() {
+		return string();
+	}
+
 	/**
 	 * \brief Queries the current state of the player controls as state name.
 	 */
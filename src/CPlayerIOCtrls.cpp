@@ -88,6 +88,10 @@ bool CPlayerIOCtrls::keyPressed() {
 	return m_thread->enterPressed();
 }
 
+string CPlayerIOCtrls::getKeyText() {
+	return m_thread->getEnteredText();
+}
+
 string CPlayerIOCtrls::getStateStr() {
 	return m_thread->getStateStr();
 }
@@ -89,6 +89,13 @@ public:
 	 */
 	bool keyPressed();
 
+	/**
+	 * \brief text of the line of the last ENTER
+	 *
+	 * \return text entered before ENTER (empty if only ENTER was pressed)
+	 */
+	string getKeyText();
+
 	/**
 	 * \return current state of the instance
 	 */
@@ -0,0 +1,104 @@
+/**
+ * \file CPolynomial.cpp
+ * \brief implementation CPolynomial
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "CPolynomial.h"
+
+/*
+ * maximum number of Aberth iterations and relative rounding error of the
+ * polynomial evaluation
+ */
+#define CPOLY_MAXITER 500
+#define CPOLY_EPS 4e-16
+
+int CPolynomial::roots(const double *c, int n, complex<double> *r) {
+	// leading zeros reduce the degree
+	while ((n > 0) && (c[0] == 0.)) {
+		c++;
+		n--;
+	}
+	if (n <= 0)
+		return 0;
+
+	// trailing zeros are roots at the origin
+	int nz = 0;
+	while ((n > 0) && (c[n] == 0.)) {
+		r[nz++] = 0.;
+		n--;
+	}
+	r += nz;
+	if (n == 0)
+		return nz;
+
+	// initial values on a circle with the radius of the Cauchy bound,
+	// the angular offset avoids symmetric starting positions
+	double rad = 0.;
+	for (int i = 1; i <= n; i++)
+		rad = fmax(rad, fabs(c[i] / c[0]));
+	rad = fmin(1. + rad, 2.);
+	for (int i = 0; i < n; i++)
+		r[i] = polar(rad, 2. * M_PI * i / n + 0.4);
+
+	// a root is converged if |p(ri)| is in the range of the rounding error of
+	// the evaluation (multiple roots can't be calculated more accurately)
+	bool *done = new bool[n];
+	for (int i = 0; i < n; i++)
+		done[i] = false;
+	int iter, numDone = 0;
+	for (iter = 0; (iter < CPOLY_MAXITER) && (numDone < n); iter++) {
+		for (int i = 0; i < n; i++) {
+			if (done[i])
+				continue;
+			// p(ri), p'(ri) and the error bound by Horner
+			complex<double> p = c[0], dp = 0.;
+			double bound = fabs(c[0]), ar = abs(r[i]);
+			for (int k = 1; k <= n; k++) {
+				dp = dp * r[i] + p;
+				p = p * r[i] + c[k];
+				bound = bound * ar + fabs(c[k]);
+			}
+			if (abs(p) <= CPOLY_EPS * bound) {
+				done[i] = true;
+				numDone++;
+				continue;
+			}
+			complex<double> ratio = p / dp;
+			complex<double> sum = 0.;
+			for (int j = 0; j < n; j++)
+				if (j != i)
+					sum += 1. / (r[i] - r[j]);
+			r[i] -= ratio / (1. - ratio * sum);
+		}
+	}
+	delete[] done;
+	if (numDone < n)
+		return -1;
+	return n + nz;
+}
+
+void CPolynomial::fromRoots(const complex<double> *r, int n, double *c) {
+	complex<double> *cc = new complex<double>[n + 1];
+	cc[0] = 1.;
+	for (int i = 1; i <= n; i++)
+		cc[i] = 0.;
+	// multiply by (z - ri)
+	for (int i = 0; i < n; i++)
+		for (int k = i + 1; k >= 1; k--)
+			cc[k] -= r[i] * cc[k - 1];
+	for (int i = 0; i <= n; i++)
+		c[i] = cc[i].real();
+	delete[] cc;
+}
+
+complex<double> CPolynomial::evalInv(const double *c, int n,
+		complex<double> w) {
+	complex<double> v = c[n];
+	for (int k = n - 1; k >= 0; k--)
+		v = v * w + c[k];
+	return v;
+}
@@ -0,0 +1,62 @@
+/**
+ * \file CPolynomial.h
+ * \brief interface CPolynomial
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CPOLYNOMIAL_H_
+#define CPOLYNOMIAL_H_
+
+#include <complex>
+using namespace std;
+
+/**
+ * \brief polynomial helpers for the analysis and factorization of filter coefficients
+ *
+ * A coefficient array c[0..n] of a filter (b or a) represents
+ * c0 + c1*z^-1 + ... + cn*z^-n = z^-n * (c0*z^n + c1*z^(n-1) + ... + cn),
+ * therefore its roots in the z plane are the roots of the polynomial with the
+ * coefficients in the same order (highest power first).
+ *
+ * The class provides static methods only.
+ */
+class CPolynomial {
+public:
+	/**
+	 * \brief calculates the roots of a polynomial (Aberth-Ehrlich iteration)
+	 *
+	 * Leading zero coefficients reduce the degree (roots at infinity resp.
+	 * pure delays in the z^-1 notation), they are not part of the result.
+	 *
+	 * \param c coefficients, highest power first
+	 * \param n degree (c has n+1 elements)
+	 * \param r [out] array for at least n roots
+	 * \return number of roots found or -1 if the iteration did not converge
+	 */
+	static int roots(const double *c, int n, complex<double> *r);
+
+	/**
+	 * \brief expands a product of linear factors (z-r0)(z-r1)... to a monic polynomial
+	 *
+	 * \param r roots
+	 * \param n number of roots
+	 * \param c [out] n+1 coefficients, highest power first (c[0]=1), imaginary
+	 * parts are dropped (conjugate complex roots are expected)
+	 */
+	static void fromRoots(const complex<double> *r, int n, double *c);
+
+	/**
+	 * \brief evaluates the polynomial c0 + c1*w + ... + cn*w^n (Horner scheme)
+	 *
+	 * used to evaluate filter coefficient arrays at w = z^-1
+	 *
+	 * \param c coefficients
+	 * \param n degree
+	 * \param w argument
+	 * \return value
+	 */
+	static complex<double> evalInv(const double *c, int n, complex<double> w);
+};
+
+#endif /* CPOLYNOMIAL_H_ */
@@ -0,0 +1,65 @@
+/**
+ * \file CSimd.cpp
+ * \brief implementation CSimd
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <new>
+#include <string.h>
+#include "CSimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CSIMD_X86
+#endif
+
+bool CSimd::hasSSE2() {
+#ifdef CSIMD_X86
+	return __builtin_cpu_supports("sse2");
+#else
+	return false;
+#endif
+}
+
+bool CSimd::hasAVX() {
+#ifdef CSIMD_X86
+	// __builtin_cpu_supports also checks the OS support for saving ymm registers
+	return __builtin_cpu_supports("avx");
+#else
+	return false;
+#endif
+}
+
+bool CSimd::hasAVX2FMA() {
+#ifdef CSIMD_X86
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+
+bool CSimd::hasNEON() {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return true;	// NEON is mandatory if the compiler generates code for it
+#else
+	return false;
+#endif
+}
+
+float* CSimd::allocAligned(size_t numElements) {
+	if (numElements == 0)
+		numElements = 1;
+	float *pBuf = static_cast<float*>(::operator new[](
+			numElements * sizeof(float), std::align_val_t(ALIGNMENT)));
+	memset(pBuf, 0, numElements * sizeof(float));
+	return pBuf;
+}
+
+void CSimd::freeAligned(float *pBuf) {
+	if (pBuf != NULL)
+		::operator delete[](pBuf, std::align_val_t(ALIGNMENT));
+}
+
+size_t CSimd::roundUp(size_t num, size_t gran) {
+	return ((num + gran - 1) / gran) * gran;
+}
@@ -0,0 +1,73 @@
+/**
+ * \file CSimd.h
+ * \brief interface CSimd
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CSIMD_H_
+#define CSIMD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * \brief runtime detection of SIMD instruction sets and aligned buffers
+ *
+ * The filter engines provide vectorized kernels for several instruction sets.
+ * The kernels are compiled into the executable regardless of the compiler
+ * flags (function target attributes), therefore the decision which kernel may
+ * be executed has to be taken at runtime by asking this class.
+ *
+ * The class provides static methods only.
+ */
+class CSimd {
+public:
+	/**
+	 * \brief alignment of buffers used by vectorized kernels (size of an AVX register)
+	 */
+	static const size_t ALIGNMENT = 32;
+
+	/**
+	 * \brief checks if the CPU supports SSE2 (x86 only)
+	 * \return true if supported, false otherwise
+	 */
+	static bool hasSSE2();
+	/**
+	 * \brief checks if the CPU and the operating system support AVX (x86 only)
+	 * \return true if supported, false otherwise
+	 */
+	static bool hasAVX();
+	/**
+	 * \brief checks if the CPU supports AVX2 and FMA3 (x86 only)
+	 * \return true if supported, false otherwise
+	 */
+	static bool hasAVX2FMA();
+	/**
+	 * \brief checks if NEON is available (ARM only)
+	 * \return true if supported, false otherwise
+	 */
+	static bool hasNEON();
+
+	/**
+	 * \brief allocates a zero initialized float array aligned to ALIGNMENT
+	 *
+	 * \param numElements number of float elements
+	 * \return address of the array (must be released by freeAligned())
+	 */
+	static float* allocAligned(size_t numElements);
+	/**
+	 * \brief releases an array allocated by allocAligned()
+	 * \param pBuf address of the array (NULL is accepted)
+	 */
+	static void freeAligned(float *pBuf);
+	/**
+	 * \brief rounds a number of elements up to a multiple of the given granularity
+	 * \param num number of elements
+	 * \param gran granularity (e.g. number of floats in a SIMD register)
+	 * \return rounded number
+	 */
+	static size_t roundUp(size_t num, size_t gran);
+};
+
+#endif /* CSIMD_H_ */
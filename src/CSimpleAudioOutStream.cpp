@@ -16,11 +16,15 @@ CSimpleAudioOutStream::CSimpleAudioOutStream() {
 	m_stream = NULL;
 	err = paNotInitialized;
 	m_state = S_NOTREADY;
+	m_playBuf = NULL;
+	m_playBufSize = 0;
 	numOBJ++;
 }
 CSimpleAudioOutStream::~CSimpleAudioOutStream() {
 	numOBJ--;
 	close();
+	if (m_playBuf)
+		delete[] m_playBuf;
 }
 
 void CSimpleAudioOutStream::open(uint16_t nChannels, uint32_t sampleRate,
@@ -32,6 +36,12 @@ void CSimpleAudioOutStream::open(uint16_t nChannels, uint32_t sampleRate,
 				"FramesPerBlock is negative");
 
 	if (m_state == S_NOTREADY) {
+		// interleaved buffer for planar blocks, nothing is allocated while playing
+		if (m_playBuf)
+			delete[] m_playBuf;
+		m_playBufSize = (uint32_t) nChannels * framesPerBlock;
+		m_playBuf = (m_playBufSize > 0) ? new float[m_playBufSize] : NULL;
+
 		err = Pa_Initialize();
 
 		if (err == paNoError) {
@@ -89,6 +99,14 @@ void CSimpleAudioOutStream::play(float* sbuf,int framesPerBlock){
 	}
 }
 
+void CSimpleAudioOutStream::play(CAudioBlock& block){
+	if ((uint32_t) block.getNumFrames() * block.getNumChannels() > m_playBufSize)
+		throw CException(CException::SRC_SimpleAudioDevice, -1,
+				"block larger than the frames per block of open()!");
+	block.interleave(m_playBuf);
+	play(m_playBuf, block.getNumFrames());
+}
+
 void CSimpleAudioOutStream::start(){
 	if(m_state==S_PLAYING)
 		return;
@@ -12,6 +12,7 @@
 #include <PortAudio.h>
 #include <SKSLib.h>
 #include <stdint.h>
+#include "CAudioBlock.h"
 
 /**
  * \brief handles playback of audio data in buffer on the default audio output
@@ -33,6 +34,8 @@ private:
 	 PaStream* m_stream;
 	 PaError err;
 	 STATES m_state;
+	 float* m_playBuf;		// interleaved buffer for planar blocks (allocated by open())
+	 uint32_t m_playBufSize;
 public:
 	CSimpleAudioOutStream();
 	~CSimpleAudioOutStream();
@@ -43,6 +46,14 @@ public:
 	void stop();
 	void resume();
 	void play(float* sbuf,int framesPerBlock);
+	/**
+	 * \brief plays the valid frames of a planar block
+	 *
+	 * PortAudio takes interleaved frames, the block is interleaved into the
+	 * buffer allocated by open() (throws exception if the block has more
+	 * frames than the frames per block of open())
+	 */
+	void play(CAudioBlock& block);
 	void pause();
 
 
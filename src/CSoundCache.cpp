@@ -0,0 +1,225 @@
+/**
+ * \file CSoundCache.cpp
+ * \brief implementation CSoundCache
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <iostream>
+#include <SKSLib.h>
+#include "CMappedFile.h"
+#include "CFileSound.h"
+#include "CSoundCache.h"
+
+CSoundCache::CSoundCache(size_t budget) {
+	m_pFirst = m_pLast = NULL;
+	m_numSounds = 0;
+	m_size = 0;
+	m_budget = budget;
+	m_hits = m_misses = 0;
+	pthread_mutex_init(&m_mutex, NULL);
+	cout << "CSoundCache@" << hex << this << dec << " created ("
+			<< m_budget / (1024 * 1024) << " MB)" << endl;
+}
+
+CSoundCache::~CSoundCache() {
+	clear();
+	pthread_mutex_destroy(&m_mutex);
+	cout << "CSoundCache@" << hex << this << dec << " destroyed" << endl;
+}
+
+CSoundCache* CSoundCache::getShared() {
+	static CSoundCache cache;
+	return &cache;
+}
+
+const CSoundCache::SOUND* CSoundCache::acquire(const string &path) {
+	int64_t mtime;
+	uint64_t fileSize;
+	if (!CMappedFile::getFileInfo(path, mtime, fileSize))
+		return NULL;
+
+	pthread_mutex_lock(&m_mutex);
+	SOUND *pSound = _find(path);
+	if (pSound && (pSound->mtime == mtime) && (pSound->fileSize == fileSize)) {
+		// most recently used
+		_unlink(pSound);
+		_pushFront(pSound);
+		pSound->refs.fetch_add(1, std::memory_order_relaxed);
+		m_hits++;
+		pthread_mutex_unlock(&m_mutex);
+		return pSound;
+	}
+	if (pSound) {
+		// the file has been changed
+		_unlink(pSound);
+		_unref(pSound);
+	}
+	m_misses++;
+	size_t budget = m_budget;
+	pthread_mutex_unlock(&m_mutex);
+
+	// the other sounds stay available while the file is decoded
+	SOUND *pNew = _decode(path, mtime, fileSize, budget);
+	if (pNew == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&m_mutex);
+	pSound = _find(path);
+	if (pSound && (pSound->mtime == mtime) && (pSound->fileSize == fileSize)) {
+		// decoded by another thread in the meantime: its sound is shared
+		_unlink(pSound);
+		_pushFront(pSound);
+		pSound->refs.fetch_add(1, std::memory_order_relaxed);
+		pthread_mutex_unlock(&m_mutex);
+		_unref(pNew);
+		return pSound;
+	}
+	if (pSound) {
+		_unlink(pSound);
+		_unref(pSound);
+	}
+	pNew->refs.fetch_add(1, std::memory_order_relaxed);	// the cache's
+	_pushFront(pNew);
+	_evict();
+	pthread_mutex_unlock(&m_mutex);
+	return pNew;
+}
+
+void CSoundCache::release(const SOUND *pSound) {
+	if (pSound)
+		_unref(const_cast<SOUND*>(pSound));
+}
+
+void CSoundCache::setBudget(size_t budget) {
+	pthread_mutex_lock(&m_mutex);
+	m_budget = budget;
+	_evict();
+	pthread_mutex_unlock(&m_mutex);
+}
+
+size_t CSoundCache::getBudget() {
+	pthread_mutex_lock(&m_mutex);
+	size_t budget = m_budget;
+	pthread_mutex_unlock(&m_mutex);
+	return budget;
+}
+
+size_t CSoundCache::getSize() {
+	pthread_mutex_lock(&m_mutex);
+	size_t size = m_size;
+	pthread_mutex_unlock(&m_mutex);
+	return size;
+}
+
+int CSoundCache::getNumSounds() {
+	pthread_mutex_lock(&m_mutex);
+	int num = m_numSounds;
+	pthread_mutex_unlock(&m_mutex);
+	return num;
+}
+
+uint64_t CSoundCache::getHits() {
+	pthread_mutex_lock(&m_mutex);
+	uint64_t hits = m_hits;
+	pthread_mutex_unlock(&m_mutex);
+	return hits;
+}
+
+uint64_t CSoundCache::getMisses() {
+	pthread_mutex_lock(&m_mutex);
+	uint64_t misses = m_misses;
+	pthread_mutex_unlock(&m_mutex);
+	return misses;
+}
+
+void CSoundCache::clear() {
+	pthread_mutex_lock(&m_mutex);
+	while (m_pLast) {
+		SOUND *pSound = m_pLast;
+		_unlink(pSound);
+		_unref(pSound);
+	}
+	pthread_mutex_unlock(&m_mutex);
+}
+
+CSoundCache::SOUND* CSoundCache::_decode(const string &path, int64_t mtime,
+		uint64_t fileSize, size_t maxBytes) {
+	CFileSound file(path);
+	file.open();
+	if (file.getNumFrames() * file.getNumChannels() * sizeof(float)
+			> maxBytes) {
+		file.close();
+		return NULL;
+	}
+	SOUND *pSound = new SOUND;
+	pSound->path = path;
+	pSound->mtime = mtime;
+	pSound->fileSize = fileSize;
+	pSound->numFrames = file.getNumFrames();
+	pSound->sampleRate = file.getSampleRate();
+	pSound->channels = file.getNumChannels();
+	pSound->format = file.getFormat();
+	pSound->bytes = pSound->numFrames * pSound->channels * sizeof(float);
+	pSound->samples = new float[pSound->numFrames * pSound->channels + 1];
+	pSound->refs.store(1, std::memory_order_relaxed);
+	pSound->pPrev = pSound->pNext = NULL;
+	try {
+		// compressed formats may deliver less frames than announced
+		pSound->numFrames = file.read(pSound->samples, pSound->numFrames);
+	} catch (...) {
+		delete[] pSound->samples;
+		delete pSound;
+		throw;
+	}
+	file.close();
+	return pSound;
+}
+
+CSoundCache::SOUND* CSoundCache::_find(const string &path) {
+	for (SOUND *pSound = m_pFirst; pSound; pSound = pSound->pNext)
+		if (pSound->path == path)
+			return pSound;
+	return NULL;
+}
+
+void CSoundCache::_pushFront(SOUND *pSound) {
+	pSound->pPrev = NULL;
+	pSound->pNext = m_pFirst;
+	if (m_pFirst)
+		m_pFirst->pPrev = pSound;
+	else
+		m_pLast = pSound;
+	m_pFirst = pSound;
+	m_numSounds++;
+	m_size += pSound->bytes;
+}
+
+void CSoundCache::_unlink(SOUND *pSound) {
+	if (pSound->pPrev)
+		pSound->pPrev->pNext = pSound->pNext;
+	else
+		m_pFirst = pSound->pNext;
+	if (pSound->pNext)
+		pSound->pNext->pPrev = pSound->pPrev;
+	else
+		m_pLast = pSound->pPrev;
+	pSound->pPrev = pSound->pNext = NULL;
+	m_numSounds--;
+	m_size -= pSound->bytes;
+}
+
+void CSoundCache::_evict() {
+	while (m_pLast && (m_size > m_budget)) {
+		SOUND *pSound = m_pLast;
+		_unlink(pSound);
+		_unref(pSound);
+	}
+}
+
+void CSoundCache::_unref(SOUND *pSound) {
+	if (pSound->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		delete[] pSound->samples;
+		delete pSound;
+	}
+}
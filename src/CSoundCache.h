@@ -0,0 +1,173 @@
+/**
+ * \file CSoundCache.h
+ * \brief interface CSoundCache
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CSOUNDCACHE_H_
+#define CSOUNDCACHE_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <string>
+using namespace std;
+
+/**
+ * \brief process wide cache of completely decoded sound files
+ *
+ * acquire() delivers the interleaved float samples of a sound file, a file
+ * is decoded by the first call only (CFileSound without cache). The entries
+ * are identified by path, size and modification time, a changed file is
+ * decoded again.
+ *
+ * The decoded sounds are shared by reference counting: the cache holds a
+ * reference while the sound is listed, every acquire() one more until
+ * release(). The memory of the listed sounds is limited by a budget, the
+ * least recently used sounds are dropped first. A dropped sound that is
+ * still in use stays valid until its last release(). Sounds larger than
+ * the budget are not cached.
+ *
+ * All methods are thread safe, decoding is done outside the lock.
+ */
+class CSoundCache {
+public:
+	/**
+	 * \brief default memory budget in bytes (about 12 minutes of 48 kHz
+	 * stereo)
+	 */
+	static const size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+	/**
+	 * \brief decoded sound file (read only for the users)
+	 */
+	struct SOUND {
+		string path;
+		int64_t mtime;			///< modification time of the file
+		uint64_t fileSize;		///< size of the file in bytes
+		float *samples;			///< interleaved samples
+		uint64_t numFrames;
+		uint32_t sampleRate;
+		uint16_t channels;
+		uint32_t format;		///< libsndfile format of the file
+		size_t bytes;			///< memory of the samples
+		/**
+		 * \brief references of the cache (while listed) and the users
+		 */
+		std::atomic<int> refs;
+		/**
+		 * \brief neighbours in the list of the cache (front: most recently
+		 * used)
+		 */
+		SOUND *pPrev, *pNext;
+	};
+
+private:
+	/**
+	 * \brief list of the cached sounds, most recently used first
+	 */
+	SOUND *m_pFirst, *m_pLast;
+	int m_numSounds;
+	/**
+	 * \brief memory of the listed sounds in bytes
+	 */
+	size_t m_size;
+	size_t m_budget;
+	uint64_t m_hits, m_misses;
+	/**
+	 * \brief protects the list, the sizes and the counters
+	 */
+	pthread_mutex_t m_mutex;
+
+public:
+	/**
+	 * \brief Constructor (empty cache)
+	 * \param budget memory budget in bytes
+	 */
+	CSoundCache(size_t budget = DEFAULT_BUDGET);
+	/**
+	 * \brief Destructor, drops all sounds (sounds in use stay valid until
+	 * they are released)
+	 */
+	~CSoundCache();
+	CSoundCache(const CSoundCache&) = delete;
+	CSoundCache& operator=(const CSoundCache&) = delete;
+
+	/**
+	 * \brief gets the decoded samples of a sound file
+	 *
+	 * throws exception if the file can't be read (see CFileSound)
+	 *
+	 * \param path path of the sound file
+	 * \return sound (valid until release()) or NULL if there is no such file
+	 * or the sound exceeds the budget (to be read from the file)
+	 */
+	const SOUND* acquire(const string &path);
+	/**
+	 * \brief releases a sound got by acquire()
+	 */
+	void release(const SOUND *pSound);
+	/**
+	 * \brief sets the memory budget, least recently used sounds are dropped
+	 * until the cached sounds fit
+	 * \param budget budget in bytes
+	 */
+	void setBudget(size_t budget);
+	size_t getBudget();
+	/**
+	 * \brief gets the memory of the cached sounds
+	 * \return bytes
+	 */
+	size_t getSize();
+	/**
+	 * \brief gets the number of cached sounds
+	 */
+	int getNumSounds();
+	/**
+	 * \brief gets the number of acquire() calls served from memory / decoded
+	 */
+	uint64_t getHits();
+	uint64_t getMisses();
+	/**
+	 * \brief drops all sounds
+	 */
+	void clear();
+	/**
+	 * \brief gets the cache shared by all sound files (created by the first
+	 * call)
+	 * \return cache with the default budget
+	 */
+	static CSoundCache* getShared();
+
+private:
+	/**
+	 * \brief decodes a sound file
+	 * \param maxBytes the sound is not decoded if it needs more memory
+	 * \return new sound with one reference (the caller's) or NULL if the
+	 * sound is too large
+	 */
+	SOUND* _decode(const string &path, int64_t mtime, uint64_t fileSize,
+			size_t maxBytes);
+	/**
+	 * \brief finds a sound by path (mutex locked)
+	 */
+	SOUND* _find(const string &path);
+	/**
+	 * \brief list operations (mutex locked)
+	 */
+	void _pushFront(SOUND *pSound);
+	void _unlink(SOUND *pSound);
+	/**
+	 * \brief drops least recently used sounds until the budget is kept
+	 * (mutex locked)
+	 */
+	void _evict();
+	/**
+	 * \brief drops one reference, deletes the sound with the last one
+	 */
+	static void _unref(SOUND *pSound);
+};
+
+#endif /* CSOUNDCACHE_H_ */
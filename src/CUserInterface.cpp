@@ -86,6 +86,10 @@ bool CUserInterface::keyPressed(bool bBlock) {
 		return m_playerCVDev->keyPressed();
 }
 
+string CUserInterface::getKeyText() {
+	return m_playerCVDev->getKeyText();
+}
+
 int CUserInterface::getUserInputInt(const string prompt) {
 	// display the input request (if any)
 	if (!prompt.empty())
@@ -139,6 +143,10 @@ void CUserInterface::visualizeAmplitude(float *databuf, int bufsize) {
 	m_ampMeter.write(databuf, bufsize);
 }
 
+void CUserInterface::visualizeAmplitude(CAudioBlock &block) {
+	m_ampMeter.write(block);
+}
+
 void CUserInterface::switchOffAmplitudeMeter() {
 	m_ampMeter.write(0.);
 }
@@ -152,6 +152,14 @@ public:
 	 */
 	bool keyPressed(bool bBlock = false);
 
+	/**
+	 * Queries the text entered with the last key press (e.g. a command typed
+	 * before ENTER), empty for IoWarrior buttons.
+	 *
+	 * \return text
+	 */
+	string getKeyText();
+
 	/**
 	 * Visualizes the amplitude of a data buffer on the LED line.
 	 *
@@ -160,6 +168,13 @@ public:
 	 */
 	void visualizeAmplitude(float *databuf, int bufsize);
 
+	/**
+	 * Visualizes the amplitude of a planar block on the LED line.
+	 *
+	 * \param block [in]: block of samples (all channels)
+	 */
+	void visualizeAmplitude(CAudioBlock &block);
+
 	/**
 	 * Switches the LEDs off.
 	 */
@@ -0,0 +1,179 @@
+/**
+ * \file CWorkerPool.cpp
+ * \brief implementation CWorkerPool
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#include <errno.h>
+#include <thread>
+#include <SKSLib.h>
+#include "CDenormalGuard.h"
+#include "CWorkerPool.h"
+
+CWorkerPool::CWorkerPool(int numWorkers) {
+	if (numWorkers < 0)
+		numWorkers = (int) std::thread::hardware_concurrency() - 1;
+	if (numWorkers < 0)
+		numWorkers = 0;
+	if (numWorkers > MAX_WORKERS)
+		numWorkers = MAX_WORKERS;
+	m_pBatch.store(NULL);
+	m_active.store(0);
+	m_stop.store(false);
+	m_running.store(false);
+
+	for (m_numWorkers = 0; m_numWorkers < numWorkers; m_numWorkers++) {
+		WORKER &worker = m_workers[m_numWorkers];
+		worker.pPool = this;
+		worker.id = m_numWorkers;
+		sem_init(&worker.wake, 0, 0);
+		if (pthread_create(&m_threads[m_numWorkers], NULL, _workerThread,
+				&worker) != 0) {
+			sem_destroy(&worker.wake);
+			_stopWorkers(m_numWorkers);
+			throw CException(this, typeid(this).name(), __FUNCTION__, -1,
+					"Could not start worker thread!");
+		}
+	}
+	cout << "CWorkerPool@" << hex << this << dec << " created ("
+			<< m_numWorkers << " workers)" << endl;
+}
+
+CWorkerPool::~CWorkerPool() {
+	_stopWorkers(m_numWorkers);
+	cout << "CWorkerPool@" << hex << this << dec << " destroyed" << endl;
+}
+
+CWorkerPool* CWorkerPool::getShared() {
+	static CWorkerPool pool;
+	return &pool;
+}
+
+void CWorkerPool::_stopWorkers(int numWorkers) {
+	m_stop.store(true);
+	for (int i = 0; i < numWorkers; i++)
+		sem_post(&m_workers[i].wake);
+	for (int i = 0; i < numWorkers; i++) {
+		pthread_join(m_threads[i], NULL);
+		sem_destroy(&m_workers[i].wake);
+	}
+}
+
+void CWorkerPool::_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+int CWorkerPool::getNumWorkers() {
+	return m_numWorkers;
+}
+
+bool CWorkerPool::_take(QUEUE &queue, bool front, int &task) {
+	uint64_t range = queue.range.load(std::memory_order_relaxed);
+	while (true) {
+		uint32_t first = (uint32_t) range, end = (uint32_t) (range >> 32);
+		if (first >= end)
+			return false;
+		uint64_t taken =
+				front ? (range + 1) : (range - ((uint64_t) 1 << 32));
+		if (queue.range.compare_exchange_weak(range, taken,
+				std::memory_order_acq_rel, std::memory_order_relaxed)) {
+			task = front ? first : end - 1;
+			return true;
+		}
+	}
+}
+
+void CWorkerPool::_execute(BATCH *pBatch, int numQueues, int own) {
+	int task;
+	while (_take(pBatch->queues[own], true, task)) {
+		pBatch->func(pBatch->pArg, task);
+		pBatch->pending.fetch_sub(1, std::memory_order_release);
+	}
+	// own queue empty: steal from the others until all queues are empty
+	bool found = true;
+	while (found) {
+		found = false;
+		for (int i = 1; i < numQueues; i++) {
+			int victim = (own + i) % numQueues;
+			if (_take(pBatch->queues[victim], false, task)) {
+				pBatch->func(pBatch->pArg, task);
+				pBatch->pending.fetch_sub(1, std::memory_order_release);
+				found = true;
+			}
+		}
+	}
+}
+
+void CWorkerPool::run(int numTasks, TASK func, void *pArg) {
+	if (numTasks <= 0)
+		return;
+	// no workers or another batch running: execute the tasks right here
+	if ((m_numWorkers == 0)
+			|| m_running.exchange(true, std::memory_order_acquire)) {
+		for (int t = 0; t < numTasks; t++)
+			func(pArg, t);
+		return;
+	}
+
+	// contiguous ranges of tasks, queue 0 belongs to the calling thread
+	BATCH batch;
+	int numQueues = m_numWorkers + 1;
+	batch.func = func;
+	batch.pArg = pArg;
+	batch.fpMode = CDenormalGuard::getMode();
+	batch.pending.store(numTasks, std::memory_order_relaxed);
+	for (int q = 0; q < numQueues; q++) {
+		uint64_t first = (uint64_t) numTasks * q / numQueues;
+		uint64_t end = (uint64_t) numTasks * (q + 1) / numQueues;
+		batch.queues[q].range.store(first | (end << 32),
+				std::memory_order_relaxed);
+	}
+
+	m_pBatch.store(&batch, std::memory_order_seq_cst);
+	for (int i = 0; i < m_numWorkers; i++)
+		sem_post(&m_workers[i].wake);
+
+	// the remaining tasks are short (cost heuristic of the callers): spin
+	// instead of a system call
+	_execute(&batch, numQueues, 0);
+	while (batch.pending.load(std::memory_order_acquire) > 0)
+		_relax();
+
+	// no worker may join the batch any more, wait for those still inside
+	// (a worker registers in m_active before it reads m_pBatch)
+	m_pBatch.store(NULL, std::memory_order_seq_cst);
+	while (m_active.load(std::memory_order_seq_cst) > 0)
+		_relax();
+	m_running.store(false, std::memory_order_release);
+}
+
+void* CWorkerPool::_workerThread(void *pArg) {
+	WORKER *pWorker = (WORKER*) pArg;
+	pWorker->pPool->_work(pWorker->id);
+	return NULL;
+}
+
+void CWorkerPool::_work(int id) {
+	sem_t *pWake = &m_workers[id].wake;
+	while (true) {
+		while ((sem_wait(pWake) != 0) && (errno == EINTR))
+			;
+		if (m_stop.load())
+			break;
+		// a late wake up may find the next batch or none (nothing to do)
+		m_active.fetch_add(1, std::memory_order_seq_cst);
+		BATCH *pBatch = m_pBatch.load(std::memory_order_seq_cst);
+		if (pBatch) {
+			uint32_t fpMode = CDenormalGuard::getMode();
+			CDenormalGuard::setMode(pBatch->fpMode);
+			_execute(pBatch, m_numWorkers + 1, id + 1);
+			CDenormalGuard::setMode(fpMode);
+		}
+		m_active.fetch_sub(1, std::memory_order_release);
+	}
+}
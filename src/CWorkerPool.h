@@ -0,0 +1,166 @@
+/**
+ * \file CWorkerPool.h
+ * \brief interface CWorkerPool
+ *
+ * \date 17.10.2026
+ * \author Akhil Sai Nallapati
+ */
+#ifndef CWORKERPOOL_H_
+#define CWORKERPOOL_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/**
+ * \brief pool of worker threads executing batches of independent tasks
+ *
+ * run() distributes the tasks of a batch over one queue per thread (the
+ * calling thread takes part). A thread takes the tasks of its own queue from
+ * the front; when its queue is empty, it steals tasks from the back of the
+ * other queues. Each queue is a range of task indices packed into one atomic
+ * word, owner and thieves take tasks by compare and swap.
+ *
+ * The tasks run with the floating point mode (CDenormalGuard) of the thread
+ * calling run(). The worker threads sleep on a semaphore of their own while
+ * there is no batch. Only one batch is executed at a time, a concurrent call
+ * of run() executes its tasks on the calling thread.
+ *
+ * run() may be called by the audio callback: it takes no lock, allocates
+ * nothing and prints nothing. The batch is published by an atomic pointer,
+ * the workers are woken by sem_post() (an atomic increment, a futex wake
+ * only for a sleeping worker). The pool has to be created by the control
+ * thread (getShared() before the playback starts).
+ */
+class CWorkerPool {
+public:
+	/**
+	 * \brief task function
+	 * \param pArg argument passed to run()
+	 * \param task index of the task (0 ... numTasks-1)
+	 */
+	typedef void (*TASK)(void *pArg, int task);
+	/**
+	 * \brief maximum number of worker threads
+	 */
+	static const int MAX_WORKERS = 15;
+
+private:
+	/**
+	 * \brief task queue: first (low 32 bits) and end (high 32 bits) of a range
+	 * of task indices, one cache line per queue
+	 */
+	struct alignas(64) QUEUE {
+		std::atomic<uint64_t> range;
+	};
+	/**
+	 * \brief batch of tasks, lives on the stack of run()
+	 */
+	struct BATCH {
+		TASK func;
+		void *pArg;
+		/**
+		 * \brief floating point mode of the calling thread (flush-to-zero),
+		 * taken over by the workers for the batch
+		 */
+		uint32_t fpMode;
+		QUEUE queues[MAX_WORKERS + 1];
+		/**
+		 * \brief number of tasks not yet finished
+		 */
+		std::atomic<int> pending;
+	};
+
+	/**
+	 * \brief arguments of a worker thread
+	 */
+	struct WORKER {
+		CWorkerPool *pPool;
+		int id;
+		/**
+		 * \brief posted by run() for each batch
+		 */
+		sem_t wake;
+	};
+
+	int m_numWorkers;
+	pthread_t m_threads[MAX_WORKERS];
+	WORKER m_workers[MAX_WORKERS];
+	/**
+	 * \brief current batch or NULL
+	 */
+	std::atomic<BATCH*> m_pBatch;
+	/**
+	 * \brief number of worker threads that may be working on m_pBatch
+	 */
+	std::atomic<int> m_active;
+	std::atomic<bool> m_stop;
+	/**
+	 * \brief a batch is executed (only one batch at a time)
+	 */
+	std::atomic<bool> m_running;
+
+public:
+	/**
+	 * \brief Constructor, starts the worker threads
+	 *
+	 * throws exception if a thread can not be started
+	 *
+	 * \param numWorkers number of worker threads (without the calling thread,
+	 * limited to MAX_WORKERS), -1: number of cores - 1
+	 */
+	CWorkerPool(int numWorkers = -1);
+	/**
+	 * \brief Destructor, stops the worker threads
+	 */
+	~CWorkerPool();
+	/**
+	 * \brief executes a batch of tasks and waits until all tasks are finished
+	 * \param numTasks number of tasks
+	 * \param func task function
+	 * \param pArg argument of the task function
+	 */
+	void run(int numTasks, TASK func, void *pArg);
+	/**
+	 * \brief gets the number of worker threads
+	 * \return number of threads without the calling thread
+	 */
+	int getNumWorkers();
+	/**
+	 * \brief gets the pool shared by all filters (created by the first call,
+	 * which has to be made by the control thread, see above)
+	 * \return pool with one thread per core
+	 */
+	static CWorkerPool* getShared();
+
+private:
+	/**
+	 * \brief executes tasks of the own queue, then steals from the other queues
+	 */
+	static void _execute(BATCH *pBatch, int numQueues, int own);
+	/**
+	 * \brief takes a task from the front (owner) or the back (thief) of a queue
+	 * \return false if the queue is empty
+	 */
+	static bool _take(QUEUE &queue, bool front, int &task);
+	/**
+	 * \brief processing loop of a worker thread
+	 */
+	void _work(int id);
+	/**
+	 * \brief stops and joins the first numWorkers threads, releases the
+	 * semaphores
+	 */
+	void _stopWorkers(int numWorkers);
+	/**
+	 * \brief busy waiting hint for the CPU (no system call)
+	 */
+	static void _relax();
+	/**
+	 * \brief thread function
+	 */
+	static void* _workerThread(void *pArg);
+};
+
+#endif /* CWORKERPOOL_H_ */
@@ -9,6 +9,34 @@
 #include "CAudioPlayerController.h"
 #include "CFileFilter.h"
 #include "CFilter.h"
+#include "CFilterSOS.h"
+#include "CFilterFFT.h"
+#include "CFilterSparse.h"
+#include "CFilterDelay.h"
+#include "CFilterSlot.h"
+#include "CFilterChain.h"
+#include "CFilterPipeline.h"
+#include "CWorkerPool.h"
+#include "CFilterFixed.h"
+#include "CFilterPrecise.h"
+#include "CDenormalGuard.h"
+#include "CFilterAnalyzer.h"
+#include "CFilterLibrary.h"
+#include "CFilterDerivation.h"
+#include "CFileSoundPrefetcher.h"
+#include "CFileSoundMapped.h"
+#include "CPcmConvert.h"
+#include "CSoundCache.h"
+#include "CPolynomial.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+#include <unistd.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 /**
  * horizontal divider for test list output
@@ -23,6 +51,31 @@ string hDivider(80, '-');
 // laboratory tasks
 void Test_Lab01_SoundFilterPlayTest(string &soundfile, string &sndfile_w,
 		string &fltfile);
+// optimization tests
+void Test_FilterKernels(string &fltfile);
+void Test_FilterBenchmark(string &fltfile);
+void Test_FilterFFT(string &soundfile, string &fltfile);
+void Test_FilterSparse(string &soundfile, string &fltfile);
+void Test_FilterDelay(string &soundfile);
+void Test_FilterDelayModulation();
+void Test_FilterSlot();
+void Test_FilterChain(string &soundfile, string &fltfile);
+void Test_FilterPipeline(string &soundfile, string &fltfile);
+void Test_FilterChannelParallel(string &fltfile);
+void Test_AudioBlock(string &soundfile, string &fltfile);
+void Test_FilterFixed(string &fltfile);
+void Test_FilterPrecision(string &fltfile);
+void Test_FilterDenormals(string &fltfile);
+void Test_FilterAnalyzer(string &fltfile, string &fltfileLong);
+void Test_FilterCache(string &fltfile);
+void Test_FilterParser(string &fltfile);
+void Test_FilterLibrary(string &fltpath, string &fltfile);
+void Test_FilterDerivation(string &fltfile, string &fltfileSparse);
+void Test_SoundPrefetch(string &soundfile);
+void Test_SoundMapped(string &soundfile);
+void Test_PcmConvert(string &soundfile);
+void Test_SeekRandomAccess(string &soundfile);
+void Test_SoundCache(string &soundfile);
 
 int main(void) {
 	setvbuf(stdout, NULL, _IONBF, 0);
@@ -39,6 +92,39 @@ int main(void) {
 	try {
 	Test_Lab01_SoundFilterPlayTest(sndf, sndfw, fltf);
 
+	/*
+	 * comment in to check the vectorized filter kernels against the scalar reference
+	 */
+//	Test_FilterKernels(fltf);
+//	Test_FilterBenchmark(fltf);
+//	string sndfir = ".\\files\\sounds\\funnysong.wav";
+//	string fltfir = ".\\files\\filters\\basic_delay_feedback_16000_Order8001.txt";
+//	Test_FilterFFT(sndfir, fltfir);
+//	Test_FilterSparse(sndfir, fltfir);
+//	Test_FilterDelay(sndfir);
+//	Test_FilterDelayModulation();
+//	Test_FilterSlot();
+//	Test_FilterChain(sndf, fltf);
+//	Test_FilterPipeline(sndf, fltf);
+//	Test_FilterChannelParallel(fltf);
+//	Test_AudioBlock(sndf, fltf);
+//	Test_FilterFixed(fltf);
+//	Test_FilterPrecision(fltf);
+//	Test_FilterDenormals(fltf);
+//	Test_FilterAnalyzer(fltf, fltfir);
+//	Test_FilterCache(fltfir);
+//	Test_FilterParser(fltfir);
+//	string fltpath = ".\\files\\filters\\";
+//	Test_FilterLibrary(fltpath, fltf);
+//	Test_FilterDerivation(fltf, fltfir);
+//	string fltyw = ".\\files\\filters\\yulewalk_treble_boost_Order6.txt";
+//	Test_FilterDerivation(fltyw, fltfir);
+//	Test_SoundPrefetch(sndf);
+//	Test_SoundMapped(sndf);
+//	Test_PcmConvert(sndf);
+//	Test_SeekRandomAccess(sndf);
+//	Test_SoundCache(sndf);
+
 	/*
 	 * todo: comment in for Lab Task 2
 	 */
@@ -65,6 +151,7 @@ void Test_Lab01_SoundFilterPlayTest(string &soundfile, string &sndfile_w,
 	sndF1.setFormat(sndF.getFormat());
 	sndF1.setNumChannels(sndF.getNumChannels());
 	sndF1.setSampleRate(sndF.getSampleRate());
+	sndF1.setDither(true);		// filtered output quantized to the PCM format
 	sndF1.open();
 
 	CFileFilter filterfile(fltfile);
@@ -89,6 +176,7 @@ void Test_Lab01_SoundFilterPlayTest(string &soundfile, string &sndfile_w,
          readSize=sndF.read(sbufBlock, framesPerBlock);
          filter.filter(sbufBlock, sbufFilt, framesPerBlock);
          m_stream.play(sbufFilt, framesPerBlock);
+         sndF1.write(sbufFilt, readSize);
 
     }
   while(readSize==framesPerBlock);
@@ -102,3 +190,2679 @@ void Test_Lab01_SoundFilterPlayTest(string &soundfile, string &sndfile_w,
 
 	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
 }
+
+/**
+ * \brief distance of two floats in units in the last place
+ */
+static uint32_t ulpDistance(float a, float b) {
+	int32_t ia, ib;
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+	// map the sign-magnitude representation to a monotonic integer scale
+	if (ia < 0)
+		ia = INT32_MIN - ia;
+	if (ib < 0)
+		ib = INT32_MIN - ib;
+	return (ia > ib) ? (uint32_t) ia - (uint32_t) ib : (uint32_t) ib - (uint32_t) ia;
+}
+
+void Test_FilterKernels(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 48000;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 40;
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+
+	// the channels are processed in the lanes of the registers: full and
+	// partial groups of channels
+	uint16_t channelCounts[] = { 1, 2, 3, 5, 8, 11 };
+	for (int n = 0; n < 6; n++) {
+		uint16_t channels = channelCounts[n];
+		cout << channels << " channels" << endl;
+
+		// white noise as test signal
+		int sigSize = framesPerBlock * channels * numBlocks;
+		float *x = new float[sigSize];
+		float *yRef = new float[sigSize];
+		float *y = new float[sigSize];
+		srand(1);
+		for (int i = 0; i < sigSize; i++)
+			x[i] = 2.f * rand() / RAND_MAX - 1.f;
+
+		CFilter refFilter(filterfile.getFilepath(), filterfile.getACoeffs(),
+				filterfile.getBCoeffs(), filterfile.getOrder(), channels);
+		refFilter.setKernel(CFilter::KERNEL_SCALAR);
+		for (int b = 0; b < numBlocks; b++)
+			refFilter.filter(x + b * framesPerBlock * channels,
+					yRef + b * framesPerBlock * channels, framesPerBlock);
+
+		CFilter::KERNEL kernels[] = { CFilter::KERNEL_SSE, CFilter::KERNEL_AVX,
+				CFilter::KERNEL_NEON };
+		for (int i = 0; i < 3; i++) {
+			CFilter filter(filterfile.getFilepath(), filterfile.getACoeffs(),
+					filterfile.getBCoeffs(), filterfile.getOrder(), channels);
+			if (!filter.setKernel(kernels[i])) {
+				cout << CFilter::getKernelName(kernels[i]) << ": not supported"
+						<< endl;
+				continue;
+			}
+			for (int b = 0; b < numBlocks; b++)
+				filter.filter(x + b * framesPerBlock * channels,
+						y + b * framesPerBlock * channels, framesPerBlock);
+
+			uint32_t maxUlp = 0;
+			for (int k = 0; k < sigSize; k++) {
+				uint32_t d = ulpDistance(y[k], yRef[k]);
+				if (d > maxUlp)
+					maxUlp = d;
+			}
+			cout << CFilter::getKernelName(kernels[i]) << ": max. deviation "
+					<< maxUlp << " ulp -> "
+					<< ((maxUlp <= 1) ? "passed" : "FAILED") << endl;
+		}
+
+		delete[] x;
+		delete[] yRef;
+		delete[] y;
+	}
+	filterfile.close();
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief measures the processing time of a filter
+ *
+ * \param flt filter to be measured
+ * \param x input signal (numBlocks blocks)
+ * \param y output signal (numBlocks blocks)
+ * \param framesPerBlock frames per block
+ * \param numBlocks number of blocks
+ * \param channels number of channels
+ * \return processing time in ns per sample
+ */
+static double benchmarkFilter(CFilterBase &flt, float *x, float *y,
+		int framesPerBlock, int numBlocks, int channels) {
+	flt.reset();
+	auto start = chrono::steady_clock::now();
+	for (int b = 0; b < numBlocks; b++)
+		flt.filter(x + b * framesPerBlock * channels,
+				y + b * framesPerBlock * channels, framesPerBlock);
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(stop - start).count()
+			/ ((double) framesPerBlock * numBlocks * channels);
+}
+
+void Test_FilterBenchmark(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 48000;
+	uint16_t channels = 2;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 80;
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	uint16_t order = filterfile.getOrder();
+	float *ca = filterfile.getACoeffs();
+	float *cb = filterfile.getBCoeffs();
+
+	int sigSize = framesPerBlock * channels * numBlocks;
+	float *x = new float[sigSize];
+	float *y = new float[sigSize];
+	srand(1);
+	for (int i = 0; i < sigSize; i++)
+		x[i] = 2.f * rand() / RAND_MAX - 1.f;
+
+	// reference: direct form II transposed in double precision
+	double *yRef = new double[sigSize];
+	double *z = new double[channels * (order + 1)]();
+	for (int k = 0; k < sigSize; k += channels)
+		for (int c = 0; c < channels; c++) {
+			double *zc = z + c * (order + 1);
+			yRef[k + c] = (double) cb[0] / ca[0] * x[k + c] + zc[0];
+			for (int n = 1; n <= order; n++)
+				zc[n - 1] = ((double) cb[n] * x[k + c]
+						- (double) ca[n] * yRef[k + c]) / ca[0] + zc[n];
+		}
+
+	cout << fltfile << ", fs=" << fs << "Hz, order=" << order << ", "
+			<< channels << " channels" << endl;
+
+	CFilter directForm(filterfile.getFilepath(), ca, cb, order, channels);
+	CFilter::KERNEL bestKernel = directForm.getKernel();
+	CFilter::KERNEL kernels[] = { CFilter::KERNEL_SCALAR, bestKernel };
+	for (int i = 0; i < 2; i++) {
+		directForm.setKernel(kernels[i]);
+		double ns = benchmarkFilter(directForm, x, y, framesPerBlock,
+				numBlocks, channels);
+		double err = 0.;
+		for (int k = 0; k < sigSize; k++)
+			err = fmax(err, fabs(y[k] - yRef[k]));
+		cout << "CFilter (" << CFilter::getKernelName(kernels[i]) << "): "
+				<< ns << " ns/sample, max. error " << err << endl;
+	}
+
+	try {
+		CFilterSOS sos(filterfile.getFilepath(), ca, cb, order, channels);
+		double ns = benchmarkFilter(sos, x, y, framesPerBlock, numBlocks,
+				channels);
+		double err = 0.;
+		for (int k = 0; k < sigSize; k++)
+			err = fmax(err, fabs(y[k] - yRef[k]));
+		cout << "CFilterSOS (" << sos.getNumSections() << " sections): " << ns
+				<< " ns/sample, max. error " << err << endl;
+	} catch (CException &e) {
+		cout << e << endl;
+	}
+	filterfile.close();
+
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+	delete[] z;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterFFT(string &soundfile, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	if (filterfile.read(sndF.getSampleRate()) == 0) {
+		cout << "no filter for " << sndF.getSampleRate() << "Hz" << endl;
+		filterfile.close();
+		delete[] x;
+		return;
+	}
+	uint16_t order = filterfile.getOrder();
+
+	// only the numerator is used: FIR filter with the impulse response b
+	float *ca = new float[order + 1];
+	float *cb = filterfile.getBCoeffs();
+	ca[0] = 1.;
+	for (int i = 1; i <= order; i++)
+		ca[i] = 0.;
+
+	// the direct form needs blocks of at least order frames
+	int framesPerBlock = sndF.getSampleRate() / 8;
+	if (framesPerBlock < order)
+		framesPerBlock = order;
+	int numBlocks = numFrames / framesPerBlock;
+	float *yRef = new float[numFrames * channels];
+	float *y = new float[numFrames * channels];
+
+	CFilter direct(fltfile, ca, cb, order, channels);
+	CFilterFFT fast(fltfile, cb, order, channels);
+	double nsDirect = benchmarkFilter(direct, x, yRef, framesPerBlock,
+			numBlocks, channels);
+	double nsFast = benchmarkFilter(fast, x, y, framesPerBlock, numBlocks,
+			channels);
+
+	double err = 0., peak = 0.;
+	for (int k = 0; k < numBlocks * framesPerBlock * channels; k++) {
+		err = fmax(err, fabs(y[k] - yRef[k]));
+		peak = fmax(peak, fabs(yRef[k]));
+	}
+	cout << soundfile << " filtered by FIR part of " << fltfile << endl;
+	cout << "order " << order << ", first partition size "
+			<< fast.getPartitionSize() << endl;
+	cout << "CFilter: " << nsDirect << " ns/sample" << endl;
+	cout << "CFilterFFT: " << nsFast << " ns/sample" << endl;
+	cout << "max. deviation " << err << " (peak " << peak << ") -> "
+			<< ((err <= 1e-5 * fmax(peak, 1.)) ? "passed" : "FAILED") << endl;
+
+	filterfile.close();
+	delete[] ca;
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterSparse(string &soundfile, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	if ((filterfile.read(sndF.getSampleRate()) == 0)
+			|| !filterfile.isSparse()) {
+		cout << "no sparse filter for " << sndF.getSampleRate() << "Hz"
+				<< endl;
+		filterfile.close();
+		delete[] x;
+		return;
+	}
+	uint16_t order = filterfile.getOrder();
+
+	// the direct form needs blocks of at least order frames
+	int framesPerBlock = sndF.getSampleRate() / 8;
+	if (framesPerBlock < order)
+		framesPerBlock = order;
+	int numBlocks = numFrames / framesPerBlock;
+	float *yRef = new float[numFrames * channels];
+	float *y = new float[numFrames * channels];
+
+	CFilter direct(fltfile, filterfile.getACoeffs(), filterfile.getBCoeffs(),
+			order, channels);
+	CFilterSparse sparse(fltfile, filterfile.getATapIndices(),
+			filterfile.getATapValues(), filterfile.getNumATaps(),
+			filterfile.getBTapIndices(), filterfile.getBTapValues(),
+			filterfile.getNumBTaps(), order, channels);
+	double nsDirect = benchmarkFilter(direct, x, yRef, framesPerBlock,
+			numBlocks, channels);
+	double nsSparse = benchmarkFilter(sparse, x, y, framesPerBlock, numBlocks,
+			channels);
+
+	double err = 0., peak = 0.;
+	for (int k = 0; k < numBlocks * framesPerBlock * channels; k++) {
+		err = fmax(err, fabs(y[k] - yRef[k]));
+		peak = fmax(peak, fabs(yRef[k]));
+	}
+	cout << soundfile << " filtered by " << fltfile << endl;
+	cout << "order " << order << ", " << sparse.getNumTaps() << " taps" << endl;
+	cout << "CFilter: " << nsDirect << " ns/sample" << endl;
+	cout << "CFilterSparse: " << nsSparse << " ns/sample" << endl;
+	cout << "max. deviation " << err << " (peak " << peak << ") -> "
+			<< ((err <= 1e-5 * fmax(peak, 1.)) ? "passed" : "FAILED") << endl;
+
+	filterfile.close();
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterDelay(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	float gFF = 0.5, gFB = 0.75;
+	CFilterDelay delay(gFF, gFB, 500, fs, channels);
+
+	// reference: H(z) = (1 + (gFF-gFB)*z^-D) / (1 - gFB*z^-D) as sparse filter
+	uint32_t D = (uint32_t) delay.getDelayFrames();
+	uint32_t idx[] = { 0, D };
+	float aVal[] = { 1., -gFB };
+	float bVal[] = { 1., gFF - gFB };
+	CFilterSparse sparse("", idx, aVal, 2, idx, bVal, 2, D, channels);
+
+	float *yRef = new float[numFrames * channels];
+	float *y = new float[numFrames * channels];
+
+	// odd block sizes to hit every wrap position of the circular buffer
+	int framesPerBlock = 997;
+	int numBlocks = numFrames / framesPerBlock;
+	double nsSparse = benchmarkFilter(sparse, x, yRef, framesPerBlock,
+			numBlocks, channels);
+	double nsDelay = benchmarkFilter(delay, x, y, framesPerBlock, numBlocks,
+			channels);
+
+	double err = 0., peak = 0.;
+	for (int k = 0; k < numBlocks * framesPerBlock * channels; k++) {
+		err = fmax(err, fabs(y[k] - yRef[k]));
+		peak = fmax(peak, fabs(yRef[k]));
+	}
+	cout << soundfile << " delay " << delay.getDelay() << "ms (" << D
+			<< " frames)" << endl;
+	cout << "CFilterSparse: " << nsSparse << " ns/sample" << endl;
+	cout << "CFilterDelay: " << nsDelay << " ns/sample" << endl;
+	cout << "max. deviation " << err << " (peak " << peak << ") -> "
+			<< ((err <= 1e-5 * fmax(peak, 1.)) ? "passed" : "FAILED") << endl;
+
+	// frame by frame vs. block mode with the block size of play()
+	// the cost must not depend on the delay, 2ms is shorter than the block
+	framesPerBlock = fs / 8;
+	numBlocks = numFrames / framesPerBlock;
+	uint16_t delays_ms[] = { 2, 50, 500, 5000, 65535 };
+	for (int i = 0; i < 5; i++) {
+		CFilterDelay d(gFF, gFB, delays_ms[i], fs, channels);
+		d.setInterpolation(CFilterDelay::INTERP_NONE);
+		d.setBlockMode(false);
+		double nsFrames = benchmarkFilter(d, x, yRef, framesPerBlock,
+				numBlocks, channels);
+		d.setBlockMode(true);
+		double nsBlock = benchmarkFilter(d, x, y, framesPerBlock, numBlocks,
+				channels);
+		err = 0.;
+		for (int k = 0; k < numBlocks * framesPerBlock * channels; k++)
+			err = fmax(err, fabs(y[k] - yRef[k]));
+		cout << "delay " << delays_ms[i] << "ms: frames " << 1000. / nsFrames
+				<< " MS/s, block " << 1000. / nsBlock << " MS/s, deviation "
+				<< err << " -> "
+				<< ((err <= 1e-5 * fmax(peak, 1.)) ? "passed" : "FAILED")
+				<< endl;
+	}
+
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterDelayModulation() {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 16000;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 16;
+	int numFrames = framesPerBlock * numBlocks;
+	double w0 = 2. * M_PI * 200. / fs;
+	float *x = new float[numFrames];
+	float *y = new float[numFrames];
+	for (int k = 0; k < numFrames; k++)
+		x[k] = sin(w0 * k);
+
+	// fractional delay: y - x = sin(w0*(k-D)) for gFF = 1, gFB = 0
+	CFilterDelay::INTERP interp[] = { CFilterDelay::INTERP_LINEAR,
+			CFilterDelay::INTERP_ALLPASS, CFilterDelay::INTERP_LAGRANGE };
+	string interpName[] = { "linear", "allpass", "Lagrange" };
+	double limit[] = { 1e-3, 1e-3, 1e-4 };
+	for (int i = 0; i < 3; i++) {
+		CFilterDelay d(1., 0., 1.37, fs, 1);
+		d.setInterpolation(interp[i]);
+		float D = d.getDelayFrames();
+		for (int b = 0; b < numBlocks; b++)
+			d.filter(x + b * framesPerBlock, y + b * framesPerBlock,
+					framesPerBlock);
+		double err = 0.;
+		for (int k = framesPerBlock; k < numFrames; k++)
+			err = fmax(err, fabs(y[k] - x[k] - sin(w0 * (k - D))));
+		cout << interpName[i] << " interpolation, delay " << D
+				<< " frames: max. error " << err << " -> "
+				<< ((err <= limit[i]) ? "passed" : "FAILED") << endl;
+	}
+
+	// glide 10ms -> 27ms in 100ms vs. immediate change after 4 blocks:
+	// the output must not contain steeper steps than before the change
+	double maxStep[3] = { 0., 0., 0. };
+	float glide_ms[] = { 100., 0. };
+	for (int i = 0; i < 2; i++) {
+		CFilterDelay d(1., 0., 10., fs, 1, 50.);
+		for (int b = 0; b < numBlocks; b++) {
+			if (b == 4)
+				d.setParameters(27., 1., 0., glide_ms[i]);
+			d.filter(x + b * framesPerBlock, y + b * framesPerBlock,
+					framesPerBlock);
+		}
+		maxStep[i + 1] = 0.;
+		for (int k = framesPerBlock; k < numFrames; k++) {
+			double step = fabs(y[k] - y[k - 1]);
+			if (k < 4 * framesPerBlock)
+				maxStep[0] = fmax(maxStep[0], step);
+			else
+				maxStep[i + 1] = fmax(maxStep[i + 1], step);
+		}
+	}
+	cout << "max. step before change " << maxStep[0] << ", glide "
+			<< maxStep[1] << ", immediate " << maxStep[2] << " -> "
+			<< ((maxStep[1] <= 1.01 * maxStep[0]) ? "passed" : "FAILED")
+			<< endl;
+
+	// the cost of a modulated delay must not depend on the delay
+	float delays_ms[] = { 5., 500., 1900. };
+	for (int i = 0; i < 3; i++) {
+		CFilterDelay d(0.7, 0.5, delays_ms[i], fs, 1, 2000.);
+		double nsStatic = benchmarkFilter(d, x, y, framesPerBlock, numBlocks,
+				1);
+		d.setInterpolation(CFilterDelay::INTERP_LAGRANGE);
+		d.setModulation(3., 0.5);
+		double nsModulated = benchmarkFilter(d, x, y, framesPerBlock,
+				numBlocks, 1);
+		cout << "delay " << delays_ms[i] << "ms: static " << nsStatic
+				<< " ns/sample, modulated " << nsModulated << " ns/sample"
+				<< endl;
+	}
+
+	delete[] x;
+	delete[] y;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/*
+ * filter of Test_FilterSlot with the latency of a pipeline: outputs the block
+ * of the previous call (zeros first)
+ */
+class CBlockDelayTest: public CFilterBase {
+	float *m_block;
+	uint32_t m_size;
+public:
+	CBlockDelayTest(uint16_t channels, uint16_t frames) :
+			CFilterBase(1, channels, 0) {
+		m_size = (uint32_t) channels * frames;
+		m_block = new float[m_size];
+		memset(m_block, 0, m_size * sizeof(float));
+	}
+	~CBlockDelayTest() {
+		delete[] m_block;
+	}
+	bool filter(float *inBuf, float *outBuf, uint16_t framesPerBuffer) {
+		if ((uint32_t) framesPerBuffer * m_channels != m_size)
+			return false;
+		for (uint32_t i = 0; i < m_size; i++) {
+			float x = inBuf[i];
+			outBuf[i] = m_block[i];
+			m_block[i] = x;
+		}
+		return true;
+	}
+	using CFilterBase::filter;
+	int getLatency() {
+		return 1;
+	}
+};
+
+/*
+ * control thread of Test_FilterSlot: publishes new delay filters while the
+ * audio loop is running
+ */
+struct SlotTestControl {
+	CFilterSlot *pSlot;
+	uint32_t fs;
+	int numPublish;
+	std::atomic<bool> done;
+};
+
+static void* slotTestControlThread(void *pArg) {
+	SlotTestControl *pCtl = (SlotTestControl*) pArg;
+	for (int i = 0; i < pCtl->numPublish; i++) {
+		pCtl->pSlot->publish(
+				new CFilterDelay(0.5, 0.5, 5 + i % 20, pCtl->fs, 1));
+		usleep(2000);
+	}
+	pCtl->done = true;
+	return NULL;
+}
+
+void Test_FilterSlot() {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 16000;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 8;
+	int numFrames = framesPerBlock * numBlocks;
+	float *x = new float[numFrames];
+	float *y = new float[numFrames];
+	float *yOld = new float[numFrames];
+	float *yNew = new float[numFrames];
+	for (int k = 0; k < numFrames; k++)
+		x[k] = sin(2. * M_PI * 440. * k / fs);
+
+	// the first filter fades in from the unfiltered signal in block 0
+	// swap in block 3: the block is the crossfade of both filters, the
+	// following blocks are the output of the new filter (started in block 3)
+	CFilterSlot slot;
+	CFilterDelay refOld(0.5, 0.5, 10, fs, 1), refNew(0.8, 0.3, 7, fs, 1);
+	slot.publish(new CFilterDelay(0.5, 0.5, 10, fs, 1));
+	for (int b = 0; b < numBlocks; b++) {
+		if (b == 3)
+			slot.publish(new CFilterDelay(0.8, 0.3, 7, fs, 1));
+		float *pBlk = y + b * framesPerBlock;
+		memcpy(pBlk, x + b * framesPerBlock, framesPerBlock * sizeof(float));
+		slot.filter(pBlk, pBlk, framesPerBlock);		// in place
+		refOld.filter(x + b * framesPerBlock, yOld + b * framesPerBlock,
+				framesPerBlock);
+		if (b >= 3)
+			refNew.filter(x + b * framesPerBlock, yNew + b * framesPerBlock,
+					framesPerBlock);
+	}
+	double err = 0.;
+	for (int k = 0; k < numFrames; k++) {
+		double yRef = yOld[k];
+		double g = (k % framesPerBlock + 0.5) / framesPerBlock;
+		if (k >= 4 * framesPerBlock)
+			yRef = yNew[k];
+		else if (k >= 3 * framesPerBlock)
+			yRef = yOld[k] + g * (yNew[k] - yOld[k]);
+		else if (k < framesPerBlock)
+			yRef = x[k] + g * (yOld[k] - x[k]);
+		err = fmax(err, fabs(y[k] - yRef));
+	}
+	cout << "crossfade: max. deviation " << err << " -> "
+			<< ((err <= 1e-6) ? "passed" : "FAILED") << endl;
+	int numDeleted = slot.collect();
+	cout << "retired filters deleted: " << numDeleted << endl;
+
+	// a block larger than the initial crossfade buffer is crossfaded in one
+	// piece (a pipeline only accepts complete blocks)
+	{
+		int channels = 3, frames = 1000;
+		CFilterSlot large(1024);
+		CFilterChain *pChain = new CFilterChain(channels);
+		pChain->addStage(new CFilterDelay(0.5, 0.5, 10, fs, channels));
+		pChain->addStage(new CFilterDelay(0.8, 0.3, 7, fs, channels));
+		float *buf = new float[channels * frames];
+		memset(buf, 0, channels * frames * sizeof(float));
+		large.publish(new CFilterDelay(0.5, 0.5, 10, fs, channels), frames);
+		bool ok = large.filter(buf, buf, frames);
+		large.publish(new CFilterPipeline(pChain, frames, 1), frames);
+		ok = ok && large.filter(buf, buf, frames);
+		large.collect();
+		cout << channels << " channels, " << frames
+				<< " frames into a pipeline (crossfade buffer 1024 samples) -> "
+				<< (ok ? "passed" : "FAILED") << endl;
+		delete[] buf;
+	}
+
+	// filters of different latency are switched over without crossfade (the
+	// delayed output does not belong to the block), a block larger than the
+	// crossfade buffer is switched over as well
+	{
+		int frames = 64;
+		CFilterSlot slotL(1024);
+		float in[64], out[64];
+		for (int k = 0; k < frames; k++)
+			in[k] = 1.f;
+		slotL.publish(new CFilterDelay(0.5, 0.5, 1, fs, 1), frames);
+		bool ok = slotL.filter(in, out, frames);
+		slotL.publish(new CBlockDelayTest(1, frames), frames);
+		ok = ok && slotL.filter(in, out, frames);
+		for (int k = 0; k < frames; k++)
+			ok = ok && (out[k] == 0.f);		// first block of the new filter
+		ok = ok && slotL.filter(in, out, frames) && (out[frames - 1] == 1.f);
+		slotL.publish(NULL);
+		ok = ok && slotL.filter(in, out, frames) && (out[0] == 1.f);
+		CFilterSlot small(16);
+		small.publish(new CFilterDelay(0.5, 0.5, 1, fs, 1));
+		ok = ok && small.filter(in, out, 16);
+		small.publish(new CFilterDelay(0.8, 0.3, 1, fs, 1));
+		ok = ok && !small.filter(in, out, frames) && small.filter(in, out, 16);
+		slotL.collect();
+		small.collect();
+		cout << "switch-over without crossfade (latency, block size) -> "
+				<< (ok ? "passed" : "FAILED") << endl;
+	}
+
+	// publish from a second thread while the audio loop is running
+	SlotTestControl ctl;
+	ctl.pSlot = &slot;
+	ctl.fs = fs;
+	ctl.numPublish = 20;
+	ctl.done = false;
+	pthread_t thread;
+	pthread_create(&thread, NULL, slotTestControlThread, &ctl);
+	int blocks = 0;
+	auto start = chrono::steady_clock::now();
+	while (!ctl.done) {
+		slot.filter(x, y, framesPerBlock);
+		blocks++;
+	}
+	auto stop = chrono::steady_clock::now();
+	pthread_join(thread, NULL);
+	slot.filter(x, y, framesPerBlock);
+	slot.collect();
+	cout << blocks << " blocks while publishing, "
+			<< chrono::duration<double, nano>(stop - start).count()
+					/ ((double) blocks * framesPerBlock) << " ns/sample" << endl;
+
+	delete[] x;
+	delete[] y;
+	delete[] yOld;
+	delete[] yNew;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterChain(string &soundfile, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	if (filterfile.read(fs) == 0) {
+		cout << "no filter for " << fs << "Hz" << endl;
+		filterfile.close();
+		delete[] x;
+		return;
+	}
+	uint16_t order = filterfile.getOrder();
+	float *ac = filterfile.getACoeffs();
+	float *bc = filterfile.getBCoeffs();
+
+	int framesPerBlock = fs / 8;
+	int numBlocks = numFrames / framesPerBlock;
+	int numSamples = numBlocks * framesPerBlock * channels;
+	float *y = new float[numSamples];
+	float *yRef = new float[numSamples];
+	float *tmp = new float[numSamples];
+
+	// reference: both filters one after another with separate buffers
+	CFilter refFilter(fltfile, ac, bc, order, channels);
+	CFilterDelay refDelay(0.5, 0.5, 120, fs, channels);
+	benchmarkFilter(refFilter, x, tmp, framesPerBlock, numBlocks, channels);
+	benchmarkFilter(refDelay, tmp, yRef, framesPerBlock, numBlocks, channels);
+
+	// chain in place on a single buffer
+	CFilterChain chain(channels);
+	chain.addStage(new CFilter(fltfile, ac, bc, order, channels));
+	chain.addStage(new CFilterDelay(0.5, 0.5, 120, fs, channels));
+	memcpy(y, x, numSamples * sizeof(float));
+	double nsChain = benchmarkFilter(chain, y, y, framesPerBlock, numBlocks,
+			channels);
+	double err = 0.;
+	for (int k = 0; k < numSamples; k++)
+		err = fmax(err, fabs(y[k] - yRef[k]));
+	cout << "chain in place: " << nsChain << " ns/sample, max. deviation "
+			<< err << " -> " << ((err <= 1e-6) ? "passed" : "FAILED") << endl;
+	for (int i = 0; i < chain.getNumStages(); i++)
+		cout << "stage " << i + 1 << ": " << chain.getStageTime(i)
+				<< " ns/sample" << endl;
+
+	// the delay bypassed: output of the first stage only
+	chain.setBypass(1, true);
+	chain.resetTiming();
+	benchmarkFilter(chain, x, y, framesPerBlock, numBlocks, channels);
+	err = 0.;
+	for (int k = 0; k < numSamples; k++)
+		err = fmax(err, fabs(y[k] - tmp[k]));
+	cout << "delay bypassed: max. deviation " << err << ", stage 2 "
+			<< chain.getStageTime(1) << " ns/sample -> "
+			<< (((err == 0.) && (chain.getStageTime(1) == 0.)) ?
+					"passed" : "FAILED") << endl;
+
+	filterfile.close();
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+	delete[] tmp;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/*
+ * chain of 4 stages used by Test_FilterPipeline
+ */
+static CFilterChain* pipelineTestChain(string &fltfile, float *ac, float *bc,
+		uint16_t order, uint32_t fs, uint16_t channels) {
+	CFilterChain *pChain = new CFilterChain(channels);
+	pChain->addStage(new CFilter(fltfile, ac, bc, order, channels));
+	pChain->addStage(new CFilterDelay(0.5, 0.5, 120, fs, channels));
+	pChain->addStage(new CFilter(fltfile, ac, bc, order, channels));
+	pChain->addStage(new CFilterDelay(0.7, 0.3, 45, fs, channels));
+	return pChain;
+}
+
+void Test_FilterPipeline(string &soundfile, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	if (filterfile.read(fs) == 0) {
+		cout << "no filter for " << fs << "Hz" << endl;
+		filterfile.close();
+		delete[] x;
+		return;
+	}
+	uint16_t order = filterfile.getOrder();
+	float *ac = filterfile.getACoeffs();
+	float *bc = filterfile.getBCoeffs();
+
+	int framesPerBlock = fs / 8;
+	int numBlocks = numFrames / framesPerBlock;
+	int blockSize = framesPerBlock * channels;
+	int numSamples = numBlocks * blockSize;
+	float *yRef = new float[numSamples];
+	// the pipeline delivers latency blocks later (up to MAX_GROUPS-1 blocks)
+	float *y = new float[(numBlocks + CFilterPipeline::MAX_GROUPS) * blockSize];
+	float *buf = new float[blockSize];
+
+	// reference: the chain processed by one thread
+	CFilterChain *pRefChain = pipelineTestChain(fltfile, ac, bc, order, fs,
+			channels);
+	double nsRef = benchmarkFilter(*pRefChain, x, yRef, framesPerBlock,
+			numBlocks, channels);
+	cout << "single thread: " << nsRef << " ns/sample" << endl;
+	delete pRefChain;
+
+	for (int latency = 1; latency < 4; latency++) {
+		CFilterPipeline pipeline(
+				pipelineTestChain(fltfile, ac, bc, order, fs, channels),
+				framesPerBlock, latency);
+		int L = pipeline.getLatency();
+		// the blocks are passed by the caller like play() does (in place on
+		// one buffer), zero blocks flush the pipeline
+		auto start = chrono::steady_clock::now();
+		for (int k = 0; k < numBlocks + L; k++) {
+			if (k < numBlocks)
+				memcpy(buf, x + k * blockSize, blockSize * sizeof(float));
+			else
+				memset(buf, 0, blockSize * sizeof(float));
+			pipeline.filter(buf, buf, framesPerBlock);
+			memcpy(y + k * blockSize, buf, blockSize * sizeof(float));
+		}
+		double ns = chrono::duration<double, nano>(
+				chrono::steady_clock::now() - start).count() / numSamples;
+
+		double err = 0.;
+		for (int k = 0; k < numSamples; k++)
+			err = fmax(err, fabs(y[L * blockSize + k] - yRef[k]));
+		bool silent = true;	// output while the pipeline is filling
+		for (int k = 0; k < L * blockSize; k++)
+			silent = silent && (y[k] == 0.);
+		cout << "latency " << L << " (" << pipeline.getNumGroups()
+				<< " threads): " << ns << " ns/sample, speedup " << nsRef / ns
+				<< ", max. deviation " << err << " -> "
+				<< (((err == 0.) && silent) ? "passed" : "FAILED") << endl;
+		for (int g = 0; g < pipeline.getNumGroups(); g++) {
+			int first, num;
+			pipeline.getGroup(g, first, num);
+			cout << "  thread " << g + 1 << ": stages " << first + 1 << "-"
+					<< first + num << endl;
+		}
+	}
+
+	filterfile.close();
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+	delete[] buf;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/*
+ * task of Test_FilterChannelParallel: counts its executions, the tasks take
+ * different times so that the workers have to steal
+ */
+static void poolTestTask(void *pArg, int task) {
+	atomic<int> *pCount = (atomic<int>*) pArg;
+	volatile float sum = 0.;
+	for (int i = 0; i < (task % 7) * 20000; i++)
+		sum = sum + i;
+	pCount[task]++;
+}
+
+void Test_FilterChannelParallel(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	// pool: each task exactly once, also if more tasks than threads
+	CWorkerPool pool(3);
+	const int numTasks = 100;
+	atomic<int> count[numTasks];
+	bool once = true;
+	for (int batch = 0; batch < 50; batch++) {
+		for (int t = 0; t < numTasks; t++)
+			count[t] = 0;
+		pool.run(numTasks, poolTestTask, count);
+		for (int t = 0; t < numTasks; t++)
+			once = once && (count[t] == 1);
+	}
+	cout << "worker pool (" << pool.getNumWorkers() << " workers): "
+			<< (once ? "passed" : "FAILED") << endl;
+
+	uint32_t fs = 48000;
+	uint16_t channels = 8;
+	int numFrames = fs * 4;
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	uint16_t order = filterfile.getOrder();
+	float *ca = filterfile.getACoeffs();
+	float *cb = filterfile.getBCoeffs();
+
+	int sigSize = numFrames * channels;
+	float *x = new float[sigSize];
+	float *y = new float[sigSize];
+	float *yRef = new float[sigSize];
+	srand(1);
+	for (int i = 0; i < sigSize; i++)
+		x[i] = 2.f * rand() / RAND_MAX - 1.f;
+
+	cout << fltfile << ", fs=" << fs << "Hz, order=" << order << ", "
+			<< channels << " channels, "
+			<< CWorkerPool::getShared()->getNumWorkers() << " workers" << endl;
+
+	CFilter directForm(filterfile.getFilepath(), ca, cb, order, channels);
+	CFilterSOS sos(filterfile.getFilepath(), ca, cb, order, channels);
+	CFilterBase *filters[] = { &directForm, &sos };
+	string names[] = { "CFilter", "CFilterSOS" };
+	// small blocks are filtered by the calling thread (cost heuristic)
+	int blockSizes[] = { 256, 1024, (int) fs / 8 };
+	for (int f = 0; f < 2; f++)
+		for (int b = 0; b < 3; b++) {
+			int numBlocks = numFrames / blockSizes[b];
+			filters[f]->setChannelParallel(false);
+			double nsSerial = benchmarkFilter(*filters[f], x, yRef,
+					blockSizes[b], numBlocks, channels);
+			filters[f]->setChannelParallel(true);
+			// in place like play()
+			memcpy(y, x, sigSize * sizeof(float));
+			double nsParallel = benchmarkFilter(*filters[f], y, y,
+					blockSizes[b], numBlocks, channels);
+			bool exact = true;
+			for (int k = 0; k < numBlocks * blockSizes[b] * channels; k++)
+				exact = exact && (y[k] == yRef[k]);
+			cout << names[f] << ", " << blockSizes[b] << " frames/block: "
+					<< nsSerial << " ns/sample serial, " << nsParallel
+					<< " ns/sample channel-parallel -> "
+					<< (exact ? "passed" : "FAILED") << endl;
+		}
+	filterfile.close();
+
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/*
+ * filters a signal block by block as planar blocks, returns ns per sample
+ */
+static double benchmarkFilterPlanar(CFilterBase &flt, float *x, float *y,
+		int framesPerBlock, int numBlocks, int channels, uint32_t fs) {
+	CAudioBlock block(channels, framesPerBlock, fs);
+	flt.reset();
+	double ns = 0.;
+	for (int b = 0; b < numBlocks; b++) {
+		// only the filter is timed (conversion happens at the edges)
+		block.deinterleave(x + b * framesPerBlock * channels, framesPerBlock);
+		auto start = chrono::steady_clock::now();
+		flt.filter(block, block);
+		auto stop = chrono::steady_clock::now();
+		ns += chrono::duration<double, nano>(stop - start).count();
+		block.interleave(y + b * framesPerBlock * channels);
+	}
+	return ns / ((double) framesPerBlock * numBlocks * channels);
+}
+
+void Test_AudioBlock(string &soundfile, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	int framesPerBlock = fs / 8;
+	int numBlocks = sndF.getNumFrames() / framesPerBlock;
+	int numSamples = numBlocks * framesPerBlock * channels;
+	float *x = new float[numSamples];
+	float *y = new float[numSamples];
+	float *yRef = new float[numSamples];
+
+	// reading planar blocks from the file and interleaving them again must
+	// give the samples read as interleaved buffer
+	CAudioBlock block(channels, framesPerBlock, fs);
+	bool same = true;
+	for (int b = 0; b < numBlocks; b++) {
+		float *xb = x + b * framesPerBlock * channels;
+		sndF.read(block);
+		block.interleave(xb);
+		same = same && (block.getNumFrames() == framesPerBlock);
+	}
+	sndF.rewind();
+	sndF.read(yRef, numBlocks * framesPerBlock);
+	sndF.close();
+	for (int k = 0; k < numSamples; k++)
+		same = same && (x[k] == yRef[k]);
+	cout << "file -> planar -> interleaved: " << (same ? "passed" : "FAILED")
+			<< endl;
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	if (filterfile.read(fs) == 0) {
+		cout << "no filter for " << fs << "Hz" << endl;
+		filterfile.close();
+		delete[] x;
+		delete[] y;
+		delete[] yRef;
+		return;
+	}
+	uint16_t order = filterfile.getOrder();
+	float *ac = filterfile.getACoeffs();
+	float *bc = filterfile.getBCoeffs();
+
+	// planar and interleaved filtering must give the same samples, the
+	// delay filter has no planar kernel (interleaved internally)
+	CFilter directForm(fltfile, ac, bc, order, channels);
+	CFilterSOS sos(fltfile, ac, bc, order, channels);
+	CFilterDelay delay(0.5, 0.5, 120, fs, channels);
+	CFilterChain chain(channels);
+	chain.addStage(new CFilter(fltfile, ac, bc, order, channels));
+	chain.addStage(new CFilterDelay(0.5, 0.5, 120, fs, channels));
+	CFilterBase *filters[] = { &directForm, &sos, &delay, &chain };
+	string names[] = { "CFilter", "CFilterSOS", "CFilterDelay", "CFilterChain" };
+	for (int f = 0; f < 4; f++) {
+		double nsInterleaved = benchmarkFilter(*filters[f], x, yRef,
+				framesPerBlock, numBlocks, channels);
+		double nsPlanar = benchmarkFilterPlanar(*filters[f], x, y,
+				framesPerBlock, numBlocks, channels, fs);
+		bool exact = true;
+		for (int k = 0; k < numSamples; k++)
+			exact = exact && (y[k] == yRef[k]);
+		cout << names[f] << ": " << nsInterleaved << " ns/sample interleaved, "
+				<< nsPlanar << " ns/sample planar -> "
+				<< (exact ? "passed" : "FAILED") << endl;
+	}
+
+	// the slot crossfades planar blocks like interleaved ones
+	CFilterSlot slotI, slotP;
+	slotI.publish(new CFilter(fltfile, ac, bc, order, channels));
+	slotP.publish(new CFilter(fltfile, ac, bc, order, channels));
+	memcpy(y, x, numSamples * sizeof(float));
+	memcpy(yRef, x, numSamples * sizeof(float));
+	for (int b = 0; b < numBlocks; b++) {
+		float *yb = y + b * framesPerBlock * channels;
+		float *rb = yRef + b * framesPerBlock * channels;
+		if (b == numBlocks / 2) {
+			slotI.publish(new CFilterDelay(0.5, 0.5, 120, fs, channels));
+			slotP.publish(new CFilterDelay(0.5, 0.5, 120, fs, channels));
+		}
+		slotI.filter(rb, rb, framesPerBlock);
+		block.deinterleave(yb, framesPerBlock);
+		slotP.filter(block, block);
+		block.interleave(yb);
+	}
+	same = true;
+	for (int k = 0; k < numSamples; k++)
+		same = same && (y[k] == yRef[k]);
+	cout << "CFilterSlot crossfade planar: " << (same ? "passed" : "FAILED")
+			<< endl;
+
+	filterfile.close();
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterFixed(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 48000;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 80;
+	int maxOrder = CFilterFixedFactory::MAX_ORDER;
+	int maxChannels = CFilterFixedFactory::MAX_CHANNELS;
+
+	int sigSize = framesPerBlock * maxChannels * numBlocks;
+	float *x = new float[sigSize];
+	float *y = new float[sigSize];
+	float *yRef = new float[sigSize];
+	srand(1);
+	for (int i = 0; i < sigSize; i++)
+		x[i] = 2.f * rand() / RAND_MAX - 1.f;
+
+	// all specializations: bit exact to the scalar kernel of CFilter
+	// (stable coefficients: sum of |ai| < 1)
+	float ca[CFilterFixedFactory::MAX_ORDER + 1], cb[CFilterFixedFactory::MAX_ORDER + 1];
+	bool exact = true;
+	for (int order = 1; order <= maxOrder; order++)
+		for (int channels = 1; channels <= maxChannels; channels++) {
+			for (int n = 0; n <= order; n++) {
+				ca[n] = (n == 0) ? 1.f : 0.4f * powf(-0.5f, n);
+				cb[n] = 1.f / (n + 1);
+			}
+			CFilter ref("", ca, cb, order, channels);
+			ref.setKernel(CFilter::KERNEL_SCALAR);
+			CFilterBase *pFixed = CFilterFixedFactory::create("", ca, cb, order,
+					channels);
+			benchmarkFilter(ref, x, yRef, framesPerBlock, 4, channels);
+			benchmarkFilter(*pFixed, x, y, framesPerBlock, 4, channels);
+			for (int k = 0; k < 4 * framesPerBlock * channels; k++)
+				exact = exact && (y[k] == yRef[k]);
+			delete pFixed;
+		}
+	cout << "orders 1-" << maxOrder << ", channels 1-" << maxChannels
+			<< ": " << (exact ? "passed" : "FAILED") << endl;
+
+	// benchmark with the filter file (stereo)
+	uint16_t channels = 2;
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	uint16_t order = filterfile.getOrder();
+	float *fa = filterfile.getACoeffs();
+	float *fb = filterfile.getBCoeffs();
+	cout << fltfile << ", fs=" << fs << "Hz, order=" << order << ", "
+			<< channels << " channels" << endl;
+
+	CFilter directForm(filterfile.getFilepath(), fa, fb, order, channels);
+	CFilter::KERNEL bestKernel = directForm.getKernel();
+	directForm.setKernel(CFilter::KERNEL_SCALAR);
+	double nsScalar = benchmarkFilter(directForm, x, yRef, framesPerBlock,
+			numBlocks, channels);
+	directForm.setKernel(bestKernel);
+	double nsBest = benchmarkFilter(directForm, x, y, framesPerBlock,
+			numBlocks, channels);
+	cout << "CFilter (scalar): " << nsScalar << " ns/sample" << endl;
+	cout << "CFilter (" << CFilter::getKernelName(bestKernel) << "): "
+			<< nsBest << " ns/sample" << endl;
+
+	CFilterBase *pFixed = CFilterFixedFactory::create(filterfile.getFilepath(),
+			fa, fb, order, channels);
+	double nsFixed = benchmarkFilter(*pFixed, x, y, framesPerBlock, numBlocks,
+			channels);
+	exact = true;
+	for (int k = 0; k < sigSize; k++)
+		exact = exact && (y[k] == yRef[k]);
+	cout << (CFilterFixedFactory::isSpecialized(order, channels) ?
+			"CFilterFixed: " : "CFilter (no specialization): ") << nsFixed
+			<< " ns/sample, speedup " << nsBest / nsFixed << " -> "
+			<< (exact ? "passed" : "FAILED") << endl;
+	delete pFixed;
+
+	try {
+		CFilterSOS sos(filterfile.getFilepath(), fa, fb, order, channels);
+		cout << "CFilterSOS: "
+				<< benchmarkFilter(sos, x, y, framesPerBlock, numBlocks,
+						channels) << " ns/sample" << endl;
+	} catch (CException &e) {
+		cout << e << endl;
+	}
+	filterfile.close();
+
+	delete[] x;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief compares a filtered signal with the double precision reference
+ *
+ * \param y filtered signal
+ * \param yRef reference signal
+ * \param size number of samples
+ * \param tail number of samples at the end of the signal (long after the input stopped)
+ * \param name name of the filter for the output
+ * \param nsPerSample processing time
+ * \return maximum absolute error
+ */
+static double printPrecision(float *y, double *yRef, int size, int tail,
+		string name, double nsPerSample) {
+	double maxErr = 0., errPow = 0., refPow = 0., tailMax = 0.;
+	for (int k = 0; k < size; k++) {
+		double err = y[k] - yRef[k];
+		maxErr = fmax(maxErr, fabs(err));
+		errPow += err * err;
+		refPow += yRef[k] * yRef[k];
+		if (k >= size - tail)
+			tailMax = fmax(tailMax, fabs(y[k]));
+	}
+	cout << name << ": " << nsPerSample << " ns/sample, max. error " << maxErr
+			<< ", SNR " << 10. * log10(refPow / fmax(errPow, 1e-300))
+			<< " dB, max. output at the end of the silence " << tailMax << endl;
+	return maxErr;
+}
+
+void Test_FilterPrecision(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 48000;
+	uint16_t channels = 2;
+	int framesPerBlock = fs / 8;
+	int numBlocks = 480;	// one minute
+	int tailBlocks = 80;	// the last 10s of the input are silent
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	uint16_t order = filterfile.getOrder();
+	double *da = filterfile.getACoeffsDouble();
+	double *db = filterfile.getBCoeffsDouble();
+	cout << fltfile << ", fs=" << fs << "Hz, order=" << order << ", "
+			<< channels << " channels" << endl;
+
+	int sigSize = framesPerBlock * channels * numBlocks;
+	int silence = framesPerBlock * channels * tailBlocks;
+	int tail = framesPerBlock * channels;	// last block
+	float *x = new float[sigSize];
+	float *y = new float[sigSize];
+	double *xRef = new double[sigSize];
+	double *yRef = new double[sigSize];
+	srand(1);
+	for (int i = 0; i < sigSize; i++) {
+		x[i] = (i < sigSize - silence) ? (rand() / (float) RAND_MAX - 0.5f) : 0.f;
+		xRef[i] = x[i];
+	}
+
+	// reference: double throughout (double samples)
+	CFilterPrecise<CPrecisionDouble> ref(filterfile.getFilepath(), da, db,
+			order, channels);
+	for (int b = 0; b < numBlocks; b++)
+		ref.filter(xRef + b * framesPerBlock * channels,
+				yRef + b * framesPerBlock * channels, framesPerBlock);
+
+	// all precision policies (float samples)
+	CFilterPrecise<CPrecisionFloat> precFloat(filterfile.getFilepath(), da,
+			db, order, channels);
+	CFilterPrecise<CPrecisionMixed> precMixed(filterfile.getFilepath(), da,
+			db, order, channels);
+	CFilterPrecise<CPrecisionDouble> precDouble(filterfile.getFilepath(), da,
+			db, order, channels);
+	double ns = benchmarkFilter(precFloat, x, y, framesPerBlock, numBlocks,
+			channels);
+	printPrecision(y, yRef, sigSize, tail,
+			"CFilterPrecise<" + precFloat.getPrecisionName() + ">", ns);
+	ns = benchmarkFilter(precMixed, x, y, framesPerBlock, numBlocks, channels);
+	printPrecision(y, yRef, sigSize, tail,
+			"CFilterPrecise<" + precMixed.getPrecisionName() + ">", ns);
+	ns = benchmarkFilter(precDouble, x, y, framesPerBlock, numBlocks,
+			channels);
+	double maxErr = printPrecision(y, yRef, sigSize, tail,
+			"CFilterPrecise<" + precDouble.getPrecisionName() + ">", ns);
+
+	// the engines with float coefficients used by the player
+	float *fa = filterfile.getACoeffs();
+	float *fb = filterfile.getBCoeffs();
+	CFilter directForm(filterfile.getFilepath(), fa, fb, order, channels);
+	ns = benchmarkFilter(directForm, x, y, framesPerBlock, numBlocks, channels);
+	printPrecision(y, yRef, sigSize, tail,
+			"CFilter (" + CFilter::getKernelName(directForm.getKernel()) + ")",
+			ns);
+	try {
+		CFilterSOS sos(filterfile.getFilepath(), fa, fb, order, channels);
+		ns = benchmarkFilter(sos, x, y, framesPerBlock, numBlocks, channels);
+		printPrecision(y, yRef, sigSize, tail, "CFilterSOS", ns);
+	} catch (CException &e) {
+		cout << e << endl;
+	}
+	filterfile.close();
+
+	// double states with float samples: only the rounding of the output
+	double peak = 0.;
+	for (int k = 0; k < sigSize; k++)
+		peak = fmax(peak, fabs(yRef[k]));
+	cout << "double policy matches the reference: "
+			<< ((maxErr <= peak * 1e-6) ? "passed" : "FAILED") << endl;
+
+	delete[] x;
+	delete[] y;
+	delete[] xRef;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief measures the cost of each block while a filter decays into silence
+ *
+ * the input is a decaying noise burst (first block) followed by silence.
+ * The cost of the blocks is averaged over windows of some blocks (timer
+ * resolution), the measurement is repeated and the fastest run of each
+ * window is taken (interrupts, scheduling).
+ *
+ * \param flt filter to be measured
+ * \param x input signal (numBlocks blocks)
+ * \param y output signal (one block)
+ * \param framesPerBlock frames per block
+ * \param numBlocks number of blocks
+ * \param channels number of channels
+ * \param nsSignal cost of the filter for a signal without subnormal numbers
+ * \param name name of the filter and the protection for the output
+ * \return ratio of the slowest window to nsSignal
+ */
+static double benchmarkDecay(CFilterBase &flt, float *x, float *y,
+		int framesPerBlock, int numBlocks, int channels, double nsSignal,
+		string name) {
+	const int window = 16, repeats = 3;
+	int numWindows = numBlocks / window;
+	double *ns = new double[numWindows];
+	for (int rep = 0; rep < repeats; rep++) {
+		flt.reset();
+		for (int w = 0; w < numWindows; w++) {
+			auto start = chrono::steady_clock::now();
+			for (int b = w * window; b < (w + 1) * window; b++)
+				flt.filter(x + b * framesPerBlock * channels, y,
+						framesPerBlock);
+			auto stop = chrono::steady_clock::now();
+			double t = chrono::duration<double, nano>(stop - start).count()
+					/ ((double) framesPerBlock * window * channels);
+			ns[w] = (rep == 0) ? t : fmin(ns[w], t);
+		}
+	}
+	double slowest = 0.;
+	int slowestWindow = 0;
+	for (int w = 0; w < numWindows; w++)
+		if (ns[w] > slowest) {
+			slowest = ns[w];
+			slowestWindow = w;
+		}
+	delete[] ns;
+	cout << name << ": slowest " << slowest << " ns/sample (block "
+			<< slowestWindow * window << "), ratio " << slowest / nsSignal
+			<< endl;
+	return slowest / nsSignal;
+}
+
+void Test_FilterDenormals(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	uint32_t fs = 48000;
+	uint16_t channels = 2;
+	int framesPerBlock = 512;
+	int numBlocks = 1024;	// 11 s
+	double maxRatio = 2.;	// tolerated variation of the cost per block
+
+	// decaying noise burst followed by silence
+	int sigSize = framesPerBlock * channels * numBlocks;
+	float *x = new float[sigSize];
+	float *y = new float[sigSize];
+	float *noise = new float[sigSize];
+	srand(1);
+	for (int i = 0; i < sigSize; i++) {
+		noise[i] = 2.f * rand() / RAND_MAX - 1.f;
+		x[i] = (i < framesPerBlock * channels) ?
+				noise[i] * expf(-8.f * i / (framesPerBlock * channels)) : 0.f;
+	}
+
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	CFilter directForm(filterfile.getFilepath(), filterfile.getACoeffs(),
+			filterfile.getBCoeffs(), filterfile.getOrder(), channels);
+	CFilterSOS sos(filterfile.getFilepath(), filterfile.getACoeffs(),
+			filterfile.getBCoeffs(), filterfile.getOrder(), channels);
+	filterfile.close();
+	CFilterDelay delay(0.5, 0.9, 2.1, fs, channels);	// long decay
+	CFilterBase *pFilters[] = { &directForm, &sos, &delay };
+	string names[] = { "CFilter (" + CFilter::getKernelName(directForm.getKernel())
+			+ ")", "CFilterSOS", "CFilterDelay" };
+
+	cout << "flush-to-zero " << (CDenormalGuard::isSupported() ?
+			"supported" : "not supported") << endl;
+	bool passed = true;
+	for (int i = 0; i < 3; i++) {
+		// reference: cost for a signal (noise) without subnormal numbers
+		double nsSignal = benchmarkFilter(*pFilters[i], noise, y,
+				framesPerBlock, numBlocks, channels);
+		cout << names[i] << ", signal: " << nsSignal << " ns/sample" << endl;
+		// no protection: subnormal states slow down the blocks after the burst
+		benchmarkDecay(*pFilters[i], x, y, framesPerBlock, numBlocks, channels,
+				nsSignal, names[i] + ", unprotected");
+		pFilters[i]->setDenormalOffset();
+		passed &= benchmarkDecay(*pFilters[i], x, y, framesPerBlock, numBlocks,
+				channels, nsSignal, names[i] + ", offset") < maxRatio;
+		pFilters[i]->setDenormalOffset(0.);
+		if (CDenormalGuard::isSupported()) {
+			CDenormalGuard guard;
+			passed &= benchmarkDecay(*pFilters[i], x, y, framesPerBlock,
+					numBlocks, channels, nsSignal, names[i] + ", flush-to-zero")
+					< maxRatio;
+		}
+	}
+	cout << "constant cost per block: " << (passed ? "passed" : "FAILED")
+			<< endl;
+	cout << "flush-to-zero restored: "
+			<< (!CDenormalGuard::isFlushing() ? "passed" : "FAILED") << endl;
+
+	delete[] x;
+	delete[] y;
+	delete[] noise;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterAnalyzer(string &fltfile, string &fltfileLong) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	int fs = 48000;
+	CFilterAnalyzer analyzer;
+
+	// filter file: cutoff, stability, vectorized against scalar kernel and
+	// direct evaluation
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fs);
+	int order = filterfile.getOrder();
+	double *a = filterfile.getACoeffsDouble();
+	double *b = filterfile.getBCoeffsDouble();
+	auto start = chrono::steady_clock::now();
+	const CFilterAnalyzer::RESPONSE *pResp = analyzer.analyze(filterfile);
+	auto stop = chrono::steady_clock::now();
+	double usFirst = chrono::duration<double, micro>(stop - start).count();
+	cout << fltfile << ", fs=" << fs << "Hz: cutoff " << pResp->cutoff
+			<< "Hz, " << (pResp->stable ? "stable" : "UNSTABLE")
+			<< ", max. pole radius " << pResp->maxPoleRadius
+			<< ", group delay (DC) " << pResp->groupDelay[0] << " samples"
+			<< endl;
+
+	CFilterAnalyzer::RESPONSE scalar = *pResp;
+	scalar.freq = new double[4 * pResp->numBins];
+	scalar.magnitude = scalar.freq + pResp->numBins;
+	scalar.phase = scalar.freq + 2 * pResp->numBins;
+	scalar.groupDelay = scalar.freq + 3 * pResp->numBins;
+	for (int k = 0; k < pResp->numBins; k++)
+		scalar.freq[k] = pResp->freq[k];
+	start = chrono::steady_clock::now();
+	CFilterAnalyzer::evaluate(&scalar, a, b, order, false);
+	stop = chrono::steady_clock::now();
+	double usScalar = chrono::duration<double, micro>(stop - start).count();
+	start = chrono::steady_clock::now();
+	CFilterAnalyzer::evaluate(&scalar, a, b, order, true);
+	stop = chrono::steady_clock::now();
+	double usVector = chrono::duration<double, micro>(stop - start).count();
+	double maxDev = 0.;
+	for (int k = 0; k < pResp->numBins; k++) {
+		complex<double> w = polar(1., -2. * M_PI * pResp->freq[k] / fs);
+		complex<double> H = CPolynomial::evalInv(b, order, w)
+				/ CPolynomial::evalInv(a, order, w);
+		maxDev = fmax(maxDev, fabs(20. * log10(abs(H)) - pResp->magnitude[k]));
+	}
+	cout << "evaluation " << usScalar << " us scalar, " << usVector
+			<< " us vectorized, max. deviation " << maxDev << " dB -> "
+			<< ((maxDev < 1e-6) ? "passed" : "FAILED") << endl;
+	delete[] scalar.freq;
+	filterfile.close();
+
+	// second request: taken from the cache
+	filterfile.open();
+	filterfile.read(fs);
+	start = chrono::steady_clock::now();
+	const CFilterAnalyzer::RESPONSE *pCached = analyzer.analyze(filterfile);
+	stop = chrono::steady_clock::now();
+	filterfile.close();
+	cout << "cache: " << usFirst << " us analysis, "
+			<< chrono::duration<double, micro>(stop - start).count()
+			<< " us cached -> "
+			<< (((pCached == pResp) && (analyzer.getHits() == 1)) ?
+					"passed" : "FAILED") << endl;
+
+	// pure delay of 3 samples: group delay 3 at all frequencies
+	double ad[] = { 1., 0., 0., 0. }, bd[] = { 0., 0., 0., 1. };
+	pResp = analyzer.analyze("delay3", fs, ad, bd, 3);
+	double maxErr = 0.;
+	for (int k = 0; k < pResp->numBins; k++)
+		maxErr = fmax(maxErr, fabs(pResp->groupDelay[k] - 3.));
+	cout << "group delay of a pure delay -> "
+			<< ((maxErr < 1e-9) && pResp->stable ? "passed" : "FAILED")
+			<< endl;
+
+	// poles at 1.1 and 1.0 resp. 0.9 and 0.5
+	double au[] = { 1., -2.1, 1.1 }, as[] = { 1., -1.4, 0.45 }, b2[] = { 1.,
+			0., 0. };
+	bool unstable = !analyzer.analyze("unstable", fs, au, b2, 2)->stable;
+	pResp = analyzer.analyze("stable", fs, as, b2, 2);
+	cout << "stability -> "
+			<< ((unstable && pResp->stable
+					&& (fabs(pResp->maxPoleRadius - 0.9) < 1e-9)) ?
+					"passed" : "FAILED") << endl;
+
+	// long filter: bound of the pole radii, step-down stability check
+	CFileFilter longfile(fltfileLong);
+	longfile.open();
+	longfile.read(16000);
+	start = chrono::steady_clock::now();
+	pResp = analyzer.analyze(longfile);
+	stop = chrono::steady_clock::now();
+	longfile.close();
+	cout << fltfileLong << ", order " << pResp->order << ": "
+			<< (pResp->stable ? "stable" : "UNSTABLE")
+			<< ", pole radius <= " << pResp->maxPoleRadius << ", "
+			<< chrono::duration<double, milli>(stop - start).count()
+			<< " ms" << endl;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * compares the coefficients of two filter files (read for the same sampling
+ * frequency) bitwise
+ */
+static bool sameCoeffs(CFileFilter &f1, CFileFilter &f2) {
+	int len = f1.getOrder() + 1;
+	return (f1.getOrder() == f2.getOrder())
+			&& (f1.getFilterType() == f2.getFilterType())
+			&& (f1.getFilterInfo() == f2.getFilterInfo())
+			&& (f1.getBlen() == f2.getBlen()) && (f1.getAlen() == f2.getAlen())
+			&& !memcmp(f1.getBCoeffsDouble(), f2.getBCoeffsDouble(),
+					len * sizeof(double))
+			&& !memcmp(f1.getACoeffsDouble(), f2.getACoeffsDouble(),
+					len * sizeof(double))
+			&& !memcmp(f1.getBCoeffs(), f2.getBCoeffs(), len * sizeof(float))
+			&& !memcmp(f1.getACoeffs(), f2.getACoeffs(), len * sizeof(float))
+			&& (f1.isSparse() == f2.isSparse())
+			&& (f1.getNumBTaps() == f2.getNumBTaps())
+			&& (f1.getNumATaps() == f2.getNumATaps());
+}
+
+void Test_FilterCache(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	int fs = 16000, reads = 20;
+
+	// reference: text parser
+	CFileFilter textfile(fltfile);
+	textfile.setCacheEnabled(false);
+	textfile.open();
+	auto start = chrono::steady_clock::now();
+	long posText = textfile.read(fs);
+	auto stop = chrono::steady_clock::now();
+	double msText = chrono::duration<double, milli>(stop - start).count();
+
+	// first read builds the cache, the following ones map it
+	CFileFilter filterfile(fltfile);
+	remove(filterfile.getCachePath().c_str());
+	filterfile.open();
+	start = chrono::steady_clock::now();
+	long posBuild = filterfile.read(fs);
+	stop = chrono::steady_clock::now();
+	double msBuild = chrono::duration<double, milli>(stop - start).count();
+	bool ok = (posBuild == posText) && sameCoeffs(textfile, filterfile);
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < reads; i++)
+		ok = ok && (filterfile.read(fs) == posText) && filterfile.isFromCache();
+	stop = chrono::steady_clock::now();
+	double msCache = chrono::duration<double, milli>(stop - start).count()
+			/ reads;
+	ok = ok && sameCoeffs(textfile, filterfile) && !filterfile.read(fs + 1);
+	cout << fltfile << ", fs=" << fs << "Hz: " << msText << " ms text, "
+			<< msBuild << " ms text and cache, " << msCache
+			<< " ms cached, speedup " << msText / msCache << " -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	// a copy of the file: an additional section invalidates the cache
+	string copy = fltfile + ".cachetest.txt";
+	FILE *pf = fopen(copy.c_str(), "wb");
+	CMappedFile text;
+	text.map(fltfile);
+	fwrite(text.getData(), 1, text.getSize(), pf);
+	fclose(pf);
+	CFileFilter copyfile(copy);
+	copyfile.open();
+	ok = (copyfile.read(fs) == posText) && sameCoeffs(textfile, copyfile);
+	copyfile.close();
+	pf = fopen(copy.c_str(), "ab");
+	int order = textfile.getOrder(), newFs = fs + 1;
+	double *coeffs[] = { textfile.getBCoeffsDouble(),
+			textfile.getACoeffsDouble() };
+	fprintf(pf, "%d\n", newFs);
+	for (int k = 0; k < 2; k++)
+		for (int i = 0; i <= order; i++)
+			fprintf(pf, "%.17g%c", coeffs[k][i], (i < order) ? ';' : '\n');
+	fclose(pf);
+	copyfile.open();
+	bool rebuilt = (copyfile.read(newFs) != 0) && copyfile.isFromCache();
+	copyfile.close();
+	CFileFilter copytext(copy);
+	copytext.setCacheEnabled(false);
+	copytext.open();
+	copytext.read(newFs);
+	copyfile.open();
+	copyfile.read(newFs);
+	ok = ok && rebuilt && sameCoeffs(copytext, copyfile);
+	copytext.close();
+	copyfile.close();
+	remove(copyfile.getCachePath().c_str());
+	remove(copy.c_str());
+	cout << "changed file -> " << (ok ? "passed" : "FAILED") << endl;
+
+	textfile.close();
+	filterfile.close();
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * writes a text to a file
+ */
+static void writeText(const string &path, const char *text) {
+	FILE *pf = fopen(path.c_str(), "wb");
+	fputs(text, pf);
+	fclose(pf);
+}
+
+/**
+ * reads a filter file for a sampling frequency without cache
+ * \return position after the section, -1 if the file was rejected
+ */
+static long parseFilterText(const string &path, int fs) {
+	CFileFilter filterfile(path);
+	filterfile.setCacheEnabled(false);
+	filterfile.open();
+	long pos;
+	try {
+		pos = filterfile.read(fs);
+	} catch (CException &e) {
+		pos = -1;
+	}
+	filterfile.close();
+	return pos;
+}
+
+void Test_FilterParser(string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	// throughput of the text parser
+	int fs = 16000, reads = 50;
+	CFileFilter filterfile(fltfile);
+	filterfile.setCacheEnabled(false);
+	filterfile.open();
+	auto start = chrono::steady_clock::now();
+	long pos = 0;
+	for (int i = 0; i < reads; i++)
+		pos = filterfile.read(fs);
+	auto stop = chrono::steady_clock::now();
+	double ms = chrono::duration<double, milli>(stop - start).count() / reads;
+	cout << fltfile << ", fs=" << fs << "Hz, order " << filterfile.getOrder()
+			<< ": " << ms << " ms per read, " << pos / ms / 1000.
+			<< " MB/s -> "
+			<< (((pos > 0) && (filterfile.getBlen() == filterfile.getOrder() + 1)
+					&& (filterfile.getAlen() == filterfile.getOrder() + 1)) ?
+					"passed" : "FAILED") << endl;
+	filterfile.close();
+
+	// sections and coefficients of a small file (CR LF, trailing separator,
+	// empty lines, last line without line feed)
+	string path = fltfile + ".parsertest.txt";
+	const char *text = "lowpass;2;test info\r\n16000\r\n1;-2.5e-1;+3;\r\n"
+			"1;0.5;0.25\r\n\n48000\n4;5;6\n1;0;0";
+	writeText(path, text);
+	CFileFilter small(path);
+	small.setCacheEnabled(false);
+	small.open();
+	long pos16 = small.read(16000);
+	bool ok = (pos16 == (long) (strstr(text, "\n\n") - text + 1))
+			&& (small.getFilterType() == "lowpass")
+			&& (small.getFilterInfo() == "test info\r\n")
+			&& (small.getBCoeffsDouble()[1] == -0.25)
+			&& (small.getBCoeffsDouble()[2] == 3.)
+			&& (small.getACoeffsDouble()[2] == 0.25);
+	ok = ok && (small.read(48000) == (long) strlen(text))
+			&& (small.getBCoeffsDouble()[2] == 6.) && (small.read(44100) == 0);
+	small.close();
+	cout << "sections -> " << (ok ? "passed" : "FAILED") << endl;
+
+	// malformed files are rejected
+	const char *bad[] = { "lowpass;x;info\n16000\n1;2;3\n1;0;0\n",	// order
+			"lowpass;2;info\n16k\n1;2;3\n1;0;0\n",						// fs
+			"lowpass;2;info\n16000\n1;2\n1;0;0\n",						// b too short
+			"lowpass;2;info\n16000\n1;2;3\n1;0;0;0\n",					// a too long
+			"lowpass;2;info\n16000\n1;2;x\n1;0;0\n",					// number
+			"lowpass;2;info\n16000\n1;2;3\n" };							// no a line
+	int rejected = 0, numBad = sizeof(bad) / sizeof(bad[0]);
+	for (int i = 0; i < numBad; i++) {
+		writeText(path, bad[i]);
+		if (parseFilterText(path, 16000) < 0)
+			rejected++;
+	}
+	remove(path.c_str());
+	cout << "malformed files: " << rejected << " of " << numBad
+			<< " rejected -> " << ((rejected == numBad) ? "passed" : "FAILED")
+			<< endl;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterLibrary(string &fltpath, string &fltfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	// index built from scratch
+	remove((fltpath + CFilterLibrary::INDEX_NAME).c_str());
+	CFilterLibrary library(fltpath);
+	auto start = chrono::steady_clock::now();
+	int parsed = library.refresh();
+	auto stop = chrono::steady_clock::now();
+	double msBuild = chrono::duration<double, milli>(stop - start).count();
+
+	// index loaded from the directory, nothing is parsed
+	CFilterLibrary loaded(fltpath);
+	start = chrono::steady_clock::now();
+	int reparsed = loaded.refresh();
+	stop = chrono::steady_clock::now();
+	double msRefresh = chrono::duration<double, milli>(stop - start).count();
+	cout << library.getNumFiles() << " files: " << msBuild << " ms indexed ("
+			<< parsed << " files parsed), " << msRefresh << " ms refreshed ("
+			<< reparsed << " files parsed) -> "
+			<< (((parsed == library.getNumFiles()) && (reparsed == 0)) ?
+					"passed" : "FAILED") << endl;
+
+	// the filters of a sampling frequency are those the files contain
+	int rates[] = { 11025, 16000, 44100, 48000, 96000 };
+	bool ok = true;
+	for (int r = 0; r < 5; r++) {
+		int fs = rates[r], num = loaded.getNumFilters(fs);
+		cout << fs << "Hz: " << num << " filters";
+		for (int i = 0; i < num; i++) {
+			const CFilterLibrary::FILTER *pFilter = loaded.getFilter(fs, i);
+			CFileFilter filterfile(fltpath + pFilter->file);
+			filterfile.open();
+			long pos = filterfile.read(fs);
+			ok = ok && (pos > pFilter->offset) && (pFilter->fs == fs)
+					&& (pFilter->order == filterfile.getOrder())
+					&& (pFilter->type == filterfile.getFilterType());
+			filterfile.close();
+			cout << ((i == 0) ? " (" : ", ") << pFilter->file;
+		}
+		cout << ((num > 0) ? ")" : "") << endl;
+		ok = ok && (loaded.getFilter(fs, num) == NULL);
+	}
+	cout << "filters by sampling frequency -> " << (ok ? "passed" : "FAILED")
+			<< endl;
+
+	// the derived filters of a sampling frequency are those readDerived()
+	// derives from the listed section (all files of the directory have a
+	// section for 16000 Hz), the files left out are not derivable
+	ok = true;
+	for (int r = 0; r < 5; r++) {
+		int fs = rates[r], num = loaded.getNumDerived(fs), listed = 0;
+		cout << fs << "Hz: " << num << " derived filters";
+		for (int i = 0; i < num; i++) {
+			const CFilterLibrary::FILTER *pFilter = loaded.getDerived(fs, i);
+			cout << ((i == 0) ? " (" : ", ") << pFilter->file << " from "
+					<< pFilter->fs << "Hz";
+		}
+		cout << ((num > 0) ? ")" : "") << endl;
+		ok = ok && (loaded.getDerived(fs, num) == NULL);
+		for (int k = 0; k < loaded.getNumFilters(16000); k++) {
+			const CFilterLibrary::FILTER *pFile = loaded.getFilter(16000, k);
+			const CFilterLibrary::FILTER *pFilter = NULL;
+			for (int i = 0; (i < num) && (pFilter == NULL); i++)
+				if (loaded.getDerived(fs, i)->file == pFile->file)
+					pFilter = loaded.getDerived(fs, i);
+			CFileFilter filterfile(fltpath + pFile->file);
+			filterfile.open();
+			if (filterfile.read(fs)) {
+				ok = ok && (pFilter == NULL);
+			} else if (pFilter != NULL) {
+				listed++;
+				ok = ok && filterfile.readDerived(fs) && filterfile.isDerived()
+						&& (filterfile.getSourceFs() == pFilter->fs);
+			} else
+				ok = ok && !filterfile.readDerived(fs);
+			filterfile.close();
+		}
+		ok = ok && (listed == num);
+	}
+	cout << "derived filters by sampling frequency -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	// a new file is indexed, a removed one dropped
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	int fs = 44100;
+	filterfile.read(fs);
+	filterfile.close();
+	int before = loaded.getNumFilters(fs);
+	string name = "librarytest.txt";
+	FILE *pf = fopen((fltpath + name).c_str(), "wb");
+	CMappedFile text;
+	text.map(fltfile);
+	fwrite(text.getData(), 1, text.getSize(), pf);
+	fclose(pf);
+	ok = (loaded.refresh() == 1) && (loaded.getNumFilters(fs) == before + 1);
+	CFileFilter copy(fltpath + name);
+	remove(copy.getCachePath().c_str());
+	remove((fltpath + name).c_str());
+	ok = ok && (loaded.refresh() == 0) && (loaded.getNumFilters(fs) == before);
+	cout << "changed directory -> " << (ok ? "passed" : "FAILED") << endl;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_FilterDerivation(string &fltfile, string &fltfileSparse) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	// re-warping reproduces a section designed for the other sampling
+	// frequency if the filter is a bilinear design (prewarped at the cutoff
+	// frequency), other designs are not derived
+	CFilterAnalyzer analyzer;
+	int fsFrom = 48000, fsTo = 44100;
+	CFileFilter filterfile(fltfile);
+	filterfile.open();
+	filterfile.read(fsFrom);
+	int order = filterfile.getOrder();
+	double *bFrom = new double[order + 1], *aFrom = new double[order + 1];
+	memcpy(bFrom, filterfile.getBCoeffsDouble(), (order + 1) * sizeof(double));
+	memcpy(aFrom, filterfile.getACoeffsDouble(), (order + 1) * sizeof(double));
+	double fc = analyzer.analyze(fltfile, fsFrom, aFrom, bFrom, order)->cutoff;
+	double *b = new double[order + 1], *a = new double[order + 1];
+	bool ok = CFilterDerivation::rewarp(bFrom, aFrom, order, fsFrom, fsTo, fc,
+			b, a);
+	filterfile.read(fsTo);
+	const CFilterAnalyzer::RESPONSE *pStored = analyzer.analyze(fltfile, fsTo,
+			filterfile.getACoeffsDouble(), filterfile.getBCoeffsDouble(), order);
+	double maxDev = 0.;
+	for (int k = 0; k < pStored->numBins; k++) {
+		complex<double> w = polar(1., -2. * M_PI * pStored->freq[k] / fsTo);
+		double mag = 20.
+				* log10(abs(CPolynomial::evalInv(b, order, w)
+						/ CPolynomial::evalInv(a, order, w)));
+		if (pStored->magnitude[k] > CFilterDerivation::DEVIATION_FLOOR_DB)
+			maxDev = fmax(maxDev, fabs(mag - pStored->magnitude[k]));
+	}
+	double dev = CFilterDerivation::rewarpDeviation(bFrom, aFrom, order,
+			fsFrom, filterfile.getBCoeffsDouble(),
+			filterfile.getACoeffsDouble(), fsTo, fc);
+	bool bilinear = (dev <= CFilterDerivation::MAX_REWARP_DEVIATION_DB);
+	// the check of the derivation agrees with the response of the analyzer
+	ok = ok && (fabs(dev - maxDev) < 0.05);
+	cout << fltfile << ": " << fsFrom << "Hz re-warped to " << fsTo
+			<< "Hz, max. deviation from the stored section " << maxDev
+			<< " dB (above " << CFilterDerivation::DEVIATION_FLOOR_DB
+			<< " dB): " << (bilinear ? "bilinear design" : "other design")
+			<< " -> " << (ok ? "passed" : "FAILED") << endl;
+	delete[] bFrom;
+	delete[] aFrom;
+	delete[] b;
+	delete[] a;
+
+	// sampling frequency missing in the file: derived (cutoff kept, cached)
+	// for bilinear designs only
+	int fs = 32000;
+	remove(filterfile.getCachePath().c_str());
+	if (!bilinear) {
+		ok = (filterfile.read(fs) == 0) && (filterfile.readDerived(fs) == 0)
+				&& !filterfile.isDerived() && (filterfile.readDerived(fs) == 0);
+		cout << fs << "Hz: not derivable -> " << (ok ? "passed" : "FAILED")
+				<< endl;
+	}
+	ok = bilinear && (filterfile.read(fs) == 0)
+			&& (filterfile.readDerived(fs) != 0) && filterfile.isDerived();
+	int fsSource = filterfile.getSourceFs();
+	double fcSource = 0., fcDerived = 0.;
+	if (ok) {
+		fcDerived = analyzer.analyze("derived", fs,
+				filterfile.getACoeffsDouble(), filterfile.getBCoeffsDouble(),
+				order)->cutoff;
+		CFileFilter source(fltfile);
+		source.open();
+		source.read(fsSource);
+		fcSource = analyzer.analyze(fltfile, fsSource,
+				source.getACoeffsDouble(), source.getBCoeffsDouble(), order)->cutoff;
+		source.close();
+		ok = (fabs(fcDerived - fcSource) < 1.) && !filterfile.isFromCache();
+	}
+	auto start = chrono::steady_clock::now();
+	ok = ok && filterfile.readDerived(fs) && filterfile.isFromCache()
+			&& (filterfile.getSourceFs() == fsSource)
+			&& (filterfile.read(fs) == 0);
+	auto stop = chrono::steady_clock::now();
+	if (bilinear)
+		cout << fs << "Hz derived from " << fsSource << "Hz: cutoff "
+				<< fcDerived << "Hz (source " << fcSource << "Hz), cached "
+				<< chrono::duration<double, micro>(stop - start).count()
+				<< " us -> " << (ok ? "passed" : "FAILED") << endl;
+	filterfile.close();
+
+	// delay lines: the delay times are kept
+	CFileFilter sparsefile(fltfileSparse);
+	sparsefile.open();
+	int fsSparse = 16000;
+	sparsefile.read(fsSparse);
+	int numTaps = sparsefile.getNumATaps();
+	uint32_t lastTap = sparsefile.getATapIndices()[numTaps - 1];
+	fs = 44100;
+	ok = sparsefile.readDerived(fs) && sparsefile.isSparse()
+			&& (sparsefile.getNumATaps() == numTaps)
+			&& (sparsefile.getATapIndices()[numTaps - 1]
+					== (uint32_t) lround((double) lastTap * fs / fsSparse));
+	cout << fltfileSparse << ": " << fs << "Hz, order "
+			<< sparsefile.getOrder() << ", last recursive tap "
+			<< (double) sparsefile.getATapIndices()[numTaps - 1] / fs * 1000.
+			<< " ms (" << (double) lastTap / fsSparse * 1000. << " ms) -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+	sparsefile.close();
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief reads a sound file by a prefetcher and compares the blocks with
+ * blocks read directly
+ *
+ * \param pFile opened sound file (rewound)
+ * \param x signal read directly (interleaved)
+ * \param numFrames number of frames of the signal
+ * \param framesPerBlock frames per block
+ * \param fillMs fill level of the prefetcher
+ * \param consumerUs processing time of the consumer per block (sleep)
+ * \param nsPerBlock time of front() and pop() per block
+ * \return true if all blocks are equal
+ */
+static bool prefetchTestRead(CFileSound *pFile, float *x, int numFrames,
+		uint16_t framesPerBlock, int fillMs, int consumerUs,
+		double &nsPerBlock) {
+	uint16_t channels = pFile->getNumChannels();
+	CFileSoundPrefetcher prefetcher(pFile, framesPerBlock, fillMs);
+	prefetcher.waitFilled();
+	bool equal = true;
+	int frame = 0, numBlocks = 0;
+	double ns = 0.;
+	while (1) {
+		auto start = chrono::steady_clock::now();
+		CAudioBlock *pBlock = prefetcher.front();
+		ns += chrono::duration<double, nano>(
+				chrono::steady_clock::now() - start).count();
+		if (pBlock == NULL) {
+			if (prefetcher.isFinished())
+				break;
+			sched_yield();
+			continue;
+		}
+		int frames = pBlock->getNumFrames();
+		for (uint16_t c = 0; c < channels; c++)
+			for (int n = 0; n < frames; n++)
+				equal = equal
+						&& (frame + n < numFrames)
+						&& (pBlock->getChannel(c)[n]
+								== x[(frame + n) * channels + c]);
+		frame += frames;
+		numBlocks++;
+		start = chrono::steady_clock::now();
+		prefetcher.pop();
+		ns += chrono::duration<double, nano>(
+				chrono::steady_clock::now() - start).count();
+		if (consumerUs)
+			usleep(consumerUs);
+	}
+	nsPerBlock = ns / (numBlocks ? numBlocks : 1);
+	cout << fillMs << " ms (" << prefetcher.getNumBlocks() << " blocks), "
+			<< "consumer " << consumerUs << " us/block: " << numBlocks
+			<< " blocks, " << prefetcher.getUnderruns() << " underruns, "
+			<< nsPerBlock << " ns/block -> "
+			<< ((equal && (frame == numFrames)) ? "passed" : "FAILED")
+			<< endl;
+	prefetcher.stop();
+	pFile->rewind();
+	return equal && (frame == numFrames);
+}
+
+void Test_SoundPrefetch(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	int numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.rewind();
+
+	// blocks of play(): 1/8 s
+	uint16_t framesPerBlock = fs / 8;
+	cout << soundfile << ": " << fs << "Hz, " << channels << " channels, "
+			<< numFrames << " frames, " << framesPerBlock << " frames/block"
+			<< endl;
+
+	// direct reads (reference for the time the playback loop waits)
+	CAudioBlock block(channels, framesPerBlock, fs);
+	int numBlocks = 0;
+	auto start = chrono::steady_clock::now();
+	while (sndF.read(block) == framesPerBlock)
+		numBlocks++;
+	double nsRead = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count() / (numBlocks + 1);
+	sndF.rewind();
+	cout << "direct read: " << nsRead << " ns/block" << endl;
+
+	// fast consumer (underruns), slow consumer (full ring), minimal ring
+	double nsPop, ns;
+	bool ok = prefetchTestRead(&sndF, x, numFrames, framesPerBlock,
+			CFileSoundPrefetcher::DEFAULT_FILL_MS, 200, nsPop);
+	ok = prefetchTestRead(&sndF, x, numFrames, framesPerBlock,
+			CFileSoundPrefetcher::DEFAULT_FILL_MS, 0, ns) && ok;
+	ok = prefetchTestRead(&sndF, x, numFrames, framesPerBlock, 0, 100, ns)
+			&& ok;
+	// ring size for the fill level (at least 2 blocks)
+	{
+		CFileSoundPrefetcher prefetcher(&sndF, framesPerBlock, 1000);
+		ok = ok && (prefetcher.getNumBlocks()
+				== (int) ((fs + framesPerBlock - 1) / framesPerBlock));
+		prefetcher.stop();
+		sndF.rewind();
+	}
+	// time of the playback loop with a filled ring (no underruns)
+	cout << "playback loop: " << nsPop << " ns/block instead of " << nsRead
+			<< " ns/block -> " << (ok ? "passed" : "FAILED") << endl;
+
+	// a prefetcher stopped before the end of the file
+	{
+		CFileSoundPrefetcher prefetcher(&sndF, framesPerBlock);
+		prefetcher.waitFilled();
+		ok = (prefetcher.front() != NULL);
+		prefetcher.pop();
+		prefetcher.stop();
+		sndF.rewind();
+		ok = ok && (sndF.read(block) == framesPerBlock)
+				&& (block.getChannel(0)[0] == x[0]);
+		sndF.rewind();
+	}
+	cout << "stopped early, file rewound -> " << (ok ? "passed" : "FAILED")
+			<< endl;
+
+	sndF.close();
+	delete[] x;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief writes a WAV file with a canonical header
+ *
+ * \param path path of the file
+ * \param tag format tag (1: PCM, 3: float, others are written as they are)
+ * \param bits bits per sample
+ * \param channels number of channels
+ * \param fs sampling frequency
+ * \param data samples (little endian, interleaved)
+ * \param size size of data in bytes
+ * \param extensible true: WAVE_FORMAT_EXTENSIBLE with the tag as sub format
+ */
+static void writeWav(const string &path, uint16_t tag, uint16_t bits,
+		uint16_t channels, uint32_t fs, const void *data, uint32_t size,
+		bool extensible = false) {
+	uint8_t fmt[40];
+	memset(fmt, 0, sizeof(fmt));
+	uint16_t blockAlign = channels * (bits / 8);
+	uint32_t bytesPerSec = fs * blockAlign;
+	uint16_t fmtTag = extensible ? 0xFFFE : tag;
+	uint16_t cbSize = 22;
+	memcpy(fmt, &fmtTag, 2);
+	memcpy(fmt + 2, &channels, 2);
+	memcpy(fmt + 4, &fs, 4);
+	memcpy(fmt + 8, &bytesPerSec, 4);
+	memcpy(fmt + 12, &blockAlign, 2);
+	memcpy(fmt + 14, &bits, 2);
+	memcpy(fmt + 16, &cbSize, 2);
+	memcpy(fmt + 18, &bits, 2);
+	memcpy(fmt + 24, &tag, 2);
+	uint32_t fmtSize = extensible ? 40 : 16;
+	uint32_t riffSize = 4 + 8 + fmtSize + 8 + size + (size & 1);
+
+	FILE *pf = fopen(path.c_str(), "wb");
+	fwrite("RIFF", 1, 4, pf);
+	fwrite(&riffSize, 4, 1, pf);
+	fwrite("WAVEfmt ", 1, 8, pf);
+	fwrite(&fmtSize, 4, 1, pf);
+	fwrite(fmt, 1, fmtSize, pf);
+	fwrite("data", 1, 4, pf);
+	fwrite(&size, 4, 1, pf);
+	fwrite(data, 1, size, pf);
+	if (size & 1)
+		fputc(0, pf);
+	fclose(pf);
+}
+
+/**
+ * \brief reads a whole sound file by libsndfile and from the mapping and
+ * compares the samples
+ * \return true if the file has been mapped and the samples are equal
+ */
+static bool compareMappedRead(const string &path) {
+	CFileSound sndfile(path);
+	sndfile.setMappingEnabled(false);
+	sndfile.open();
+	CFileSound mapped(path);
+	mapped.open();
+	uint64_t numFrames = sndfile.getNumFrames();
+	uint16_t channels = sndfile.getNumChannels();
+	bool equal = mapped.isMapped() && (mapped.getNumFrames() == numFrames)
+			&& (mapped.getNumChannels() == channels)
+			&& (mapped.getSampleRate() == sndfile.getSampleRate())
+			&& (mapped.getFormat() == sndfile.getFormat());
+	if (equal) {
+		float *x = new float[numFrames * channels + 1];
+		float *y = new float[numFrames * channels + 1];
+		equal = (sndfile.read(x, numFrames + 1) == numFrames)
+				&& (mapped.read(y, numFrames + 1) == numFrames)
+				&& !memcmp(x, y, numFrames * channels * sizeof(float));
+		// planar blocks (odd size: partial last block)
+		CAudioBlock block(channels, 7, sndfile.getSampleRate());
+		mapped.rewind();
+		uint64_t frame = 0, frames;
+		while ((frames = mapped.read(block)) > 0) {
+			for (uint16_t c = 0; c < channels; c++)
+				for (uint64_t n = 0; n < frames; n++)
+					equal = equal
+							&& (block.getChannel(c)[n]
+									== x[(frame + n) * channels + c]);
+			frame += frames;
+		}
+		equal = equal && (frame == numFrames);
+		delete[] x;
+		delete[] y;
+	}
+	sndfile.close();
+	mapped.close();
+	return equal;
+}
+
+void Test_SoundMapped(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	// conversion kernels: vectorized and scalar results are equal
+	const int numSamples = 65536 + 13;
+	int16_t *pcm16 = new int16_t[numSamples];
+	uint8_t *pcm24 = new uint8_t[3 * numSamples];
+	float *y = new float[numSamples];
+	float *yRef = new float[numSamples];
+	srand(1);
+	for (int i = 0; i < numSamples; i++) {
+		pcm16[i] = (int16_t) (i - 32768);	// all values
+		int32_t s24 = (rand() & 0xFFFFFF) - 0x800000;
+		if (i < 2)
+			s24 = i ? 0x7FFFFF : -0x800000;
+		memcpy(pcm24 + 3 * i, &s24, 3);
+	}
+	CPcmConvert::int16ToFloat(pcm16, yRef, numSamples, false);
+	memset(y, 0, numSamples * sizeof(float));	// no page faults in the timing
+	auto start = chrono::steady_clock::now();
+	CPcmConvert::int16ToFloat(pcm16, y, numSamples);
+	double ns16 = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count() / numSamples;
+	bool ok = !memcmp(y, yRef, numSamples * sizeof(float))
+			&& (yRef[0] == -1.f) && (yRef[32768] == 0.f);
+	CPcmConvert::int24ToFloat(pcm24, yRef, numSamples, false);
+	start = chrono::steady_clock::now();
+	CPcmConvert::int24ToFloat(pcm24, y, numSamples);
+	double ns24 = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count() / numSamples;
+	ok = ok && !memcmp(y, yRef, numSamples * sizeof(float))
+			&& (yRef[0] == -1.f) && (yRef[1] == 1.f - 1.f / 8388608.f);
+	cout << "conversion 16 bit: " << ns16 << " ns/sample, 24 bit: " << ns24
+			<< " ns/sample, vectorized = scalar -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	// sample formats written for the test, read by libsndfile and mapped
+	string wavpath = soundfile + ".mapped.wav";
+	struct {
+		const char *name;
+		uint16_t tag, bits, channels;
+		bool extensible;
+	} formats[] = { { "PCM 8 bit stereo", 1, 8, 2, false }, {
+			"PCM 16 bit mono", 1, 16, 1, false }, { "PCM 24 bit stereo", 1, 24,
+			2, false }, { "PCM 24 bit extensible", 1, 24, 3, true }, {
+			"PCM 32 bit stereo", 1, 32, 2, false }, { "float 32 bit stereo", 3,
+			32, 2, false } };
+	int frames = 1001;	// odd: padded data chunk for 8 bit
+	for (unsigned f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+		uint32_t size = frames * formats[f].channels * (formats[f].bits / 8);
+		uint8_t *data = new uint8_t[size];
+		if (formats[f].tag == 3) {
+			float *pf = (float*) data;
+			for (uint32_t i = 0; i < size / 4; i++)
+				pf[i] = sinf(0.01f * i);
+		} else
+			for (uint32_t i = 0; i < size; i++)
+				data[i] = (uint8_t) rand();
+		writeWav(wavpath, formats[f].tag, formats[f].bits, formats[f].channels,
+				44100, data, size, formats[f].extensible);
+		ok = compareMappedRead(wavpath);
+		if (formats[f].tag == 3) {
+			// float: the frames are viewed in the mapping
+			CFileSound mapped(wavpath);
+			mapped.open();
+			uint64_t num;
+			const float *pView = mapped.getView(frames, num);
+			ok = ok && pView && (num == (uint64_t) frames)
+					&& !memcmp(pView, data, size)
+					&& (mapped.getView(frames, num) != NULL) && (num == 0);
+			mapped.close();
+		}
+		cout << formats[f].name << ": " << (ok ? "passed" : "FAILED") << endl;
+		delete[] data;
+	}
+
+	// compressed formats are left to libsndfile
+	uint8_t adpcm[256];
+	memset(adpcm, 0, sizeof(adpcm));
+	writeWav(wavpath, 2, 4, 1, 8000, adpcm, sizeof(adpcm));
+	CFileSoundMapped rejected;
+	ok = !rejected.open(wavpath) && !rejected.isOpen();
+	cout << "ADPCM rejected: " << (ok ? "passed" : "FAILED") << endl;
+	remove(wavpath.c_str());
+
+	// the sound file
+	ok = compareMappedRead(soundfile);
+	CFileSound sndF(soundfile);
+	for (int m = 0; m < 2; m++) {
+		sndF.setMappingEnabled(m == 1);
+		sndF.open();
+		uint16_t channels = sndF.getNumChannels();
+		uint16_t framesPerBlock = sndF.getSampleRate() / 8;
+		CAudioBlock block(channels, framesPerBlock, sndF.getSampleRate());
+		uint64_t numFrames = 0;
+		start = chrono::steady_clock::now();
+		for (int r = 0; r < 10; r++) {
+			uint64_t n;
+			while ((n = sndF.read(block)) > 0)
+				numFrames += n;
+			sndF.rewind();
+		}
+		double ns = chrono::duration<double, nano>(
+				chrono::steady_clock::now() - start).count() / numFrames;
+		cout << soundfile << (sndF.isMapped() ? " (mapped): " : " (libsndfile): ")
+				<< ns << " ns/frame" << endl;
+		sndF.close();
+	}
+	cout << soundfile << ": mapped = libsndfile -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	delete[] pcm16;
+	delete[] pcm24;
+	delete[] y;
+	delete[] yRef;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief throughput of a conversion
+ * \param convert conversion of num samples
+ * \param num number of samples per call
+ * \param bytesPerSample bytes read and written per sample
+ * \return GB/s
+ */
+template<class FUNC>
+static double pcmThroughput(FUNC convert, size_t num, int bytesPerSample) {
+	const int reps = 20;
+	convert();	// warm up (page faults, caches)
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		convert();
+	double ns = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count();
+	return (double) reps * num * bytesPerSample / ns;
+}
+
+void Test_PcmConvert(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	const size_t num = 65536 * 16 + 13;		// all 16 bit values, odd tail
+	int16_t *pcm16 = new int16_t[num], *pcm16b = new int16_t[num];
+	uint8_t *pcm24 = new uint8_t[3 * num], *pcm24b = new uint8_t[3 * num];
+	int32_t *pcm32 = new int32_t[num], *pcm32b = new int32_t[num];
+	float *x = new float[num];
+	srand(2);
+	for (size_t i = 0; i < num; i++) {
+		pcm16[i] = (int16_t) i;
+		int32_t s24 = (rand() & 0xFFFFFF) - 0x800000;
+		if (i < 2)
+			s24 = i ? 0x7FFFFF : -0x800000;
+		memcpy(pcm24 + 3 * i, &s24, 3);
+		// multiples of 256: representable by float
+		pcm32[i] = (int32_t) ((uint32_t) rand() << 8);
+	}
+
+	// PCM -> float -> PCM without dither: the original samples
+	bool ok = true;
+	for (int v = 0; v < 2; v++) {
+		CPcmConvert::int16ToFloat(pcm16, x, num, v);
+		CPcmConvert::floatToInt16(x, pcm16b, num, NULL, v);
+		ok = ok && !memcmp(pcm16, pcm16b, num * sizeof(int16_t));
+		CPcmConvert::int24ToFloat(pcm24, x, num, v);
+		CPcmConvert::floatToInt24(x, pcm24b, num, NULL, v);
+		ok = ok && !memcmp(pcm24, pcm24b, 3 * num);
+		CPcmConvert::int32ToFloat(pcm32, x, num, v);
+		CPcmConvert::floatToInt32(x, pcm32b, num, 32, NULL, v);
+		ok = ok && !memcmp(pcm32, pcm32b, num * sizeof(int32_t));
+		// 24 bit in the upper bits (libsndfile int format)
+		for (size_t i = 0; i < num; i++)
+			pcm32[i] &= 0xFFFFFF00;
+		CPcmConvert::int32ToFloat(pcm32, x, num, v);
+		CPcmConvert::floatToInt32(x, pcm32b, num, 24, NULL, v);
+		ok = ok && !memcmp(pcm32, pcm32b, num * sizeof(int32_t));
+	}
+	cout << "round trip 16/24/32 bit, scalar and vectorized -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	// vectorized = scalar with dither, clipping and NaN
+	for (size_t i = 0; i < num; i++)
+		x[i] = 1.2f * sinf(0.001f * i);
+	x[0] = 1.f;
+	x[1] = -1.f;
+	x[2] = NAN;
+	x[3] = -INFINITY;
+	CPcmConvert::DITHER d1, d2;
+	CPcmConvert::initDither(d1, 7);
+	CPcmConvert::initDither(d2, 7);
+	CPcmConvert::floatToInt16(x, pcm16, num, &d1, false);
+	CPcmConvert::floatToInt16(x, pcm16b, num, &d2);
+	ok = !memcmp(pcm16, pcm16b, num * sizeof(int16_t))
+			&& !memcmp(&d1, &d2, sizeof(d1));
+	ok = ok && (pcm16[2] == -32768) && (pcm16[3] == -32768);
+	CPcmConvert::floatToInt24(x, pcm24, num, &d1, false);
+	CPcmConvert::floatToInt24(x, pcm24b, num, &d2);
+	ok = ok && !memcmp(pcm24, pcm24b, 3 * num);
+	CPcmConvert::floatToInt32(x, pcm32, num, 24, &d1, false);
+	CPcmConvert::floatToInt32(x, pcm32b, num, 24, &d2);
+	ok = ok && !memcmp(pcm32, pcm32b, num * sizeof(int32_t));
+	CPcmConvert::floatToInt16(x, pcm16, 4, NULL);
+	ok = ok && (pcm16[0] == 32767) && (pcm16[1] == -32768)
+			&& (pcm16[2] == -32768) && (pcm16[3] == -32768);
+	CPcmConvert::floatToInt32(x, pcm32, 4, 32, NULL);
+	ok = ok && (pcm32[0] == 2147483520) && (pcm32[1] == INT32_MIN);
+	cout << "dithered, clipped: vectorized = scalar -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	// dither: a constant of 0.3 LSB is kept on average (0 without dither),
+	// the error stays below 1.5 LSB
+	for (size_t i = 0; i < num; i++)
+		x[i] = 0.3f / 32768.f;
+	CPcmConvert::floatToInt16(x, pcm16, num, &d1);
+	double mean = 0., maxErr = 0.;
+	for (size_t i = 0; i < num; i++) {
+		mean += pcm16[i];
+		maxErr = fmax(maxErr, fabs(pcm16[i] - 0.3));
+	}
+	mean /= num;
+	CPcmConvert::floatToInt16(x, pcm16b, num, NULL);
+	ok = (fabs(mean - 0.3) < 0.01) && (maxErr < 1.5);
+	for (size_t i = 0; i < num; i++)
+		ok = ok && (pcm16b[i] == 0);
+	cout << "TPDF dither of 0.3 LSB: mean " << mean << " LSB, max. error "
+			<< maxErr << " LSB -> " << (ok ? "passed" : "FAILED") << endl;
+
+	// throughput (bytes read and written)
+	for (int v = 0; v < 2; v++) {
+		cout << (v ? "vectorized: " : "scalar:     ");
+		cout << "int16->float "
+				<< pcmThroughput(
+						[&] {CPcmConvert::int16ToFloat(pcm16, x, num, v);},
+						num, 6) << " GB/s";
+		cout << ", int24->float "
+				<< pcmThroughput(
+						[&] {CPcmConvert::int24ToFloat(pcm24, x, num, v);},
+						num, 7) << " GB/s";
+		cout << ", int32->float "
+				<< pcmThroughput(
+						[&] {CPcmConvert::int32ToFloat(pcm32, x, num, v);},
+						num, 8) << " GB/s" << endl << "            ";
+		cout << "float->int16 (dither) "
+				<< pcmThroughput(
+						[&] {CPcmConvert::floatToInt16(x, pcm16, num, &d1, v);},
+						num, 6) << " GB/s";
+		cout << ", float->int24 (dither) "
+				<< pcmThroughput(
+						[&] {CPcmConvert::floatToInt24(x, pcm24, num, &d1, v);},
+						num, 7) << " GB/s";
+		cout << ", float->int32 "
+				<< pcmThroughput(
+						[&] {CPcmConvert::floatToInt32(x, pcm32, num, 32, NULL, v);},
+						num, 8) << " GB/s" << endl;
+	}
+
+	// sound file written as 16 and 24 bit PCM and read again: the same
+	// samples (16 bit source, no dither)
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint16_t channels = sndF.getNumChannels();
+	uint64_t numFrames = sndF.getNumFrames();
+	float *y = new float[numFrames * channels];
+	float *yBack = new float[numFrames * channels];
+	numFrames = sndF.read(y, numFrames);
+	string wavpath = soundfile + ".pcm.wav";
+	int subtypes[] = { SF_FORMAT_PCM_16, SF_FORMAT_PCM_24 };
+	for (int t = 0; t < 2; t++) {
+		CFileSound outF(wavpath, "w");
+		outF.setFormat(SF_FORMAT_WAV | subtypes[t]);
+		outF.setNumChannels(channels);
+		outF.setSampleRate(sndF.getSampleRate());
+		outF.open();
+		outF.write(y, numFrames);
+		outF.close();
+		ok = true;
+		for (int m = 0; m < 2; m++) {
+			CFileSound inF(wavpath);
+			inF.setMappingEnabled(m == 1);
+			inF.open();
+			memset(yBack, 0, numFrames * channels * sizeof(float));
+			ok = ok && (inF.read(yBack, numFrames) == numFrames)
+					&& !memcmp(y, yBack, numFrames * channels * sizeof(float));
+			inF.close();
+		}
+		cout << soundfile << " written as " << (t ? 24 : 16)
+				<< " bit and read (libsndfile, mapped) -> "
+				<< (ok ? "passed" : "FAILED") << endl;
+	}
+	remove(wavpath.c_str());
+	sndF.close();
+
+	delete[] pcm16;
+	delete[] pcm16b;
+	delete[] pcm24;
+	delete[] pcm24b;
+	delete[] pcm32;
+	delete[] pcm32b;
+	delete[] x;
+	delete[] y;
+	delete[] yBack;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+void Test_SeekRandomAccess(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint32_t fs = sndF.getSampleRate();
+	uint16_t channels = sndF.getNumChannels();
+	uint64_t numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+
+	// positions forward, backward, at the start and beyond the end
+	const int frames = 1000;
+	float *y = new float[frames * channels];
+	uint64_t pos[] = { numFrames / 2, numFrames / 3, 0, numFrames - frames / 2,
+			7, numFrames / 2 + 1, numFrames + 100 };
+	int numPos = sizeof(pos) / sizeof(pos[0]);
+	for (int m = 0; m < 2; m++) {
+		sndF.setMappingEnabled(m == 1);
+		sndF.open();
+		bool ok = true;
+		for (int p = 0; p < numPos; p++) {
+			uint64_t frame = pos[p] < numFrames ? pos[p] : numFrames;
+			uint64_t expected =
+					frame + frames <= numFrames ? frames : numFrames - frame;
+			uint64_t n = sndF.readAt(pos[p], y, frames);
+			ok = ok && (n == expected)
+					&& !memcmp(y, x + frame * channels,
+							n * channels * sizeof(float))
+					&& (sndF.tell() == frame + n);
+		}
+		// planar blocks continue at the position
+		CAudioBlock block(channels, 100, fs);
+		sndF.seek(numFrames / 4);
+		ok = ok && (sndF.read(block) == 100);
+		for (uint16_t c = 0; c < channels; c++)
+			for (int n = 0; n < 100; n++)
+				ok = ok
+						&& (block.getChannel(c)[n]
+								== x[(numFrames / 4 + n) * channels + c]);
+
+		// random access time
+		const int reps = 1000;
+		srand(1);
+		auto start = chrono::steady_clock::now();
+		for (int r = 0; r < reps; r++)
+			sndF.readAt((uint64_t) rand() % numFrames, y, frames);
+		double us = chrono::duration<double, micro>(
+				chrono::steady_clock::now() - start).count() / reps;
+		cout << soundfile << (sndF.isMapped() ? " (mapped)" : " (libsndfile)")
+				<< ": seek and read of " << frames << " frames: " << us
+				<< " us -> " << (ok ? "passed" : "FAILED") << endl;
+		sndF.close();
+	}
+
+	// the prefetcher delivers the blocks at the new position
+	sndF.setMappingEnabled(true);
+	sndF.open();
+	uint16_t framesPerBlock = fs / 8;
+	bool ok = true;
+	{
+		CFileSoundPrefetcher prefetcher(&sndF, framesPerBlock);
+		prefetcher.waitFilled();
+		for (int p = 0; p < numPos; p++) {
+			auto start = chrono::steady_clock::now();
+			prefetcher.seek(pos[p]);
+			prefetcher.waitFilled(1);
+			double us = chrono::duration<double, micro>(
+					chrono::steady_clock::now() - start).count();
+			uint64_t frame = pos[p] < numFrames ? pos[p] : numFrames;
+			CAudioBlock *pBlock = prefetcher.front();
+			if (frame == numFrames) {
+				ok = ok && (pBlock == NULL) && prefetcher.isFinished();
+				continue;
+			}
+			ok = ok && pBlock;
+			if (!pBlock)
+				break;
+			uint64_t expected = frame + framesPerBlock <= numFrames ?
+					framesPerBlock : numFrames - frame;
+			ok = ok && (pBlock->getNumFrames() == expected);
+			for (uint16_t c = 0; c < channels; c++)
+				for (uint64_t n = 0; n < expected; n++)
+					ok = ok
+							&& (pBlock->getChannel(c)[n]
+									== x[(frame + n) * channels + c]);
+			prefetcher.pop();
+			if (p == 0)
+				cout << "prefetcher: first block after a seek in " << us
+						<< " us" << endl;
+		}
+		prefetcher.stop();
+	}
+	sndF.close();
+	cout << "prefetcher: blocks at the seek positions -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+
+	delete[] x;
+	delete[] y;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}
+
+/**
+ * \brief opens a sound file, reads its first block and closes it (like
+ * choosing and starting a sound)
+ * \param cached true: by the shared cache
+ * \return time in microseconds
+ */
+static double cacheTestOpen(const string &path, bool cached) {
+	auto start = chrono::steady_clock::now();
+	CFileSound sndF(path);
+	sndF.setCacheEnabled(cached);
+	sndF.open();
+	CAudioBlock block(sndF.getNumChannels(), sndF.getSampleRate() / 8,
+			sndF.getSampleRate());
+	sndF.read(block);
+	sndF.close();
+	return chrono::duration<double, micro>(
+			chrono::steady_clock::now() - start).count();
+}
+
+void Test_SoundCache(string &soundfile) {
+	cout << endl << hDivider << endl << __FUNCTION__ << " started." << endl
+			<< endl;
+
+	CSoundCache *pCache = CSoundCache::getShared();
+	pCache->clear();
+	pCache->setBudget(CSoundCache::DEFAULT_BUDGET);
+	uint64_t hits = pCache->getHits(), misses = pCache->getMisses();
+
+	// the cached samples are the samples of the file
+	CFileSound sndF(soundfile);
+	sndF.open();
+	uint16_t channels = sndF.getNumChannels();
+	uint64_t numFrames = sndF.getNumFrames();
+	float *x = new float[numFrames * channels];
+	numFrames = sndF.read(x, numFrames);
+	sndF.close();
+	float *y = new float[numFrames * channels + 1];
+	CFileSound cached1(soundfile), cached2(soundfile);
+	cached1.setCacheEnabled(true);
+	cached2.setCacheEnabled(true);
+	cached1.open();
+	cached2.open();
+	uint64_t n;
+	const float *pView1 = cached1.getView(numFrames, n);
+	const float *pView2 = cached2.getView(1, n);
+	bool ok = cached1.isCached() && cached2.isCached() && (pView1 == pView2)
+			&& (pCache->getNumSounds() == 1)
+			&& (pCache->getHits() == hits + 1)
+			&& (pCache->getMisses() == misses + 1)
+			&& (pCache->getSize() == numFrames * channels * sizeof(float))
+			&& (cached1.getNumFrames() == numFrames);
+	cached2.rewind();
+	ok = ok && (cached2.read(y, numFrames + 1) == numFrames)
+			&& !memcmp(x, y, numFrames * channels * sizeof(float))
+			&& (cached2.readAt(numFrames / 2, y, 100) == 100)
+			&& !memcmp(x + numFrames / 2 * channels, y,
+					100 * channels * sizeof(float))
+			&& (cached2.tell() == numFrames / 2 + 100);
+	CAudioBlock block(channels, 1000, cached1.getSampleRate());
+	cached1.seek(numFrames - 10);
+	ok = ok && (cached1.read(block) == 10) && (cached1.read(block) == 0);
+	for (uint16_t c = 0; c < channels; c++)
+		for (int i = 0; i < 10; i++)
+			ok = ok
+					&& (block.getChannel(c)[i]
+							== x[(numFrames - 10 + i) * channels + c]);
+	cout << "cached = file, shared by 2 files -> " << (ok ? "passed" : "FAILED")
+			<< endl;
+
+	// dropped from the cache while in use: valid until closed
+	pCache->clear();
+	cached1.rewind();
+	ok = (pCache->getNumSounds() == 0) && (pCache->getSize() == 0)
+			&& (cached1.read(y, numFrames) == numFrames)
+			&& !memcmp(x, y, numFrames * channels * sizeof(float));
+	cached1.close();
+	cached2.close();
+	cout << "dropped while in use -> " << (ok ? "passed" : "FAILED") << endl;
+
+	// least recently used sounds are dropped, changed files decoded again
+	string paths[3];
+	size_t bytes = 2000 * sizeof(float);	// per sound
+	for (int i = 0; i < 3; i++) {
+		paths[i] = soundfile + ".cache" + to_string(i) + ".wav";
+		int16_t pcm[2000];
+		for (int k = 0; k < 2000; k++)
+			pcm[k] = (int16_t) (1000 * i + k);
+		writeWav(paths[i], 1, 16, 1, 8000, pcm, sizeof(pcm));
+	}
+	pCache->setBudget(2 * bytes);
+	hits = pCache->getHits();
+	misses = pCache->getMisses();
+	cacheTestOpen(paths[0], true);
+	cacheTestOpen(paths[1], true);
+	cacheTestOpen(paths[0], true);		// 1 is the least recently used
+	cacheTestOpen(paths[2], true);		// drops 1
+	cacheTestOpen(paths[0], true);
+	cacheTestOpen(paths[2], true);
+	ok = (pCache->getNumSounds() == 2) && (pCache->getSize() == 2 * bytes)
+			&& (pCache->getHits() == hits + 3)
+			&& (pCache->getMisses() == misses + 3);
+	cacheTestOpen(paths[1], true);		// decoded again, drops 0
+	cacheTestOpen(paths[2], true);
+	ok = ok && (pCache->getHits() == hits + 4)
+			&& (pCache->getMisses() == misses + 4);
+	int16_t pcm[3000];
+	for (int k = 0; k < 3000; k++)
+		pcm[k] = (int16_t) -k;
+	writeWav(paths[2], 1, 16, 1, 8000, pcm, sizeof(pcm));	// changed
+	CFileSound changed(paths[2]);
+	changed.setCacheEnabled(true);
+	changed.open();
+	ok = ok && changed.isCached() && (changed.getNumFrames() == 3000)
+			&& (changed.read(y, 1) == 1) && (y[0] == 0.f)
+			&& (changed.read(y, 1) == 1) && (y[0] == -1.f / 32768.f)
+			&& (pCache->getMisses() == misses + 5)
+			&& (pCache->getNumSounds() == 1);	// 1 dropped for the larger sound
+	changed.close();
+	// larger than the budget: read from the file
+	pCache->setBudget(bytes);
+	changed.open();
+	ok = ok && !changed.isCached() && (pCache->getNumSounds() == 0)
+			&& (changed.read(y, 1) == 1) && (y[0] == 0.f);
+	changed.close();
+	cout << "LRU eviction, changed file, budget exceeded -> "
+			<< (ok ? "passed" : "FAILED") << endl;
+	for (int i = 0; i < 3; i++)
+		remove(paths[i].c_str());
+
+	// choosing a sound again: decode vs. memory
+	pCache->setBudget(CSoundCache::DEFAULT_BUDGET);
+	pCache->clear();
+	for (int m = 0; m < 2; m++) {
+		sndF.setMappingEnabled(m == 1);
+		double usFile = 0.;
+		for (int r = 0; r < 10; r++) {
+			auto start = chrono::steady_clock::now();
+			sndF.open();
+			CAudioBlock first(channels, sndF.getSampleRate() / 8,
+					sndF.getSampleRate());
+			sndF.read(first);
+			sndF.close();
+			usFile += chrono::duration<double, micro>(
+					chrono::steady_clock::now() - start).count();
+		}
+		cout << soundfile << (m ? " (mapped)" : " (libsndfile)")
+				<< ": open and first block: " << usFile / 10 << " us" << endl;
+	}
+	double usDecode = cacheTestOpen(soundfile, true);
+	double usCached = 0.;
+	for (int r = 0; r < 10; r++)
+		usCached += cacheTestOpen(soundfile, true);
+	cout << soundfile << " (cache): first open (decode) " << usDecode
+			<< " us, again: " << usCached / 10 << " us" << endl;
+	pCache->clear();
+
+	delete[] x;
+	delete[] y;
+
+	cout << endl << __FUNCTION__ << " finished." << endl << hDivider << endl;
+}